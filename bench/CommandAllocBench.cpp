@@ -0,0 +1,103 @@
+// Heap allocations per command on the steady-state command path: base64 payload decode into
+// the envelope, typed payload decode, CommandRouter::submit, process_one and handler dispatch. Global operator new is
+// replaced with a counting version; the process exits non-zero if any allocation is observed
+// after warm-up, so it doubles as a regression check.
+//
+// Scope: immediate commands through the router with a handler like UgvCore's (short result
+// message, Debug-level trail). Not covered, and still allocating: starting a long-running task
+// (CommandExecutor::start), compiling a mission, and any log line the logger emits.
+//
+// Usage: ugv_bench_command_alloc [commands=100000]
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string_view>
+
+#include "command/CommandRouter.hpp"
+#include "utils/Base64.hpp"
+
+namespace {
+std::atomic<uint64_t> g_allocs{0};
+}
+
+void* operator new(std::size_t n) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+using namespace arcraven::ugv;
+
+// Representative wire payloads (already base64 as they arrive in commands.in).
+struct Sample {
+    UgvCommand command;
+    std::string_view payload_b64;
+};
+
+constexpr Sample kSamples[] = {
+    {UgvCommand::Stop, ""},
+    {UgvCommand::SetSpeedLimit, "MS41"},                         // "1.5"
+    {UgvCommand::Signal, "Zmxhc2hsaWdodHwyfDE="},                // "flashlight|2|1"
+    {UgvCommand::FollowPath,                                     // 20 waypoints, > inline capacity
+     "MC4wfDAuMDsxLjB8MC41OzIuMHwxLjA7My4wfDEuNTs0LjB8Mi4wOzUuMHwyLjU7Ni4wfDMuMDs3LjB8My41Ozgu"
+     "MHw0LjA7OS4wfDQuNTsxMC4wfDUuMDsxMS4wfDUuNTsxMi4wfDYuMDsxMy4wfDYuNTsxNC4wfDcuMDsxNS4wfDcu"
+     "NTsxNi4wfDguMDsxNy4wfDguNTsxOC4wfDkuMDsxOS4wfDkuNQ=="},
+};
+constexpr size_t kSampleCount = sizeof(kSamples) / sizeof(kSamples[0]);
+
+bool decode(const Sample& s, CommandEnvelope& env) {
+    const size_t max_len = arcraven::utils::base64_decoded_size(s.payload_b64);
+    char* out = env.payload_json.prepare(max_len);
+    if (!out) return false;
+    size_t n = 0;
+    if (!arcraven::utils::base64_decode_into(s.payload_b64, out, max_len, n)) return false;
+    env.payload_json.resize(n);
+    const char* error = "";
+    return decode_typed_payload(s.command, env.payload_json.view(), env.typed, error);
+}
+
+uint64_t run(CommandRouter& router, uint64_t first_id, size_t commands) {
+    uint64_t handled = 0;
+    for (size_t i = 0; i < commands; ++i) {
+        const Sample& s = kSamples[i % kSampleCount];
+        CommandEnvelope env{};
+        env.command = s.command;
+        env.command_id = first_id + i;
+        if (!decode(s, env)) std::abort();
+        (void)router.submit(std::move(env));
+        router.process_some(0, 8, [&](const std::pair<CommandEnvelope, CommandResult>&) { ++handled; });
+    }
+    return handled;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t commands = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 100000;
+
+    CommandRouter router(CommandRouterConfig{.max_queue = 256});
+    const auto ok = [](const CommandEnvelope& c) -> CommandResult {
+        // Short diagnostic strings stay within std::string's small-buffer optimisation.
+        return {CommandStatus::Succeeded, RejectReason::None, c.payload_json.empty() ? "" : "ok"};
+    };
+    for (const auto& s : kSamples) router.register_handler(s.command, ok);
+
+    (void)run(router, 1, 1024); // warm-up: slab, scheduler outcome buffer, static tables
+
+    const uint64_t before = g_allocs.load();
+    const uint64_t handled = run(router, 1 << 20, commands);
+    const uint64_t allocs = g_allocs.load() - before;
+
+    std::printf("commands=%zu handled=%llu heap_allocations=%llu (%.4f per command)\n", commands,
+                static_cast<unsigned long long>(handled), static_cast<unsigned long long>(allocs),
+                static_cast<double>(allocs) / static_cast<double>(commands));
+    return allocs == 0 ? 0 : 1;
+}
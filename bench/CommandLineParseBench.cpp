@@ -0,0 +1,140 @@
+// commands.in parse throughput.
+//
+// Writes a temporary commands.in with a realistic mix of commands (GoTo, SetSpeedLimit, a short
+// FollowPath and Stop) and reads it back line by line the way Iceoryx2Bridge::pump_rx
+// does, once with the previous stringstream + vector<string> + stoull parser and once with
+// parse_command_line. Reports lines/s for each; exits non-zero if the two disagree on any line.
+//
+// Usage: ugv_bench_command_parse [lines=1000000]
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "command/CommandRegistry.hpp"
+#include "subsystems/CommandLineParser.hpp"
+#include "utils/Base64.hpp"
+
+namespace {
+
+using namespace arcraven::ugv;
+using Clock = std::chrono::steady_clock;
+
+// Reference: the previous pump_rx parser (split into strings, stoul per field, exceptions).
+bool legacy_parse(const std::string& line_in, CommandEnvelope& env) {
+    std::string line = line_in;
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    if (line.rfind("C|", 0) != 0) return false;
+    std::vector<std::string> parts;
+    std::stringstream ss(line);
+    std::string segment;
+    while (std::getline(ss, segment, '|')) {
+        parts.push_back(segment);
+    }
+    if (parts.size() < 9) return false;
+    try {
+        env.command_id = std::stoull(parts[1]);
+        env.command = static_cast<UgvCommand>(std::stoul(parts[2]));
+        env.domain = static_cast<CommandDomain>(std::stoul(parts[3]));
+        env.priority = static_cast<CommandPriority>(std::stoul(parts[4]));
+        env.authority = static_cast<CommandAuthority>(std::stoul(parts[5]));
+        env.issued_ns = std::stoull(parts[6]);
+        env.ttl_ns = std::stoull(parts[7]);
+    } catch (const std::exception&) {
+        return false;
+    }
+    if (!command_info(env.command)) return false;
+    const size_t max_len = arcraven::utils::base64_decoded_size(parts[8]);
+    char* payload = env.payload_json.prepare(max_len);
+    size_t payload_len = 0;
+    if (!payload || !arcraven::utils::base64_decode_into(parts[8], payload, max_len, payload_len)) return false;
+    env.payload_json.resize(payload_len);
+    return true;
+}
+
+bool fast_parse(const std::string& line, CommandEnvelope& env) {
+    return parse_command_line(line, env).status == CommandLineStatus::Ok;
+}
+
+void write_input(const std::filesystem::path& path, uint64_t lines) {
+    const std::string go_to = arcraven::utils::base64_encode("12.5|-3.25|1.5708");
+    const std::string speed = arcraven::utils::base64_encode("1.25");
+    const std::string path_wps = arcraven::utils::base64_encode("0|0;4.5|0;4.5|6;0|6;0|0");
+    const std::string stop = arcraven::utils::base64_encode("operator");
+    std::ofstream out(path, std::ios::trunc);
+    for (uint64_t id = 1; id <= lines; ++id) {
+        const uint64_t issued = 1'700'000'000'000'000'000ull + id * 1000;
+        switch (id % 4) {
+        case 0:
+            out << "C|" << id << "|" << static_cast<unsigned>(UgvCommand::GoTo) << "|0|1|3|" << issued
+                << "|0|" << go_to << "\n";
+            break;
+        case 1:
+            out << "C|" << id << "|" << static_cast<unsigned>(UgvCommand::SetSpeedLimit) << "|1|2|2|" << issued
+                << "|200000000|" << speed << "\n";
+            break;
+        case 2:
+            out << "C|" << id << "|" << static_cast<unsigned>(UgvCommand::FollowPath) << "|0|1|3|" << issued
+                << "|0|" << path_wps << "\n";
+            break;
+        default:
+            out << "C|" << id << "|" << static_cast<unsigned>(UgvCommand::Stop) << "|0|3|4|" << issued
+                << "|0|" << stop << "\n";
+            break;
+        }
+    }
+}
+
+struct RunResult {
+    uint64_t lines = 0;
+    uint64_t ok = 0;
+    uint64_t checksum = 0;
+    double seconds = 0.0;
+};
+
+template <typename Parse>
+RunResult run(const std::filesystem::path& path, Parse parse) {
+    RunResult r;
+    std::ifstream in(path);
+    std::string line;
+    const auto t0 = Clock::now();
+    while (std::getline(in, line)) {
+        ++r.lines;
+        CommandEnvelope env{};
+        if (!parse(line, env)) continue;
+        ++r.ok;
+        r.checksum += env.command_id ^ env.issued_ns ^ env.payload_json.size();
+    }
+    r.seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+    return r;
+}
+
+void report(const char* name, const RunResult& r) {
+    std::printf("%-22s lines=%llu ok=%llu %.2fs %.0f lines/s\n", name, static_cast<unsigned long long>(r.lines),
+                static_cast<unsigned long long>(r.ok), r.seconds, static_cast<double>(r.lines) / r.seconds);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const uint64_t lines = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+
+    const auto path = std::filesystem::temp_directory_path() / "ugv_bench_commands.in";
+    write_input(path, lines);
+
+    const RunResult legacy = run(path, legacy_parse);
+    const RunResult fast = run(path, fast_parse);
+    std::filesystem::remove(path);
+
+    report("stringstream+stoull", legacy);
+    report("parse_command_line", fast);
+    std::printf("speedup=%.2fx\n", legacy.seconds / fast.seconds);
+    return legacy.ok == fast.ok && legacy.checksum == fast.checksum ? 0 : 1;
+}
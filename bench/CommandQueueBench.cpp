@@ -0,0 +1,175 @@
+// Control-thread dequeue latency under a multi-producer submit flood.
+//
+// Producers share a 10 kHz aggregate submit rate (configurable) while a 200 Hz "control" thread
+// drains with process_some(). We time every process_one() the control thread performs and report
+// percentiles, once for the lock-free CommandRouter and once for a mutex+deque reference that
+// mirrors the previous implementation.
+//
+// Usage: ugv_bench_command_queue [seconds=3] [producers=4] [submit_hz=10000]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "command/CommandRouter.hpp"
+
+namespace {
+
+using namespace arcraven::ugv;
+using Clock = std::chrono::steady_clock;
+
+// Reference: the pre-ring implementation (one mutex shared by submit and process_one).
+class LockedQueue {
+public:
+    explicit LockedQueue(size_t max_queue) : max_queue_(max_queue) {}
+
+    bool submit(CommandEnvelope cmd) {
+        std::lock_guard<std::mutex> lk(mu_);
+        if (q_.size() >= max_queue_) return false;
+        q_.push_back(std::move(cmd));
+        return true;
+    }
+
+    std::optional<CommandEnvelope> pop() {
+        std::lock_guard<std::mutex> lk(mu_);
+        if (q_.empty()) return std::nullopt;
+        CommandEnvelope cmd = std::move(q_.front());
+        q_.pop_front();
+        return cmd;
+    }
+
+private:
+    size_t max_queue_;
+    std::mutex mu_;
+    std::deque<CommandEnvelope> q_;
+};
+
+struct Stats {
+    std::vector<uint64_t> pop_ns;
+    std::vector<uint64_t> tick_ns;
+    uint64_t accepted = 0;
+    uint64_t rejected = 0;
+};
+
+uint64_t pct(std::vector<uint64_t>& v, double p) {
+    if (v.empty()) return 0;
+    const size_t idx = std::min(v.size() - 1, static_cast<size_t>(p * static_cast<double>(v.size())));
+    std::nth_element(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(idx), v.end());
+    return v[idx];
+}
+
+void report(const char* name, Stats& s) {
+    std::printf("%-12s pops=%zu accepted=%llu rejected=%llu\n", name, s.pop_ns.size(),
+                static_cast<unsigned long long>(s.accepted), static_cast<unsigned long long>(s.rejected));
+    std::printf("%-12s pop  ns: p50=%llu p99=%llu p99.9=%llu max=%llu\n", "",
+                static_cast<unsigned long long>(pct(s.pop_ns, 0.50)),
+                static_cast<unsigned long long>(pct(s.pop_ns, 0.99)),
+                static_cast<unsigned long long>(pct(s.pop_ns, 0.999)),
+                static_cast<unsigned long long>(pct(s.pop_ns, 1.0)));
+    std::printf("%-12s tick ns: p50=%llu p99=%llu max=%llu\n", "",
+                static_cast<unsigned long long>(pct(s.tick_ns, 0.50)),
+                static_cast<unsigned long long>(pct(s.tick_ns, 0.99)),
+                static_cast<unsigned long long>(pct(s.tick_ns, 1.0)));
+}
+
+uint64_t elapsed_ns(Clock::time_point a, Clock::time_point b) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(b - a).count());
+}
+
+// SubmitFn: bool(CommandEnvelope), PopFn: bool() -> true if something was dequeued.
+template <typename SubmitFn, typename PopFn>
+Stats run(double seconds, int producers, double submit_hz, SubmitFn submit, PopFn pop) {
+    Stats stats;
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> accepted{0};
+    std::atomic<uint64_t> rejected{0};
+    std::atomic<uint64_t> next_id{1};
+
+    const auto per_producer = std::chrono::nanoseconds(
+        static_cast<int64_t>(1e9 * static_cast<double>(producers) / submit_hz));
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&] {
+            auto next = Clock::now();
+            while (!stop.load(std::memory_order_relaxed)) {
+                CommandEnvelope env{};
+                env.command = UgvCommand::SetSpeedLimit;
+                env.command_id = next_id.fetch_add(1, std::memory_order_relaxed);
+                (void)env.payload_json.assign("1.5");
+                if (submit(std::move(env))) {
+                    accepted.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    rejected.fetch_add(1, std::memory_order_relaxed);
+                }
+                next += per_producer;
+                std::this_thread::sleep_until(next);
+            }
+        });
+    }
+
+    const auto control_period = std::chrono::microseconds(5000);
+    const auto end = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    auto next = Clock::now();
+    while (Clock::now() < end) {
+        const auto tick_start = Clock::now();
+        for (int i = 0; i < 64; ++i) {
+            const auto t0 = Clock::now();
+            const bool got = pop();
+            const auto t1 = Clock::now();
+            stats.pop_ns.push_back(elapsed_ns(t0, t1));
+            if (!got) break;
+        }
+        stats.tick_ns.push_back(elapsed_ns(tick_start, Clock::now()));
+        next += control_period;
+        std::this_thread::sleep_until(next);
+    }
+
+    stop.store(true, std::memory_order_relaxed);
+    for (auto& t : threads) t.join();
+    stats.accepted = accepted.load();
+    stats.rejected = rejected.load();
+    return stats;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const double seconds = argc > 1 ? std::atof(argv[1]) : 3.0;
+    const int producers = argc > 2 ? std::atoi(argv[2]) : 4;
+    const double submit_hz = argc > 3 ? std::atof(argv[3]) : 10000.0;
+
+    std::printf("seconds=%.1f producers=%d submit_hz=%.0f control=200Hz drain<=64/tick\n",
+                seconds, producers, submit_hz);
+
+    {
+        CommandRouter router(CommandRouterConfig{.max_queue = 256});
+        router.register_handler(UgvCommand::SetSpeedLimit, [](const CommandEnvelope&) -> CommandResult {
+            return {CommandStatus::Succeeded, RejectReason::None, ""};
+        });
+        Stats s = run(seconds, producers, submit_hz,
+            [&](CommandEnvelope env) {
+                return router.submit(std::move(env)).outcome == SubmitOutcome::Queued;
+            },
+            [&] { return router.process_one(0).has_value(); });
+        report("mpsc-ring", s);
+    }
+
+    {
+        LockedQueue q(256);
+        Stats s = run(seconds, producers, submit_hz,
+            [&](CommandEnvelope env) { return q.submit(std::move(env)); },
+            [&] { return q.pop().has_value(); });
+        report("mutex-deque", s);
+    }
+
+    return 0;
+}
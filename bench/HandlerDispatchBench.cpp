@@ -0,0 +1,104 @@
+// Handler lookup + invoke cost: dense HandlerTable vs. the previous mutex + unordered_map +
+// std::function copy path. Handlers capture a std::string label like UgvCore's register_stub,
+// so copying them allocates.
+//
+// Usage: ugv_bench_handler_dispatch [iterations=5000000]
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "command/HandlerTable.hpp"
+
+namespace {
+
+using namespace arcraven::ugv;
+using Clock = std::chrono::steady_clock;
+
+constexpr UgvCommand kCommands[] = {
+    UgvCommand::FollowPath, UgvCommand::GoTo, UgvCommand::Stop, UgvCommand::Dock,
+    UgvCommand::SetSpeedLimit, UgvCommand::FaceTarget, UgvCommand::ScanArea, UgvCommand::Observe,
+    UgvCommand::Sentinel, UgvCommand::Shadow, UgvCommand::ExecuteMission, UgvCommand::Wait,
+    UgvCommand::Signal, UgvCommand::EmergencyStop, UgvCommand::Reboot, UgvCommand::UnlockCommandSet,
+};
+constexpr size_t kCommandCount = sizeof(kCommands) / sizeof(kCommands[0]);
+
+CommandHandler make_handler(std::string label) {
+    return [label = std::move(label)](const CommandEnvelope& c) -> CommandResult {
+        CommandResult r{};
+        r.status = label.size() + c.command_id > 0 ? CommandStatus::Accepted : CommandStatus::Rejected;
+        return r;
+    };
+}
+
+template <typename Fn>
+double time_ns_per_op(size_t iterations, Fn&& fn) {
+    const auto t0 = Clock::now();
+    fn();
+    const auto t1 = Clock::now();
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count()) /
+           static_cast<double>(iterations);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t iterations = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 5000000;
+
+    std::vector<CommandEnvelope> envs(kCommandCount);
+    for (size_t i = 0; i < kCommandCount; ++i) {
+        envs[i].command = kCommands[i];
+        envs[i].command_id = i + 1;
+    }
+
+    // Previous path.
+    std::mutex mu;
+    std::unordered_map<uint16_t, CommandHandler> map;
+    for (const auto c : kCommands) {
+        map[static_cast<uint16_t>(c)] = make_handler("handler label for " + std::to_string(static_cast<int>(c)));
+    }
+
+    // Dense table.
+    std::vector<std::unique_ptr<CommandHandler>> store;
+    HandlerTable table;
+    for (const auto c : kCommands) {
+        store.push_back(std::make_unique<CommandHandler>(
+            make_handler("handler label for " + std::to_string(static_cast<int>(c)))));
+        table.slots[command_slot(c)] = store.back().get();
+    }
+
+    uint64_t sink = 0;
+
+    const double map_ns = time_ns_per_op(iterations, [&] {
+        for (size_t i = 0; i < iterations; ++i) {
+            const CommandEnvelope& env = envs[i % kCommandCount];
+            CommandHandler handler;
+            {
+                std::lock_guard<std::mutex> lk(mu);
+                auto it = map.find(static_cast<uint16_t>(env.command));
+                if (it != map.end()) handler = it->second;
+            }
+            if (handler) sink += static_cast<uint64_t>(handler(env).status);
+        }
+    });
+
+    const double table_ns = time_ns_per_op(iterations, [&] {
+        for (size_t i = 0; i < iterations; ++i) {
+            const CommandEnvelope& env = envs[i % kCommandCount];
+            const CommandHandler* handler = table.find(env.command);
+            if (handler) sink += static_cast<uint64_t>((*handler)(env).status);
+        }
+    });
+
+    std::printf("iterations=%zu\n", iterations);
+    std::printf("mutex+unordered_map+copy: %7.2f ns/dispatch\n", map_ns);
+    std::printf("dense HandlerTable:       %7.2f ns/dispatch\n", table_ns);
+    std::printf("(sink=%llu)\n", static_cast<unsigned long long>(sink));
+    return 0;
+}
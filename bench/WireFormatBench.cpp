@@ -0,0 +1,509 @@
+// File transport wire cost: text lines vs. binary frames (WireProtocol.hpp).
+//
+// For commands (the commands.in mix of CommandLineParseBench), results and telemetry frames
+// (12 joints, 3 sensors with short JSON payloads) reports bytes per record and ns to encode
+// and to decode one, text first, then binary. Text telemetry is encoded the way
+// Iceoryx2Bridge::publish_telemetry does it (ostream <<) and decoded with from_chars, the
+// C++ equivalent of Iceoryx2Transport's line parser. Interned telemetry frames (schema sent
+// once, joints in schema order, numeric sensor channels) are compared with full ones. Exits
+// non-zero if a decode disagrees with what was encoded. Joint keyframes + deltas
+// (JointDeltaEncoder) are compared with interned frames on 8 drives moving smoothly at 100 Hz,
+// checking that every reconstructed value is within half a resolution step.
+//
+// Usage: ugv_bench_wire_format [records=200000]
+
+#include <charconv>
+#include <cmath>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "subsystems/CommandLineParser.hpp"
+#include "subsystems/TelemetrySchema.hpp"
+#include "subsystems/WireProtocol.hpp"
+#include "utils/Base64.hpp"
+
+namespace {
+
+using namespace arcraven::ugv;
+using Clock = std::chrono::steady_clock;
+
+struct Cost {
+    double bytes = 0.0;
+    double encode_ns = 0.0;
+    double decode_ns = 0.0;
+};
+
+void report(const char* name, const Cost& text, const Cost& binary) {
+    std::printf("%-10s text   %7.1f B  enc %7.1f ns  dec %7.1f ns\n", name, text.bytes, text.encode_ns, text.decode_ns);
+    std::printf("%-10s binary %7.1f B  enc %7.1f ns  dec %7.1f ns  (%.2fx smaller, %.2fx faster decode)\n", "",
+                binary.bytes, binary.encode_ns, binary.decode_ns, text.bytes / binary.bytes,
+                text.decode_ns / binary.decode_ns);
+}
+
+double ns_per(Clock::time_point t0, uint64_t n) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / static_cast<double>(n);
+}
+
+void append_uint(std::string& out, uint64_t v) {
+    char buf[20];
+    const auto res = std::to_chars(buf, buf + sizeof(buf), v);
+    out.append(buf, res.ptr);
+}
+
+// --- commands ---------------------------------------------------------------------------------
+
+std::vector<CommandEnvelope> make_commands(uint64_t n) {
+    const char* payloads[] = {"12.5|-3.25|1.5708", "1.25", "0|0;4.5|0;4.5|6;0|6;0|0", "operator"};
+    const UgvCommand commands[] = {UgvCommand::GoTo, UgvCommand::SetSpeedLimit, UgvCommand::FollowPath, UgvCommand::Stop};
+    std::vector<CommandEnvelope> out(n);
+    for (uint64_t i = 0; i < n; ++i) {
+        CommandEnvelope& env = out[i];
+        env.command_id = i + 1;
+        env.command = commands[i % 4];
+        env.domain = CommandDomain::Mobility;
+        env.priority = CommandPriority::Normal;
+        env.authority = CommandAuthority::RemoteOperator;
+        env.issued_ns = 1'700'000'000'000'000'000ull + i * 1000;
+        env.ttl_ns = i % 4 == 1 ? 200'000'000 : 0;
+        (void)env.payload_json.assign(payloads[i % 4]);
+    }
+    return out;
+}
+
+void encode_command_line(std::string& out, const CommandEnvelope& env) {
+    out += "C|";
+    append_uint(out, env.command_id);
+    out += '|';
+    append_uint(out, static_cast<uint16_t>(env.command));
+    out += '|';
+    append_uint(out, static_cast<uint8_t>(env.domain));
+    out += '|';
+    append_uint(out, static_cast<uint8_t>(env.priority));
+    out += '|';
+    append_uint(out, static_cast<uint8_t>(env.authority));
+    out += '|';
+    append_uint(out, env.issued_ns);
+    out += '|';
+    append_uint(out, env.ttl_ns);
+    out += '|';
+    out += arcraven::utils::base64_encode(std::string(env.payload_json.view()));
+    out += '\n';
+}
+
+bool same_command(const CommandEnvelope& a, const CommandEnvelope& b) {
+    return a.command_id == b.command_id && a.command == b.command && a.issued_ns == b.issued_ns &&
+           a.ttl_ns == b.ttl_ns && a.payload_json.view() == b.payload_json.view();
+}
+
+bool bench_commands(uint64_t n) {
+    const std::vector<CommandEnvelope> commands = make_commands(n);
+    bool ok = true;
+    Cost text, binary;
+
+    std::string buf;
+    buf.reserve(n * 128);
+    auto t0 = Clock::now();
+    for (const auto& env : commands) encode_command_line(buf, env);
+    text.encode_ns = ns_per(t0, n);
+    text.bytes = static_cast<double>(buf.size()) / static_cast<double>(n);
+    t0 = Clock::now();
+    std::string_view in = buf;
+    for (uint64_t i = 0; i < n; ++i) {
+        const size_t nl = in.find('\n');
+        CommandEnvelope env{};
+        ok &= parse_command_line(in.substr(0, nl), env).status == CommandLineStatus::Ok && same_command(env, commands[i]);
+        in.remove_prefix(nl + 1);
+    }
+    text.decode_ns = ns_per(t0, n);
+
+    buf.clear();
+    t0 = Clock::now();
+    for (const auto& env : commands) append_command_frame(buf, env);
+    binary.encode_ns = ns_per(t0, n);
+    binary.bytes = static_cast<double>(buf.size()) / static_cast<double>(n);
+    t0 = Clock::now();
+    in = buf;
+    for (uint64_t i = 0; i < n; ++i) {
+        WireFrame frame;
+        CommandEnvelope env{};
+        ok &= scan_wire_frame(in, kWireMaxCommandBody, frame) == WireScan::Frame &&
+              decode_command_frame(frame.body, env).status == CommandLineStatus::Ok && same_command(env, commands[i]);
+        in.remove_prefix(frame.size);
+    }
+    binary.decode_ns = ns_per(t0, n);
+
+    report("command", text, binary);
+    return ok;
+}
+
+// --- results ----------------------------------------------------------------------------------
+
+bool bench_results(uint64_t n) {
+    bool ok = true;
+    Cost text, binary;
+    const std::string_view message = "progress 0.42";
+
+    std::string buf;
+    auto t0 = Clock::now();
+    for (uint64_t id = 1; id <= n; ++id) {
+        buf += "R|";
+        append_uint(buf, id);
+        buf += "|5|0|";
+        buf += message;
+        buf += '\n';
+    }
+    text.encode_ns = ns_per(t0, n);
+    text.bytes = static_cast<double>(buf.size()) / static_cast<double>(n);
+    t0 = Clock::now();
+    std::string_view in = buf;
+    for (uint64_t id = 1; id <= n; ++id) {
+        const std::string_view line = in.substr(0, in.find('\n'));
+        in.remove_prefix(line.size() + 1);
+        uint64_t got = 0;
+        unsigned status = 0, reason = 0;
+        const char* p = line.data() + 2;
+        const char* end = line.data() + line.size();
+        p = std::from_chars(p, end, got).ptr + 1;
+        p = std::from_chars(p, end, status).ptr + 1;
+        p = std::from_chars(p, end, reason).ptr + 1;
+        ok &= got == id && status == 5 && std::string_view(p, static_cast<size_t>(end - p)) == message;
+    }
+    text.decode_ns = ns_per(t0, n);
+
+    buf.clear();
+    t0 = Clock::now();
+    for (uint64_t id = 1; id <= n; ++id) {
+        append_result_frame(buf, id, CommandStatus::Succeeded, RejectReason::None, message);
+    }
+    binary.encode_ns = ns_per(t0, n);
+    binary.bytes = static_cast<double>(buf.size()) / static_cast<double>(n);
+    t0 = Clock::now();
+    in = buf;
+    for (uint64_t id = 1; id <= n; ++id) {
+        WireFrame frame;
+        ok &= scan_wire_frame(in, 1024, frame) == WireScan::Frame && frame.type == WireFrameType::Result;
+        uint64_t got = 0;
+        std::memcpy(&got, frame.body.data(), sizeof(got));
+        ok &= got == id && frame.body[8] == static_cast<char>(CommandStatus::Succeeded) &&
+              frame.body.substr(kWireResultFixed) == message;
+        in.remove_prefix(frame.size);
+    }
+    binary.decode_ns = ns_per(t0, n);
+
+    report("result", text, binary);
+    return ok;
+}
+
+// --- telemetry --------------------------------------------------------------------------------
+
+void make_telemetry(SensorFrame& frame, std::vector<JointState>& joints) {
+    frame.timestamp_ns = 1'700'000'000'123'456'789ull;
+    for (int i = 0; i < 12; ++i) {
+        const std::string n = std::to_string(i);
+        joints.push_back({"j" + n, "leg_" + n, 0.1234567 * i, -0.0421 * i, 3.5 + i});
+    }
+    frame.ids = {"imu0", "gps0", "bat0"};
+    frame.types = {"imu", "gps", "battery"};
+    frame.payloads = {R"({"ax":0.01,"ay":-0.02,"az":9.81})", R"({"lat":45.5017,"lon":-73.5673})", R"({"v":48.2,"soc":0.87})"};
+}
+
+void encode_telemetry_line(std::ostream& out, const SensorFrame& frame, const std::vector<JointState>& joints) {
+    out << "T|" << frame.timestamp_ns << "|" << joints.size();
+    for (const auto& joint : joints) {
+        out << "|" << joint.id << "|" << joint.name << "|" << joint.position << "|" << joint.velocity << "|" << joint.load;
+    }
+    out << "|" << frame.ids.size();
+    for (size_t i = 0; i < frame.ids.size(); ++i) {
+        out << "|" << frame.ids[i] << "|" << frame.types[i] << "|" << arcraven::utils::base64_encode(frame.payloads[i]);
+    }
+    out << "\n";
+}
+
+struct Cursor {
+    std::string_view in;
+    std::string_view next() {
+        const size_t pos = in.find('|');
+        const std::string_view tok = in.substr(0, pos);
+        in.remove_prefix(pos == std::string_view::npos ? in.size() : pos + 1);
+        return tok;
+    }
+    template <typename T>
+    T num() {
+        const std::string_view tok = next();
+        T v{};
+        std::from_chars(tok.data(), tok.data() + tok.size(), v);
+        return v;
+    }
+};
+
+bool decode_telemetry_line(std::string_view line, SensorFrame& frame, std::vector<JointState>& joints) {
+    Cursor c{line};
+    if (c.next() != "T") return false;
+    frame.timestamp_ns = c.num<uint64_t>();
+    joints.resize(c.num<size_t>());
+    for (auto& joint : joints) {
+        joint.id = c.next();
+        joint.name = c.next();
+        joint.position = c.num<double>();
+        joint.velocity = c.num<double>();
+        joint.load = c.num<double>();
+    }
+    const size_t sensors = c.num<size_t>();
+    frame.ids.resize(sensors);
+    frame.types.resize(sensors);
+    frame.payloads.resize(sensors);
+    bool ok = true;
+    for (size_t i = 0; i < sensors; ++i) {
+        frame.ids[i] = c.next();
+        frame.types[i] = c.next();
+        frame.payloads[i] = arcraven::utils::base64_decode(std::string(c.next()), ok);
+    }
+    return ok;
+}
+
+template <typename T>
+T take(std::string_view& in) {
+    T v{};
+    std::memcpy(&v, in.data(), sizeof(v));
+    in.remove_prefix(sizeof(v));
+    return v;
+}
+
+template <typename Len>
+std::string_view take_str(std::string_view& in) {
+    const Len n = take<Len>(in);
+    const std::string_view s = in.substr(0, n);
+    in.remove_prefix(n);
+    return s;
+}
+
+bool decode_telemetry_frame(std::string_view body, SensorFrame& frame, std::vector<JointState>& joints) {
+    if (body.size() < 16) return false;
+    frame.timestamp_ns = take<uint64_t>(body);
+    joints.resize(take<uint32_t>(body));
+    const uint32_t sensors = take<uint32_t>(body);
+    for (auto& joint : joints) {
+        joint.id = take_str<uint16_t>(body);
+        joint.name = take_str<uint16_t>(body);
+        joint.position = take<double>(body);
+        joint.velocity = take<double>(body);
+        joint.load = take<double>(body);
+    }
+    frame.ids.resize(sensors);
+    frame.types.resize(sensors);
+    frame.payloads.resize(sensors);
+    for (uint32_t i = 0; i < sensors; ++i) {
+        frame.ids[i] = take_str<uint16_t>(body);
+        frame.types[i] = take_str<uint16_t>(body);
+        frame.payloads[i] = take_str<uint32_t>(body);
+    }
+    return true;
+}
+
+bool decode_interned_frame(std::string_view body, const TelemetrySchema& schema, SensorFrame& frame,
+                           std::vector<JointState>& joints) {
+    if (body.size() < 16) return false;
+    frame.timestamp_ns = take<uint64_t>(body);
+    if (take<uint32_t>(body) != schema.id()) return false;
+    const uint32_t sensors = take<uint32_t>(body);
+    joints.resize(schema.joints().size());
+    for (size_t i = 0; i < joints.size(); ++i) {
+        joints[i].id = schema.joints()[i].id;
+        joints[i].name = schema.joints()[i].name;
+        joints[i].position = take<double>(body);
+        joints[i].velocity = take<double>(body);
+        joints[i].load = take<double>(body);
+    }
+    frame.ids.resize(sensors);
+    frame.types.resize(sensors);
+    frame.payloads.resize(sensors);
+    for (uint32_t i = 0; i < sensors; ++i) {
+        const uint16_t channel = take<uint16_t>(body);
+        if (channel >= schema.channels().size()) return false;
+        frame.ids[i] = schema.channels()[channel].id;
+        frame.types[i] = schema.channels()[channel].type;
+        frame.payloads[i] = take_str<uint32_t>(body);
+    }
+    return true;
+}
+
+bool bench_telemetry(uint64_t n) {
+    SensorFrame frame;
+    std::vector<JointState> joints;
+    make_telemetry(frame, joints);
+    bool ok = true;
+    Cost text, binary;
+
+    std::ostringstream os;
+    auto t0 = Clock::now();
+    for (uint64_t i = 0; i < n; ++i) encode_telemetry_line(os, frame, joints);
+    text.encode_ns = ns_per(t0, n);
+    std::string buf = std::move(os).str();
+    text.bytes = static_cast<double>(buf.size()) / static_cast<double>(n);
+    t0 = Clock::now();
+    std::string_view in = buf;
+    for (uint64_t i = 0; i < n; ++i) {
+        const size_t nl = in.find('\n');
+        SensorFrame got;
+        std::vector<JointState> got_joints;
+        ok &= decode_telemetry_line(in.substr(0, nl), got, got_joints) && got.payloads == frame.payloads &&
+              got_joints.size() == joints.size() && got_joints.back().name == joints.back().name;
+        in.remove_prefix(nl + 1);
+    }
+    text.decode_ns = ns_per(t0, n);
+
+    buf.clear();
+    t0 = Clock::now();
+    for (uint64_t i = 0; i < n; ++i) ok &= append_telemetry_frame(buf, frame, joints);
+    binary.encode_ns = ns_per(t0, n);
+    binary.bytes = static_cast<double>(buf.size()) / static_cast<double>(n);
+    t0 = Clock::now();
+    in = buf;
+    for (uint64_t i = 0; i < n; ++i) {
+        WireFrame wf;
+        SensorFrame got;
+        std::vector<JointState> got_joints;
+        ok &= scan_wire_frame(in, 1u << 20, wf) == WireScan::Frame && decode_telemetry_frame(wf.body, got, got_joints) &&
+              got.payloads == frame.payloads && got_joints.size() == joints.size() &&
+              got_joints.back().position == joints.back().position;
+        in.remove_prefix(wf.size);
+    }
+    binary.decode_ns = ns_per(t0, n);
+
+    report("telemetry", text, binary);
+
+    // Interned: the schema frame is written once, as the bridge does at the head of a segment.
+    TelemetrySchema schema;
+    std::vector<uint16_t> channels;
+    schema.update(frame, joints, channels);
+    buf.clear();
+    Cost interned;
+    t0 = Clock::now();
+    for (uint64_t i = 0; i < n; ++i) {
+        schema.update(frame, joints, channels);
+        ok &= append_interned_telemetry_frame(buf, schema.id(), frame, joints, channels);
+    }
+    interned.encode_ns = ns_per(t0, n);
+    interned.bytes = static_cast<double>(buf.size()) / static_cast<double>(n);
+    t0 = Clock::now();
+    in = buf;
+    for (uint64_t i = 0; i < n; ++i) {
+        WireFrame wf;
+        SensorFrame got;
+        std::vector<JointState> got_joints;
+        ok &= scan_wire_frame(in, 1u << 20, wf) == WireScan::Frame &&
+              decode_interned_frame(wf.body, schema, got, got_joints) && got.payloads == frame.payloads &&
+              got.ids == frame.ids && got_joints.size() == joints.size() &&
+              got_joints.back().name == joints.back().name && got_joints.back().position == joints.back().position;
+        in.remove_prefix(wf.size);
+    }
+    interned.decode_ns = ns_per(t0, n);
+    std::printf("%-10s intern %7.1f B  enc %7.1f ns  dec %7.1f ns  (%.2fx smaller than binary)\n", "",
+                interned.bytes, interned.encode_ns, interned.decode_ns, binary.bytes / interned.bytes);
+    return ok;
+}
+
+// --- joint keyframes + deltas -------------------------------------------------------------------
+
+void make_drives(uint64_t i, std::vector<JointState>& joints) {
+    const double t = static_cast<double>(i) * 0.01; // 100 Hz
+    for (size_t d = 0; d < joints.size(); ++d) {
+        const double phase = static_cast<double>(d);
+        joints[d].position = 12.0 * t + std::sin(t + phase);
+        joints[d].velocity = 12.0 + std::cos(t + phase);
+        joints[d].load = 4.0 + 0.5 * std::sin(3.0 * t + phase);
+    }
+}
+
+uint64_t take_varint(std::string_view& in) {
+    uint64_t v = 0;
+    for (int shift = 0; !in.empty(); shift += 7) {
+        const auto b = static_cast<uint8_t>(in.front());
+        in.remove_prefix(1);
+        v |= static_cast<uint64_t>(b & 0x7F) << shift;
+        if ((b & 0x80) == 0) break;
+    }
+    return v;
+}
+
+bool bench_joint_delta(uint64_t n) {
+    std::vector<JointState> joints(8);
+    for (size_t d = 0; d < joints.size(); ++d) joints[d] = {"d" + std::to_string(d), "drive_" + std::to_string(d), 0, 0, 0};
+    SensorFrame frame;
+    TelemetrySchema schema;
+    std::vector<uint16_t> channels;
+    schema.update(frame, joints, channels);
+    JointDeltaEncoder delta;
+    JointDeltaConfig cfg;
+    cfg.enabled = true;
+    delta.configure(cfg);
+
+    std::string interned, deltas;
+    Cost full, packed;
+    auto t0 = Clock::now();
+    for (uint64_t i = 0; i < n; ++i) {
+        make_drives(i, joints);
+        (void)append_interned_telemetry_frame(interned, schema.id(), frame, joints, channels);
+    }
+    full.encode_ns = ns_per(t0, n);
+    full.bytes = static_cast<double>(interned.size()) / static_cast<double>(n);
+    t0 = Clock::now();
+    bool ok = true;
+    for (uint64_t i = 0; i < n; ++i) {
+        make_drives(i, joints);
+        ok &= delta.prepare(joints, schema.id()) &&
+              append_delta_telemetry_frame(deltas, schema.id(), delta, frame, channels);
+        delta.commit(true);
+    }
+    packed.encode_ns = ns_per(t0, n);
+    packed.bytes = static_cast<double>(deltas.size()) / static_cast<double>(n);
+
+    // Rebuild every frame and compare with the source values.
+    const double resolution[3] = {cfg.position_resolution, cfg.velocity_resolution, cfg.load_resolution};
+    std::vector<int64_t> q(joints.size() * 3);
+    double worst[3] = {};
+    std::string_view in = deltas;
+    for (uint64_t i = 0; i < n; ++i) {
+        WireFrame wf;
+        ok &= scan_wire_frame(in, 1u << 20, wf) == WireScan::Frame;
+        std::string_view body = wf.body;
+        body.remove_prefix(16);
+        const bool keyframe = take<uint8_t>(body) != 0;
+        body.remove_prefix(3 + (keyframe ? 3 * sizeof(double) : 0));
+        make_drives(i, joints);
+        for (size_t k = 0; k < q.size(); ++k) {
+            const uint64_t u = take_varint(body);
+            const auto v = static_cast<int64_t>(u >> 1) ^ -static_cast<int64_t>(u & 1);
+            q[k] = keyframe ? v : q[k] + v;
+            const JointState& j = joints[k / 3];
+            const double source = k % 3 == 0 ? j.position : k % 3 == 1 ? j.velocity : j.load;
+            worst[k % 3] = std::max(worst[k % 3], std::fabs(static_cast<double>(q[k]) * resolution[k % 3] - source));
+        }
+        in.remove_prefix(wf.size);
+    }
+    for (int f = 0; f < 3; ++f) ok &= worst[f] <= resolution[f] / 2 * (1 + 1e-9);
+
+    std::printf("joints    intern %7.1f B  enc %7.1f ns\n", full.bytes, full.encode_ns);
+    std::printf("%-10s delta  %7.1f B  enc %7.1f ns  (%.2fx smaller, worst error %.2g / %.2g / %.2g)\n", "",
+                packed.bytes, packed.encode_ns, full.bytes / packed.bytes, worst[0], worst[1], worst[2]);
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const uint64_t records = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200'000;
+    bool ok = bench_commands(records);
+    ok &= bench_results(records);
+    ok &= bench_telemetry(records / 4);
+    ok &= bench_joint_delta(records / 4);
+    if (!ok) std::printf("MISMATCH\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,228 @@
+#include "command/AuthorityArbiter.hpp"
+
+#include <initializer_list>
+#include <string>
+#include <variant>
+
+#include "command/CommandRegistry.hpp"
+
+namespace arcraven::ugv {
+
+namespace {
+
+using arcraven::ugv::CommandAuthority;
+
+constexpr auto kUnowned = CommandAuthority::Unknown;
+
+std::bitset<kHandlerSlots> slots_of(std::initializer_list<arcraven::ugv::UgvCommand> cmds) {
+    std::bitset<kHandlerSlots> s;
+    for (const auto c : cmds) s.set(command_slot(c));
+    return s;
+}
+
+const std::bitset<kHandlerSlots>& safety_commands() {
+    static const auto s = slots_of({arcraven::ugv::UgvCommand::EmergencyStop, arcraven::ugv::UgvCommand::Stop});
+    return s;
+}
+
+const std::bitset<kHandlerSlots>& authority_commands() {
+    static const auto s = slots_of({arcraven::ugv::UgvCommand::SetOwnership, arcraven::ugv::UgvCommand::LockCommandSet,
+                                    arcraven::ugv::UgvCommand::UnlockCommandSet, arcraven::ugv::UgvCommand::HandoffControl});
+    return s;
+}
+
+// Commands the registry lets this authority issue at all.
+std::bitset<kHandlerSlots> registry_permitted(CommandAuthority a) {
+    std::bitset<kHandlerSlots> s;
+    for (const CommandInfo& c : kCommandRegistry) {
+        if (c.authorities & authority_bit(a)) s.set(command_slot(c.command));
+    }
+    return s;
+}
+
+CommandResult not_authorized(std::string message) {
+    return {arcraven::ugv::CommandStatus::Rejected, arcraven::ugv::RejectReason::NotAuthorized, std::move(message)};
+}
+
+CommandResult invalid(std::string message) {
+    return {arcraven::ugv::CommandStatus::Rejected, arcraven::ugv::RejectReason::InvalidPayload, std::move(message)};
+}
+
+CommandResult succeeded(std::string message) {
+    return {arcraven::ugv::CommandStatus::Succeeded, arcraven::ugv::RejectReason::None, std::move(message)};
+}
+
+} // namespace
+
+AuthorityArbiter::AuthorityArbiter() {
+    owners_.fill(kUnowned);
+    locks_.fill(kUnowned);
+    std::lock_guard<std::mutex> lk(mu_);
+    publish();
+}
+
+bool AuthorityArbiter::permits(const CommandEnvelope& cmd) const {
+    const CommandInfo* info = command_info(cmd.command);
+    if (!info) return false;
+
+    // seq_cst pairs with publish(): see readers_.
+    readers_.fetch_add(1, std::memory_order_seq_cst);
+    const bool ok = table_.load(std::memory_order_seq_cst)->permits(cmd.authority, info->domain, cmd.command);
+    readers_.fetch_sub(1, std::memory_order_release);
+    return ok;
+}
+
+bool AuthorityArbiter::may_change(CommandAuthority issuer, CommandAuthority holder) const {
+    return holder == kUnowned || holder == issuer || issuer == CommandAuthority::SafetySystem;
+}
+
+void AuthorityArbiter::publish() {
+    auto next = std::make_unique<AuthorityTable>();
+
+    const auto& auth_cmds = authority_commands();
+    const size_t auth_domain = static_cast<size_t>(arcraven::ugv::CommandDomain::Authority);
+
+    for (size_t a = 0; a < kAuthorities; ++a) {
+        const auto authority = static_cast<CommandAuthority>(a);
+        const auto permitted = registry_permitted(authority);
+        if (authority == CommandAuthority::SafetySystem) {
+            next->allowed[a].fill(permitted);
+            continue;
+        }
+
+        std::bitset<kHandlerSlots> unlocked;
+        for (size_t slot = 0; slot < kHandlerSlots; ++slot) {
+            unlocked[slot] = locks_[slot] == kUnowned || locks_[slot] == authority;
+        }
+        const auto owns = [&](size_t d) { return owners_[d] == kUnowned || owners_[d] == authority; };
+        const auto arbitration = owns(auth_domain) ? (unlocked & auth_cmds) : std::bitset<kHandlerSlots>{};
+
+        for (size_t d = 0; d < kCommandDomains; ++d) {
+            auto bits = owns(d) ? (unlocked & ~auth_cmds) : std::bitset<kHandlerSlots>{};
+            next->allowed[a][d] = (bits | arbitration | safety_commands()) & permitted;
+        }
+    }
+
+    table_.store(next.get(), std::memory_order_seq_cst);
+    if (current_) retired_.push_back(std::move(current_));
+    current_ = std::move(next);
+    if (readers_.load(std::memory_order_seq_cst) == 0) retired_.clear();
+}
+
+CommandResult AuthorityArbiter::set_owner(CommandAuthority issuer, const OwnershipPayload& p) {
+    if (issuer == kUnowned) return not_authorized("unknown issuer");
+
+    std::lock_guard<std::mutex> lk(mu_);
+    auto& owner = owners_[static_cast<size_t>(p.domain)];
+    if (!may_change(issuer, owner)) {
+        return not_authorized("domain owned by " + std::to_string(static_cast<int>(owner)));
+    }
+    owner = p.owner;
+    publish();
+    return succeeded(p.owner == kUnowned ? "domain released" : "domain owned");
+}
+
+CommandResult AuthorityArbiter::lock(CommandAuthority issuer, const CommandSetPayload& p) {
+    if (issuer == kUnowned) return not_authorized("unknown issuer");
+
+    std::lock_guard<std::mutex> lk(mu_);
+    for (uint8_t i = 0; i < p.count; ++i) {
+        const size_t slot = command_slot(p.commands[i]);
+        if (slot >= kHandlerSlots) return invalid("unknown command " + std::to_string(static_cast<int>(p.commands[i])));
+        if (safety_commands().test(slot)) return invalid("safety commands cannot be locked");
+        if (!may_change(issuer, locks_[slot])) {
+            return not_authorized("command " + std::to_string(static_cast<int>(p.commands[i])) + " locked by " +
+                                  std::to_string(static_cast<int>(locks_[slot])));
+        }
+    }
+    for (uint8_t i = 0; i < p.count; ++i) locks_[command_slot(p.commands[i])] = issuer;
+    publish();
+    return succeeded("locked " + std::to_string(p.count));
+}
+
+CommandResult AuthorityArbiter::unlock(CommandAuthority issuer, const CommandSetPayload& p) {
+    if (issuer == kUnowned) return not_authorized("unknown issuer");
+
+    std::lock_guard<std::mutex> lk(mu_);
+    size_t released = 0;
+    if (p.count == 0) {
+        for (auto& holder : locks_) {
+            if (holder == issuer) {
+                holder = kUnowned;
+                ++released;
+            }
+        }
+    } else {
+        for (uint8_t i = 0; i < p.count; ++i) {
+            const size_t slot = command_slot(p.commands[i]);
+            if (slot >= kHandlerSlots) return invalid("unknown command " + std::to_string(static_cast<int>(p.commands[i])));
+            if (!may_change(issuer, locks_[slot])) {
+                return not_authorized("command " + std::to_string(static_cast<int>(p.commands[i])) + " locked by " +
+                                      std::to_string(static_cast<int>(locks_[slot])));
+            }
+        }
+        for (uint8_t i = 0; i < p.count; ++i) {
+            auto& holder = locks_[command_slot(p.commands[i])];
+            released += holder != kUnowned ? 1 : 0;
+            holder = kUnowned;
+        }
+    }
+    publish();
+    return succeeded("unlocked " + std::to_string(released));
+}
+
+CommandResult AuthorityArbiter::handoff(CommandAuthority issuer, const HandoffPayload& p) {
+    if (issuer == kUnowned) return not_authorized("unknown issuer");
+
+    std::lock_guard<std::mutex> lk(mu_);
+    size_t moved = 0;
+    for (auto& owner : owners_) {
+        if (owner == issuer) {
+            owner = p.to;
+            ++moved;
+        }
+    }
+    for (auto& holder : locks_) {
+        if (holder == issuer) {
+            holder = p.to;
+            ++moved;
+        }
+    }
+    if (moved == 0) return not_authorized("nothing to hand off");
+
+    publish();
+    return succeeded("control handed to " + std::to_string(static_cast<int>(p.to)));
+}
+
+CommandResult AuthorityArbiter::execute(const CommandEnvelope& cmd) {
+    switch (cmd.command) {
+        case arcraven::ugv::UgvCommand::SetOwnership: {
+            const auto* p = std::get_if<OwnershipPayload>(&cmd.typed);
+            return p ? set_owner(cmd.authority, *p) : invalid("missing payload");
+        }
+        case arcraven::ugv::UgvCommand::LockCommandSet: {
+            const auto* p = std::get_if<CommandSetPayload>(&cmd.typed);
+            return p ? lock(cmd.authority, *p) : invalid("missing payload");
+        }
+        case arcraven::ugv::UgvCommand::UnlockCommandSet: {
+            const auto* p = std::get_if<CommandSetPayload>(&cmd.typed);
+            return unlock(cmd.authority, p ? *p : CommandSetPayload{});
+        }
+        case arcraven::ugv::UgvCommand::HandoffControl: {
+            const auto* p = std::get_if<HandoffPayload>(&cmd.typed);
+            return p ? handoff(cmd.authority, *p) : invalid("missing payload");
+        }
+        default:
+            return {arcraven::ugv::CommandStatus::Rejected, arcraven::ugv::RejectReason::Unsupported,
+                    "not an authority command"};
+    }
+}
+
+CommandAuthority AuthorityArbiter::owner(arcraven::ugv::CommandDomain domain) const {
+    const auto d = static_cast<size_t>(domain);
+    if (d >= kCommandDomains) return kUnowned;
+    std::lock_guard<std::mutex> lk(mu_);
+    return owners_[d];
+}
+
+} // namespace arcraven::ugv
@@ -0,0 +1,87 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "command/HandlerTable.hpp"
+
+namespace arcraven::ugv {
+
+inline constexpr size_t kAuthorities = static_cast<size_t>(arcraven::ugv::CommandAuthority::SafetySystem) + 1;
+inline constexpr size_t kCommandDomains = static_cast<size_t>(arcraven::ugv::CommandDomain::Authority) + 1;
+
+// Compiled permissions: bit command_slot(cmd) of allowed[authority][domain] is set when that
+// authority may submit cmd in that domain. Immutable once published.
+struct AuthorityTable {
+    std::array<std::array<std::bitset<kHandlerSlots>, kCommandDomains>, kAuthorities> allowed{};
+
+    bool permits(arcraven::ugv::CommandAuthority authority, arcraven::ugv::CommandDomain domain,
+                 arcraven::ugv::UgvCommand cmd) const {
+        const auto a = static_cast<size_t>(authority);
+        const auto d = static_cast<size_t>(domain);
+        const size_t slot = command_slot(cmd);
+        return a < kAuthorities && d < kCommandDomains && slot < kHandlerSlots && allowed[a][d].test(slot);
+    }
+};
+
+// Domain ownership and command-set locks, compiled into an AuthorityTable on every change.
+//
+// Rules, on top of the per-command authorities in kCommandRegistry (SafetySystem bypasses all
+// of them; EmergencyStop and Stop are always allowed):
+// - an owned domain only accepts commands from its owner; an unowned one from anyone
+// - a locked command is only accepted from the authority that locked it
+// - the Authority-domain commands are governed by the owner of CommandDomain::Authority
+//
+// permits() is lock-free and safe from any thread. Changes come from the control thread (the
+// SetOwnership/LockCommandSet/UnlockCommandSet/HandoffControl handlers); each one is applied as a
+// whole and published with a single pointer swap, so submit never sees a half-applied update.
+class AuthorityArbiter final {
+public:
+    AuthorityArbiter();
+
+    // Checks cmd.authority against the domain kCommandRegistry gives cmd.command; cmd.domain is
+    // not trusted, so callers need not normalise it first. Unknown commands are refused.
+    bool permits(const CommandEnvelope& cmd) const;
+
+    // Claim/release (owner Unknown) a domain. Taking a domain owned by someone else is refused.
+    CommandResult set_owner(arcraven::ugv::CommandAuthority issuer, const OwnershipPayload& p);
+
+    // Locks commands to the issuer; all or nothing.
+    CommandResult lock(arcraven::ugv::CommandAuthority issuer, const CommandSetPayload& p);
+
+    // Releases the issuer's locks on the listed commands (all of them when the set is empty).
+    CommandResult unlock(arcraven::ugv::CommandAuthority issuer, const CommandSetPayload& p);
+
+    // Moves every domain and lock held by the issuer to p.to.
+    CommandResult handoff(arcraven::ugv::CommandAuthority issuer, const HandoffPayload& p);
+
+    // Runs an Authority-domain command (one of the four above, issued by cmd.authority, with
+    // its typed payload). The one entry point for UgvCore's handler and ugv_replay, so a replay
+    // applies exactly what the vehicle did. Anything else is Unsupported.
+    CommandResult execute(const CommandEnvelope& cmd);
+
+    arcraven::ugv::CommandAuthority owner(arcraven::ugv::CommandDomain domain) const;
+
+private:
+    bool may_change(arcraven::ugv::CommandAuthority issuer, arcraven::ugv::CommandAuthority holder) const;
+    void publish(); // requires mu_
+
+    mutable std::mutex mu_;
+    std::array<arcraven::ugv::CommandAuthority, kCommandDomains> owners_{};
+    std::array<arcraven::ugv::CommandAuthority, kHandlerSlots> locks_{};
+
+    // Tables, RCU style. permits() counts itself in readers_ around its use of table_. publish()
+    // swaps in the new table and retires the old one; once it then sees readers_ at 0, no caller
+    // can still be using a retired table (any later one loads the new table), so all are freed.
+    std::atomic<const AuthorityTable*> table_{nullptr};
+    mutable std::atomic<uint32_t> readers_{0};
+    std::unique_ptr<AuthorityTable> current_;              // guarded by mu_
+    std::vector<std::unique_ptr<AuthorityTable>> retired_; // guarded by mu_
+};
+
+} // namespace arcraven::ugv
@@ -0,0 +1,86 @@
+#include "command/CommandExecutor.hpp"
+
+#include <chrono>
+
+namespace arcraven::ugv {
+
+CommandExecutor::CommandExecutor(CommandExecutorConfig cfg) : cfg_(cfg) {
+    reports_.reserve(kDomains * 2);
+}
+
+CommandResult CommandExecutor::start(const CommandEnvelope& cmd, std::unique_ptr<CommandTask> task) {
+    const auto domain = static_cast<size_t>(cmd.domain);
+    if (domain >= kDomains || !task) {
+        return {arcraven::ugv::CommandStatus::Rejected, arcraven::ugv::RejectReason::InvalidPayload, "invalid domain"};
+    }
+
+    Slot& s = slots_[domain];
+    if (s.task) {
+        cancel(s, arcraven::ugv::CommandStatus::Preempted, "superseded by " + std::to_string(cmd.command_id));
+    }
+    s.task = std::move(task);
+    s.command_id = cmd.command_id;
+    s.origin = cmd.origin;
+    s.last_progress_ns = 0;
+    ++active_;
+    return {arcraven::ugv::CommandStatus::Running, arcraven::ugv::RejectReason::None, "started"};
+}
+
+void CommandExecutor::abort_all(arcraven::ugv::CommandStatus status, const std::string& why) {
+    for (Slot& s : slots_) {
+        if (s.task) cancel(s, status, why);
+    }
+}
+
+void CommandExecutor::abort_origin(CommandOrigin origin, arcraven::ugv::CommandStatus status, const std::string& why) {
+    for (Slot& s : slots_) {
+        if (s.task && s.origin == origin) cancel(s, status, why);
+    }
+}
+
+void CommandExecutor::cancel(Slot& s, arcraven::ugv::CommandStatus status, std::string message) {
+    s.task->cancel(status);
+    reports_.push_back({s.command_id, s.origin, {status, arcraven::ugv::RejectReason::None, std::move(message)}});
+    s.task.reset();
+    --active_;
+}
+
+void CommandExecutor::step_tasks(uint64_t now_ns) {
+    if (active_ == 0) return;
+
+    const auto deadline = SteadyClock::now() + std::chrono::nanoseconds(cfg_.tick_budget_ns);
+    size_t stepped = 0;
+    for (size_t i = 0; i < kDomains; ++i) {
+        const size_t idx = (cursor_ + i) % kDomains;
+        Slot& s = slots_[idx];
+        if (!s.task) continue;
+
+        if (stepped > 0 && SteadyClock::now() >= deadline) {
+            // Out of budget: resume from this task next tick.
+            cursor_ = idx;
+            return;
+        }
+        ++stepped;
+
+        CommandResult r = s.task->step(now_ns);
+        if (r.status == arcraven::ugv::CommandStatus::Running) {
+            if (s.last_progress_ns == 0) {
+                s.last_progress_ns = now_ns; // the start ack already said Running
+            } else if (now_ns - s.last_progress_ns >= cfg_.progress_interval_ns) {
+                s.last_progress_ns = now_ns;
+                reports_.push_back({s.command_id, s.origin, std::move(r)});
+            }
+            continue;
+        }
+
+        if (r.status == arcraven::ugv::CommandStatus::None) {
+            r.status = arcraven::ugv::CommandStatus::Succeeded;
+        }
+        reports_.push_back({s.command_id, s.origin, std::move(r)});
+        s.task.reset();
+        --active_;
+    }
+    cursor_ = (cursor_ + 1) % kDomains;
+}
+
+} // namespace arcraven::ugv
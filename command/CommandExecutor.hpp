@@ -0,0 +1,94 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "command/CommandTypes.hpp"
+
+namespace arcraven::ugv {
+
+// A long-running command (FollowPath, Dock, ScanArea, SelfCheck, ...) split into bounded slices.
+class CommandTask {
+public:
+    virtual ~CommandTask() = default;
+
+    // Does one slice of work; keep it well under the executor's tick budget.
+    // Returning Running keeps the task scheduled (message = progress text), any other status
+    // finishes it (None is reported as Succeeded).
+    virtual CommandResult step(uint64_t now_ns) = 0;
+
+    // Called instead of further steps when the task is preempted or aborted. Must not block.
+    virtual void cancel(arcraven::ugv::CommandStatus status) { (void)status; }
+};
+
+struct CommandExecutorConfig {
+    // Wall-clock budget for stepping tasks per tick. At least one task is stepped per tick;
+    // tasks that did not fit get the first turns on the next tick.
+    uint64_t tick_budget_ns = 1'000'000;
+
+    // Minimum spacing of Running progress reports per task.
+    uint64_t progress_interval_ns = 100'000'000;
+};
+
+// Runs long-running commands incrementally on the control thread, one task per CommandDomain.
+// Handlers hand their task over with start() and return its ack, so the handler itself stays
+// O(1) and the 200 Hz loop is never blocked by a command body.
+// Not thread-safe: call everything from the thread that runs CommandRouter::process_one.
+class CommandExecutor final {
+public:
+    static constexpr size_t kDomains = 8;
+
+    explicit CommandExecutor(CommandExecutorConfig cfg = {});
+
+    // Takes over task for cmd and returns the ack for the handler to return: Running, or
+    // Rejected/InvalidPayload for an unknown domain. A task already running in cmd's domain is
+    // cancelled and reported Preempted.
+    CommandResult start(const CommandEnvelope& cmd, std::unique_ptr<CommandTask> task);
+
+    // Cancels every running task (Stop, E-STOP) and reports it with status.
+    void abort_all(arcraven::ugv::CommandStatus status, const std::string& why);
+    // Same, for the tasks started by commands of one origin only (AbortMission and a replaced
+    // mission cancel the mission's step task and leave directly commanded tasks running).
+    void abort_origin(CommandOrigin origin, arcraven::ugv::CommandStatus status, const std::string& why);
+
+    // Steps running tasks within the tick budget, then hands every report produced since the
+    // last tick (progress, final results, preemptions/aborts) to
+    // on_result(command_id, origin, result), origin being that of the command that started the task.
+    template <typename Fn>
+    void tick(uint64_t now_ns, Fn&& on_result) {
+        step_tasks(now_ns);
+        for (const auto& r : reports_) on_result(r.command_id, r.origin, r.result);
+        reports_.clear();
+    }
+
+    size_t active() const { return active_; }
+
+private:
+    struct Slot {
+        std::unique_ptr<CommandTask> task;
+        uint64_t command_id = 0;
+        CommandOrigin origin = CommandOrigin::Client;
+        uint64_t last_progress_ns = 0; // 0 = not stepped yet
+    };
+
+    struct Report {
+        uint64_t command_id = 0;
+        CommandOrigin origin = CommandOrigin::Client;
+        CommandResult result;
+    };
+
+    void step_tasks(uint64_t now_ns);
+    void cancel(Slot& s, arcraven::ugv::CommandStatus status, std::string message);
+
+    CommandExecutorConfig cfg_;
+    std::array<Slot, kDomains> slots_{};
+    size_t cursor_ = 0;
+    size_t active_ = 0;
+    std::vector<Report> reports_;
+};
+
+} // namespace arcraven::ugv
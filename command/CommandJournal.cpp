@@ -0,0 +1,290 @@
+#include "command/CommandJournal.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <system_error>
+#include <variant>
+
+#include "core/StateStore.hpp"
+#include "utils/Logger.hpp"
+
+namespace arcraven::ugv {
+
+namespace {
+
+constexpr size_t kMaxMessageBytes = 1024;
+constexpr size_t kMaxRecordBytes = sizeof(JournalRecordHeader) + CommandPayload::kMaxSize + kMaxMessageBytes + 8;
+
+size_t padded_record_size(size_t payload, size_t message) {
+    return (sizeof(JournalRecordHeader) + payload + message + 7u) & ~size_t{7};
+}
+
+// CRC of a whole record image whose crc32 field is zero.
+uint32_t record_crc(const char* record, size_t size) {
+    return crc32_ieee(reinterpret_cast<const uint8_t*>(record), size);
+}
+
+void fill_result(JournalRecordHeader& hdr, const CommandResult& result, uint64_t now_ns) {
+    hdr.status = static_cast<uint8_t>(result.status);
+    hdr.reject_reason = static_cast<uint8_t>(result.reject_reason);
+    hdr.recorded_ns = now_ns;
+}
+
+// Byte offset just past the last intact record of an existing journal (0 if the header is bad).
+uint64_t valid_prefix(const std::filesystem::path& path) {
+    CommandJournalReader reader;
+    if (!reader.open(path)) return 0;
+    uint64_t end = sizeof(JournalFileHeader);
+    JournalRecord rec;
+    while (reader.next(rec)) end += rec.header.record_size;
+    return end;
+}
+
+} // namespace
+
+CommandJournal::CommandJournal(CommandJournalConfig cfg) : cfg_(cfg) {
+    size_t cap = 1;
+    while (cap < std::max(cfg_.buffer_bytes, 2 * kMaxRecordBytes)) cap <<= 1u;
+    capacity_ = cap;
+    ring_ = std::make_unique<char[]>(capacity_);
+}
+
+CommandJournal::~CommandJournal() {
+    close();
+}
+
+bool CommandJournal::open(const std::filesystem::path& path) {
+    if (running_.load(std::memory_order_acquire)) return true;
+
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+
+    const uint64_t size = std::filesystem::exists(path, ec) ? std::filesystem::file_size(path, ec) : 0;
+    if (size > 0) {
+        const uint64_t keep = valid_prefix(path);
+        if (keep == 0) {
+            ARC_LOG_WARN("CommandJournal: unreadable journal moved to " + path.string() + ".corrupt");
+            std::filesystem::rename(path, path.string() + ".corrupt", ec);
+        } else if (keep < size) {
+            ARC_LOG_WARN("CommandJournal: dropping torn tail (" + std::to_string(size - keep) + " bytes)");
+            std::filesystem::resize_file(path, keep, ec);
+        }
+    }
+
+    out_.open(path, std::ios::binary | std::ios::app);
+    if (!out_.good()) {
+        ARC_LOG_ERROR("CommandJournal: cannot open " + path.string());
+        return false;
+    }
+    if (!std::filesystem::exists(path, ec) || std::filesystem::file_size(path, ec) == 0) {
+        JournalFileHeader hdr{};
+        hdr.record_header_size = sizeof(JournalRecordHeader);
+        out_.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+        out_.flush();
+    }
+
+    staging_.reserve(capacity_);
+    running_.store(true, std::memory_order_release);
+    writer_ = std::thread(&CommandJournal::writer_loop, this);
+    return true;
+}
+
+void CommandJournal::close() {
+    if (!writer_.joinable()) return;
+    running_.store(false, std::memory_order_release);
+    writer_.join();
+    out_.close();
+}
+
+bool CommandJournal::append(const CommandEnvelope& cmd, const CommandResult& result, uint64_t now_ns) {
+    JournalRecordHeader hdr{};
+    hdr.kind = JournalRecordKind::Dispatched;
+    hdr.command = static_cast<uint16_t>(cmd.command);
+    hdr.command_id = cmd.command_id;
+    hdr.issued_ns = cmd.issued_ns;
+    hdr.ttl_ns = cmd.ttl_ns;
+    hdr.rx_ns = cmd.stamps.rx_ns;
+    hdr.enqueue_ns = cmd.stamps.enqueue_ns;
+    hdr.dispatch_ns = cmd.stamps.dispatch_ns;
+    hdr.done_ns = cmd.stamps.done_ns;
+    hdr.domain = static_cast<uint8_t>(cmd.domain);
+    hdr.priority = static_cast<uint8_t>(cmd.priority);
+    hdr.authority = static_cast<uint8_t>(cmd.authority);
+    fill_result(hdr, result, now_ns);
+    if (const auto* path = std::get_if<FollowPathPayload>(&cmd.typed); path && cmd.payload_json.empty()) {
+        hdr.payload_format = JournalPayloadFormat::PathPoints;
+        return push(hdr, path->points.view(), result.message);
+    }
+    return push(hdr, cmd.payload_json.view(), result.message);
+}
+
+bool CommandJournal::append_result(uint64_t command_id, const CommandResult& result, uint64_t now_ns) {
+    JournalRecordHeader hdr{};
+    hdr.kind = JournalRecordKind::TaskReport;
+    hdr.command_id = command_id;
+    fill_result(hdr, result, now_ns);
+    return push(hdr, {}, result.message);
+}
+
+bool CommandJournal::push(const JournalRecordHeader& proto, std::string_view payload, std::string_view message) {
+    if (!running_.load(std::memory_order_relaxed)) return false;
+
+    message = message.substr(0, kMaxMessageBytes);
+    const size_t size = padded_record_size(payload.size(), message.size());
+
+    const uint64_t head = head_.load(std::memory_order_relaxed);
+    const uint64_t tail = tail_.load(std::memory_order_acquire);
+    if (capacity_ - (head - tail) < size) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    JournalRecordHeader hdr = proto;
+    hdr.record_size = static_cast<uint32_t>(size);
+    hdr.payload_size = static_cast<uint32_t>(payload.size());
+    hdr.message_size = static_cast<uint32_t>(message.size());
+
+    static constexpr char kZeros[8] = {};
+    uint64_t pos = head;
+    copy_in(pos, &hdr, sizeof(hdr));
+    pos += sizeof(hdr);
+    copy_in(pos, payload.data(), payload.size());
+    pos += payload.size();
+    copy_in(pos, message.data(), message.size());
+    pos += message.size();
+    copy_in(pos, kZeros, head + size - pos);
+
+    head_.store(head + size, std::memory_order_release);
+    return true;
+}
+
+void CommandJournal::copy_in(uint64_t pos, const void* src, size_t n) {
+    if (n == 0) return;
+    const size_t at = static_cast<size_t>(pos & (capacity_ - 1));
+    const size_t first = std::min(n, capacity_ - at);
+    std::memcpy(ring_.get() + at, src, first);
+    std::memcpy(ring_.get(), static_cast<const char*>(src) + first, n - first);
+}
+
+void CommandJournal::copy_out(uint64_t pos, void* dst, size_t n) const {
+    const size_t at = static_cast<size_t>(pos & (capacity_ - 1));
+    const size_t first = std::min(n, capacity_ - at);
+    std::memcpy(dst, ring_.get() + at, first);
+    std::memcpy(static_cast<char*>(dst) + first, ring_.get(), n - first);
+}
+
+size_t CommandJournal::drain() {
+    const uint64_t tail = tail_.load(std::memory_order_relaxed);
+    const uint64_t head = head_.load(std::memory_order_acquire);
+    const auto n = static_cast<size_t>(head - tail);
+    if (n == 0) return 0;
+
+    // Every published record is complete, so the batch is a whole number of records.
+    staging_.resize(n);
+    copy_out(tail, staging_.data(), n);
+
+    size_t records = 0;
+    for (size_t off = 0; off < n; ++records) {
+        JournalRecordHeader hdr{};
+        std::memcpy(&hdr, staging_.data() + off, sizeof(hdr));
+        hdr.crc32 = record_crc(staging_.data() + off, hdr.record_size);
+        std::memcpy(staging_.data() + off + offsetof(JournalRecordHeader, crc32), &hdr.crc32, sizeof(hdr.crc32));
+        off += hdr.record_size;
+    }
+
+    out_.write(staging_.data(), static_cast<std::streamsize>(n));
+    out_.flush();
+    if (!out_.good()) {
+        ARC_LOG_ERROR("CommandJournal: write failed; " + std::to_string(records) + " records lost");
+        out_.clear();
+        dropped_.fetch_add(records, std::memory_order_relaxed);
+    } else {
+        written_.fetch_add(records, std::memory_order_relaxed);
+    }
+
+    tail_.store(head, std::memory_order_release);
+    return records;
+}
+
+void CommandJournal::writer_loop() {
+    while (running_.load(std::memory_order_acquire)) {
+        if (drain() == 0) std::this_thread::sleep_for(cfg_.flush_interval);
+    }
+    // The producer is done (close() is called after the control thread stops): final drain.
+    (void)drain();
+}
+
+CommandResult JournalRecord::result() const {
+    return {static_cast<arcraven::ugv::CommandStatus>(header.status),
+            static_cast<arcraven::ugv::RejectReason>(header.reject_reason), message};
+}
+
+CommandEnvelope JournalRecord::envelope() const {
+    CommandEnvelope env{};
+    env.command = static_cast<arcraven::ugv::UgvCommand>(header.command);
+    env.domain = static_cast<arcraven::ugv::CommandDomain>(header.domain);
+    env.priority = static_cast<arcraven::ugv::CommandPriority>(header.priority);
+    env.authority = static_cast<arcraven::ugv::CommandAuthority>(header.authority);
+    env.command_id = header.command_id;
+    env.issued_ns = header.issued_ns;
+    env.ttl_ns = header.ttl_ns;
+    if (header.payload_format == JournalPayloadFormat::PathPoints) {
+        FollowPathPayload path;
+        (void)path.points.assign(payload);
+        env.typed = std::move(path);
+    } else {
+        (void)env.payload_json.assign(payload);
+    }
+    env.stamps = {header.rx_ns, header.enqueue_ns, header.dispatch_ns, header.done_ns};
+    return env;
+}
+
+bool CommandJournalReader::open(const std::filesystem::path& path) {
+    in_.open(path, std::ios::binary);
+    if (!in_.good()) return false;
+
+    JournalFileHeader hdr{};
+    in_.read(reinterpret_cast<char*>(&hdr), sizeof(hdr));
+    if (!in_.good() || hdr.magic != kJournalFileMagic || hdr.version != kJournalVersion ||
+        hdr.record_header_size != sizeof(JournalRecordHeader)) {
+        in_.close();
+        return false;
+    }
+    corrupt_ = false;
+    return true;
+}
+
+bool CommandJournalReader::next(JournalRecord& out) {
+    if (!in_.is_open() || corrupt_) return false;
+
+    JournalRecordHeader hdr{};
+    in_.read(reinterpret_cast<char*>(&hdr), sizeof(hdr));
+    if (in_.gcount() == 0 && in_.eof()) return false; // clean end
+    if (in_.gcount() != static_cast<std::streamsize>(sizeof(hdr)) || hdr.magic != kJournalRecordMagic ||
+        hdr.payload_size > CommandPayload::kMaxSize || hdr.message_size > kMaxMessageBytes ||
+        hdr.record_size != padded_record_size(hdr.payload_size, hdr.message_size)) {
+        corrupt_ = true;
+        return false;
+    }
+
+    std::vector<char> image(hdr.record_size);
+    const uint32_t crc = hdr.crc32;
+    hdr.crc32 = 0;
+    std::memcpy(image.data(), &hdr, sizeof(hdr));
+    const auto rest = static_cast<std::streamsize>(hdr.record_size - sizeof(hdr));
+    in_.read(image.data() + sizeof(hdr), rest);
+    if (in_.gcount() != rest || record_crc(image.data(), image.size()) != crc) {
+        corrupt_ = true;
+        return false;
+    }
+
+    hdr.crc32 = crc;
+    out.header = hdr;
+    const char* body = image.data() + sizeof(hdr);
+    out.payload.assign(body, hdr.payload_size);
+    out.message.assign(body + hdr.payload_size, hdr.message_size);
+    return true;
+}
+
+} // namespace arcraven::ugv
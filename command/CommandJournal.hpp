@@ -0,0 +1,160 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "command/CommandTypes.hpp"
+
+namespace arcraven::ugv {
+
+// On-disk layout (native endianness, little-endian on every supported target):
+//   JournalFileHeader, then records back to back. Each record is a fixed JournalRecordHeader
+//   followed by payload_size payload bytes and message_size result-message bytes, zero-padded
+//   to a multiple of 8. crc32 (IEEE) covers the whole record with the crc32 field zeroed.
+// A torn or corrupt tail (crash mid-write) ends the readable journal; nothing before it is lost.
+inline constexpr uint32_t kJournalFileMagic = 0x4C4A5241u;   // 'ARJL'
+inline constexpr uint32_t kJournalRecordMagic = 0x43524A41u; // 'AJRC'
+inline constexpr uint32_t kJournalVersion = 1;
+
+// How the payload bytes of a Dispatched record are encoded.
+enum class JournalPayloadFormat : uint8_t {
+    WireText = 0,   // the raw wire payload
+    PathPoints = 1, // FollowPath only: packed Point2D waypoints (the wire text is dropped at ingress)
+};
+
+enum class JournalRecordKind : uint16_t {
+    Dispatched = 1, // router outcome: full envelope + result (executed, expired, preempted, ...)
+    TaskReport = 2, // progress/final report of a long-running command; only command_id is set
+};
+
+struct JournalFileHeader {
+    uint32_t magic = kJournalFileMagic;
+    uint32_t version = kJournalVersion;
+    uint32_t record_header_size = 0;
+    uint32_t reserved = 0;
+};
+
+struct JournalRecordHeader {
+    uint32_t magic = kJournalRecordMagic;
+    uint32_t crc32 = 0;
+    uint32_t record_size = 0; // header + payload + message + padding
+    JournalRecordKind kind = JournalRecordKind::Dispatched;
+    uint16_t command = 0;
+
+    uint64_t command_id = 0;
+    uint64_t issued_ns = 0;
+    uint64_t ttl_ns = 0;
+    uint64_t rx_ns = 0;
+    uint64_t enqueue_ns = 0;
+    uint64_t dispatch_ns = 0;
+    uint64_t done_ns = 0;
+    uint64_t recorded_ns = 0;
+
+    uint8_t domain = 0;
+    uint8_t priority = 0;
+    uint8_t authority = 0;
+    uint8_t status = 0;
+    uint8_t reject_reason = 0;
+    JournalPayloadFormat payload_format = JournalPayloadFormat::WireText;
+    uint8_t reserved[2] = {};
+
+    uint32_t payload_size = 0;
+    uint32_t message_size = 0;
+};
+
+static_assert(sizeof(JournalRecordHeader) == 96, "journal record header layout is part of the file format");
+static_assert(sizeof(JournalFileHeader) == 16, "journal file header layout is part of the file format");
+
+struct CommandJournalConfig {
+    // Preallocated record buffer between the control thread and the writer. A record that does
+    // not fit is dropped (and counted) rather than stalling the control loop.
+    size_t buffer_bytes = 1u << 20;
+    // Writer wake-up period when the buffer is empty; bounds how stale the file can be.
+    std::chrono::milliseconds flush_interval{20};
+};
+
+// Append-only binary journal of executed commands.
+//
+// append()/append_result() copy the record into a preallocated single-producer byte ring and
+// return; they never block, allocate or touch the file. A dedicated writer thread drains the
+// ring in batches, fills in the CRCs and appends each batch with one write + flush.
+// Both appends must come from the same thread (the control thread).
+class CommandJournal final {
+public:
+    explicit CommandJournal(CommandJournalConfig cfg = {});
+    ~CommandJournal();
+
+    CommandJournal(const CommandJournal&) = delete;
+    CommandJournal& operator=(const CommandJournal&) = delete;
+
+    // Opens (appending) or creates the journal and starts the writer thread. An existing file
+    // with a foreign header is moved aside to <path>.corrupt.
+    bool open(const std::filesystem::path& path);
+    // Drains everything appended so far, then stops the writer.
+    void close();
+    bool is_open() const { return running_.load(std::memory_order_acquire); }
+
+    bool append(const CommandEnvelope& cmd, const CommandResult& result, uint64_t now_ns);
+    bool append_result(uint64_t command_id, const CommandResult& result, uint64_t now_ns);
+
+    uint64_t written() const { return written_.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    bool push(const JournalRecordHeader& hdr, std::string_view payload, std::string_view message);
+    void copy_in(uint64_t pos, const void* src, size_t n);
+    void copy_out(uint64_t pos, void* dst, size_t n) const;
+    size_t drain();
+    void writer_loop();
+
+    CommandJournalConfig cfg_;
+    std::unique_ptr<char[]> ring_;
+    size_t capacity_ = 0;
+
+    alignas(64) std::atomic<uint64_t> head_{0}; // producer
+    alignas(64) std::atomic<uint64_t> tail_{0}; // writer
+
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> dropped_{0};
+
+    // Writer-private.
+    std::ofstream out_;
+    std::vector<char> staging_;
+    std::thread writer_;
+};
+
+// A decoded journal record, as returned by CommandJournalReader.
+struct JournalRecord {
+    JournalRecordHeader header;
+    std::string payload;
+    std::string message;
+
+    CommandResult result() const;
+    // Rebuilds the envelope. Only meaningful for Dispatched records. The typed payload is left
+    // to the caller, except for PathPoints records, which carry nothing else.
+    CommandEnvelope envelope() const;
+};
+
+// Sequential reader for offline tools (ugv_replay). Stops at the first torn or corrupt record.
+class CommandJournalReader final {
+public:
+    bool open(const std::filesystem::path& path);
+    bool next(JournalRecord& out);
+
+    // True when next() stopped on a bad record rather than a clean end of file.
+    bool corrupt() const { return corrupt_; }
+
+private:
+    std::ifstream in_;
+    bool corrupt_ = false;
+};
+
+} // namespace arcraven::ugv
@@ -0,0 +1,108 @@
+#include "command/CommandLatency.hpp"
+
+#include <cstdio>
+
+#include "command/CommandRegistry.hpp"
+
+namespace arcraven::ugv {
+
+namespace {
+
+constexpr std::array<const char*, kLatencyStages> kStageNames = {
+    "wire", "ingress", "queue", "execute", "publish", "total",
+};
+
+// Inverse of command_slot(), as a printable name.
+std::string slot_name(size_t slot) {
+    const auto id = static_cast<uint16_t>((slot / kCommandGroupStride + 1) * 100 + slot % kCommandGroupStride);
+    return std::string(command_name(static_cast<arcraven::ugv::UgvCommand>(id)));
+}
+
+double to_us(uint64_t ns) {
+    return static_cast<double>(ns) / 1000.0;
+}
+
+void add_span(LatencyHistogram& h, uint64_t from, uint64_t to) {
+    if (from != 0 && to >= from) h.record(to - from);
+}
+
+} // namespace
+
+CommandLatencyStats::~CommandLatencyStats() {
+    for (auto& s : slots_) delete s.load(std::memory_order_acquire);
+}
+
+CommandLatencyStats::PerCommand* CommandLatencyStats::slot(size_t idx) {
+    PerCommand* p = slots_[idx].load(std::memory_order_acquire);
+    if (p) return p;
+
+    // First sample for this command type; a losing racer frees its copy.
+    auto* fresh = new PerCommand();
+    if (slots_[idx].compare_exchange_strong(p, fresh, std::memory_order_acq_rel)) return fresh;
+    delete fresh;
+    return p;
+}
+
+void CommandLatencyStats::record(const CommandEnvelope& cmd) {
+    const size_t idx = command_slot(cmd.command);
+    if (idx >= kHandlerSlots) return;
+
+    auto& h = slot(idx)->stages;
+    const CommandStamps& s = cmd.stamps;
+    if (cmd.issued_ns != 0 && s.rx_ns != 0) {
+        add_span(h[static_cast<size_t>(LatencyStage::Wire)], cmd.issued_ns, s.rx_ns);
+    }
+    add_span(h[static_cast<size_t>(LatencyStage::Ingress)], s.rx_ns, s.enqueue_ns);
+    add_span(h[static_cast<size_t>(LatencyStage::Queue)], s.enqueue_ns, s.dispatch_ns);
+    add_span(h[static_cast<size_t>(LatencyStage::Execute)], s.dispatch_ns, s.done_ns);
+}
+
+void CommandLatencyStats::record_ack(const AckTiming& ack, uint64_t written_ns) {
+    const size_t idx = command_slot(ack.command);
+    if (idx >= kHandlerSlots) return;
+
+    auto& h = slot(idx)->stages;
+    add_span(h[static_cast<size_t>(LatencyStage::Publish)], ack.done_ns, written_ns);
+    add_span(h[static_cast<size_t>(LatencyStage::Total)], ack.rx_ns, written_ns);
+}
+
+std::string CommandLatencyStats::report() const {
+    std::string out = "command            stage       count      p50_us      p90_us      p99_us    p99.9_us      max_us\n";
+    char line[160];
+    for (size_t i = 0; i < kHandlerSlots; ++i) {
+        const PerCommand* p = slots_[i].load(std::memory_order_acquire);
+        if (!p) continue;
+        for (size_t st = 0; st < kLatencyStages; ++st) {
+            const LatencyHistogram& h = p->stages[st];
+            if (h.count() == 0) continue;
+            std::snprintf(line, sizeof(line), "%-17s  %-8s %8llu %11.1f %11.1f %11.1f %11.1f %11.1f\n",
+                          slot_name(i).c_str(), kStageNames[st], static_cast<unsigned long long>(h.count()),
+                          to_us(h.quantile(0.5)), to_us(h.quantile(0.9)), to_us(h.quantile(0.99)),
+                          to_us(h.quantile(0.999)), to_us(h.max()));
+            out += line;
+        }
+    }
+    return out;
+}
+
+std::string CommandLatencyStats::summary() const {
+    std::string out;
+    char line[200];
+    for (size_t i = 0; i < kHandlerSlots; ++i) {
+        const PerCommand* p = slots_[i].load(std::memory_order_acquire);
+        if (!p) continue;
+        const auto& queue = p->stages[static_cast<size_t>(LatencyStage::Queue)];
+        const auto& exec = p->stages[static_cast<size_t>(LatencyStage::Execute)];
+        const auto& total = p->stages[static_cast<size_t>(LatencyStage::Total)];
+        std::snprintf(line, sizeof(line),
+                      "%s n=%llu queue p50/p99=%.1f/%.1fus exec p50/p99=%.1f/%.1fus total p50/p99=%.1f/%.1fus\n",
+                      slot_name(i).c_str(), static_cast<unsigned long long>(total.count()),
+                      to_us(queue.quantile(0.5)), to_us(queue.quantile(0.99)),
+                      to_us(exec.quantile(0.5)), to_us(exec.quantile(0.99)),
+                      to_us(total.quantile(0.5)), to_us(total.quantile(0.99)));
+        out += line;
+    }
+    return out;
+}
+
+} // namespace arcraven::ugv
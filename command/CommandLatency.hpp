@@ -0,0 +1,68 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "command/HandlerTable.hpp"
+#include "core/LatencyHistogram.hpp"
+
+namespace arcraven::ugv {
+
+// Segments of a command's path from the client to its ack, from CommandStamps.
+enum class LatencyStage : uint8_t {
+    Wire = 0,    // issued_ns -> parsed (client and core share CLOCK_MONOTONIC on one host)
+    Ingress,     // parsed -> enqueued
+    Queue,       // enqueued -> dispatched
+    Execute,     // dispatched -> handler returned
+    Publish,     // handler returned -> ack written (recorded by the link, see AckTiming)
+    Total,       // parsed -> ack written
+};
+
+inline constexpr size_t kLatencyStages = static_cast<size_t>(LatencyStage::Total) + 1;
+
+// What a link needs to time a dispatched command's ack once it has actually written it.
+// Default (command 0) for acks that are not timed, e.g. task reports.
+struct AckTiming {
+    arcraven::ugv::UgvCommand command{};
+    uint64_t rx_ns = 0;
+    uint64_t done_ns = 0;
+};
+
+inline AckTiming ack_timing(const CommandEnvelope& cmd) {
+    return {cmd.command, cmd.stamps.rx_ns, cmd.stamps.done_ns};
+}
+
+// Per-UgvCommand latency histograms. Storage for a command type is allocated the first time it
+// is recorded; after that record() is lock-free. Safe to read (report/summary) from any thread.
+class CommandLatencyStats final {
+public:
+    CommandLatencyStats() = default;
+    ~CommandLatencyStats();
+
+    CommandLatencyStats(const CommandLatencyStats&) = delete;
+    CommandLatencyStats& operator=(const CommandLatencyStats&) = delete;
+
+    // Control thread, once dispatched: every stage up to Execute whose stamps are both set.
+    void record(const CommandEnvelope& cmd);
+    // Link, once the ack is written (written_ns): Publish and Total. Any thread.
+    void record_ack(const AckTiming& ack, uint64_t written_ns);
+
+    // Full table: one row per command type and stage (count, p50/p90/p99/p99.9/max in us).
+    std::string report() const;
+
+    // One line per command type: count and p50/p99 of queue, execute and total.
+    std::string summary() const;
+
+private:
+    struct PerCommand {
+        std::array<LatencyHistogram, kLatencyStages> stages;
+    };
+
+    PerCommand* slot(size_t idx);
+
+    std::array<std::atomic<PerCommand*>, kHandlerSlots> slots_{};
+};
+
+} // namespace arcraven::ugv
@@ -0,0 +1,133 @@
+#include "command/CommandPayload.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace arcraven::ugv {
+
+// -------------------------
+// PayloadSlab
+// -------------------------
+PayloadSlab& PayloadSlab::instance() {
+    static PayloadSlab slab;
+    return slab;
+}
+
+PayloadSlab::PayloadSlab() {
+    reserve(kInitialBlocks);
+}
+
+void PayloadSlab::reserve(size_t blocks) {
+    std::lock_guard<std::mutex> lk(grow_mu_);
+    uint32_t first = blocks_.load(std::memory_order_relaxed);
+    while (first < std::min<size_t>(blocks, kMaxBlocks)) {
+        auto& chunk = chunks_[first / kChunkBlocks];
+        chunk = std::make_unique<Chunk>();
+        const uint32_t last = first + kChunkBlocks - 1;
+        for (uint32_t i = first; i < last; ++i) next(i).store(i + 1, std::memory_order_relaxed);
+        blocks_.store(last + 1, std::memory_order_release);
+
+        // Splice the chunk's blocks onto the free list, as release() does for one block.
+        uint64_t head = head_.load(std::memory_order_acquire);
+        for (;;) {
+            next(last).store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+            const uint64_t tag = (head >> 32u) + 1;
+            if (head_.compare_exchange_weak(head, (tag << 32u) | first, std::memory_order_acq_rel,
+                                            std::memory_order_acquire)) {
+                break;
+            }
+        }
+        first = last + 1;
+    }
+}
+
+uint32_t PayloadSlab::acquire() {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    for (;;) {
+        const auto idx = static_cast<uint32_t>(head);
+        if (idx == kNoBlock) return kNoBlock;
+        const uint64_t tag = (head >> 32u) + 1;
+        const uint64_t after = (tag << 32u) | next(idx).load(std::memory_order_relaxed);
+        if (head_.compare_exchange_weak(head, after, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            return idx;
+        }
+    }
+}
+
+void PayloadSlab::release(uint32_t block) {
+    if (block >= capacity()) return;
+    uint64_t head = head_.load(std::memory_order_acquire);
+    for (;;) {
+        next(block).store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+        const uint64_t tag = (head >> 32u) + 1;
+        if (head_.compare_exchange_weak(head, (tag << 32u) | block, std::memory_order_acq_rel,
+                                        std::memory_order_acquire)) {
+            return;
+        }
+    }
+}
+
+// -------------------------
+// CommandPayload
+// -------------------------
+CommandPayload::~CommandPayload() {
+    clear();
+}
+
+CommandPayload::CommandPayload(CommandPayload&& other) noexcept {
+    *this = std::move(other);
+}
+
+CommandPayload& CommandPayload::operator=(CommandPayload&& other) noexcept {
+    if (this == &other) return *this;
+    clear();
+    size_ = other.size_;
+    block_ = other.block_;
+    if (block_ == PayloadSlab::kNoBlock) {
+        std::memcpy(inline_.data(), other.inline_.data(), size_);
+    }
+    other.size_ = 0;
+    other.block_ = PayloadSlab::kNoBlock;
+    return *this;
+}
+
+char* CommandPayload::prepare(size_t n) {
+    if (n <= kInlineCapacity) {
+        if (block_ != PayloadSlab::kNoBlock) {
+            PayloadSlab::instance().release(block_);
+            block_ = PayloadSlab::kNoBlock;
+        }
+        size_ = static_cast<uint32_t>(n);
+        return inline_.data();
+    }
+    if (n > kMaxSize) return nullptr;
+
+    if (block_ == PayloadSlab::kNoBlock) {
+        block_ = PayloadSlab::instance().acquire();
+        if (block_ == PayloadSlab::kNoBlock) return nullptr;
+    }
+    size_ = static_cast<uint32_t>(n);
+    return PayloadSlab::instance().data(block_);
+}
+
+bool CommandPayload::assign(std::string_view bytes) {
+    char* out = prepare(bytes.size());
+    if (!out) return false;
+    if (!bytes.empty()) std::memcpy(out, bytes.data(), bytes.size());
+    return true;
+}
+
+void CommandPayload::clear() {
+    if (block_ != PayloadSlab::kNoBlock) {
+        PayloadSlab::instance().release(block_);
+        block_ = PayloadSlab::kNoBlock;
+    }
+    size_ = 0;
+}
+
+const char* CommandPayload::data() const {
+    return block_ == PayloadSlab::kNoBlock ? inline_.data() : PayloadSlab::instance().data(block_);
+}
+
+} // namespace arcraven::ugv
@@ -0,0 +1,94 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+
+namespace arcraven::ugv {
+
+// Process-wide pool of fixed-size payload blocks for commands that do not fit inline
+// (e.g. FollowPath waypoint lists). Grown in chunks by reserve() (each CommandRouter reserves
+// for its queue capacity); acquire/release are lock-free and blocks never move.
+class PayloadSlab final {
+public:
+    static constexpr size_t kBlockSize = 4096;
+    static constexpr uint32_t kChunkBlocks = 64;
+    static constexpr uint32_t kMaxBlocks = 64 * 1024;
+    // Available before any reserve(), for payloads built outside a router (missions, tools).
+    static constexpr uint32_t kInitialBlocks = 256;
+    static constexpr uint32_t kNoBlock = UINT32_MAX;
+
+    static PayloadSlab& instance();
+
+    // Grows the pool to at least `blocks` (whole chunks, at most kMaxBlocks). Never shrinks.
+    // Allocates; safe to call while other threads acquire and release blocks.
+    void reserve(size_t blocks);
+    uint32_t capacity() const { return blocks_.load(std::memory_order_acquire); }
+
+    uint32_t acquire();
+    void release(uint32_t block);
+    char* data(uint32_t block) { return chunks_[block / kChunkBlocks]->data + (block % kChunkBlocks) * kBlockSize; }
+    const char* data(uint32_t block) const {
+        return chunks_[block / kChunkBlocks]->data + (block % kChunkBlocks) * kBlockSize;
+    }
+
+private:
+    struct Chunk {
+        char data[kChunkBlocks * kBlockSize];
+        std::atomic<uint32_t> next[kChunkBlocks];
+    };
+
+    PayloadSlab();
+
+    std::atomic<uint32_t>& next(uint32_t block) { return chunks_[block / kChunkBlocks]->next[block % kChunkBlocks]; }
+
+    std::mutex grow_mu_;
+    // Only reserve() writes an entry, before any of its blocks is on the free list.
+    std::array<std::unique_ptr<Chunk>, kMaxBlocks / kChunkBlocks> chunks_;
+    std::atomic<uint32_t> blocks_{0};
+    std::atomic<uint64_t> head_{kNoBlock}; // (ABA tag << 32) | block index
+};
+
+// Command payload bytes with inline storage for the common small commands (Stop, SetSpeedLimit,
+// "flashlight|id|state") and a PayloadSlab block for larger ones. Never touches the heap.
+// Move-only: a copy could fail on an exhausted slab, so it has to be explicit.
+class CommandPayload final {
+public:
+    static constexpr size_t kInlineCapacity = 96;
+    static constexpr size_t kMaxSize = PayloadSlab::kBlockSize;
+
+    CommandPayload() = default;
+    ~CommandPayload();
+
+    CommandPayload(CommandPayload&& other) noexcept;
+    CommandPayload& operator=(CommandPayload&& other) noexcept;
+    CommandPayload(const CommandPayload&) = delete;
+    CommandPayload& operator=(const CommandPayload&) = delete;
+
+    // Returns a writable buffer of n bytes (contents unspecified), or nullptr if n exceeds
+    // kMaxSize or the slab is exhausted (transient: report Busy, not InvalidPayload). Use
+    // resize() afterwards to trim.
+    char* prepare(size_t n);
+    void resize(size_t n) { size_ = n <= capacity() ? static_cast<uint32_t>(n) : size_; }
+
+    bool assign(std::string_view bytes);
+    void clear();
+
+    const char* data() const;
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    size_t capacity() const { return block_ == PayloadSlab::kNoBlock ? kInlineCapacity : kMaxSize; }
+
+    std::string_view view() const { return {data(), size_}; }
+    operator std::string_view() const { return view(); }
+
+private:
+    uint32_t size_ = 0;
+    uint32_t block_ = PayloadSlab::kNoBlock;
+    std::array<char, kInlineCapacity> inline_{};
+};
+
+} // namespace arcraven::ugv
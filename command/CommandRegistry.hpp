@@ -0,0 +1,228 @@
+#pragma once
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "command/HandlerTable.hpp"
+
+namespace arcraven::ugv {
+
+// Bit (1 << CommandAuthority) set = that authority may issue the command.
+using AuthorityMask = uint8_t;
+
+constexpr AuthorityMask authority_bit(arcraven::ugv::CommandAuthority a) {
+    return static_cast<AuthorityMask>(1u << static_cast<unsigned>(a));
+}
+
+inline constexpr AuthorityMask kAnyAuthority = 0x1F;
+inline constexpr AuthorityMask kIdentifiedAuthority =
+    kAnyAuthority & static_cast<AuthorityMask>(~authority_bit(arcraven::ugv::CommandAuthority::Unknown));
+inline constexpr AuthorityMask kOperatorAuthority = authority_bit(arcraven::ugv::CommandAuthority::RemoteOperator) |
+                                                    authority_bit(arcraven::ugv::CommandAuthority::MissionControl) |
+                                                    authority_bit(arcraven::ugv::CommandAuthority::SafetySystem);
+
+struct CommandInfo {
+    arcraven::ugv::UgvCommand command;
+    std::string_view name;
+    arcraven::ugv::CommandDomain domain;
+    arcraven::ugv::CommandPriority default_priority; // Critical pins every copy to Critical; mission steps use it as is
+    AuthorityMask authorities;                       // who may issue it at all (before ownership/locks)
+    bool superseding;                                // a newer one replaces a queued one (coalescing)
+};
+
+// Single source of truth for per-command metadata. Keep in UgvCommand order; the checks below
+// fail the build on a missing, duplicated or misplaced entry.
+inline constexpr auto kCommandRegistry = std::to_array<CommandInfo>({
+    // clang-format off
+    // command                                       name                  domain                                     default priority                               authorities          superseding
+    {arcraven::ugv::UgvCommand::FollowPath,        "FollowPath",        arcraven::ugv::CommandDomain::Mobility,    arcraven::ugv::CommandPriority::Normal,     kAnyAuthority,        false},
+    {arcraven::ugv::UgvCommand::GoTo,              "GoTo",              arcraven::ugv::CommandDomain::Mobility,    arcraven::ugv::CommandPriority::Normal,     kAnyAuthority,        true},
+    {arcraven::ugv::UgvCommand::Stop,              "Stop",              arcraven::ugv::CommandDomain::Mobility,    arcraven::ugv::CommandPriority::Critical,   kAnyAuthority,        false},
+    {arcraven::ugv::UgvCommand::HoldPosition,      "HoldPosition",      arcraven::ugv::CommandDomain::Mobility,    arcraven::ugv::CommandPriority::High,       kAnyAuthority,        false},
+    {arcraven::ugv::UgvCommand::Anchor,            "Anchor",            arcraven::ugv::CommandDomain::Mobility,    arcraven::ugv::CommandPriority::High,       kAnyAuthority,        false},
+    {arcraven::ugv::UgvCommand::ReplanTo,          "ReplanTo",          arcraven::ugv::CommandDomain::Mobility,    arcraven::ugv::CommandPriority::Normal,     kAnyAuthority,        false},
+    {arcraven::ugv::UgvCommand::Loiter,            "Loiter",            arcraven::ugv::CommandDomain::Mobility,    arcraven::ugv::CommandPriority::Normal,     kAnyAuthority,        false},
+    {arcraven::ugv::UgvCommand::ReturnToBase,      "ReturnToBase",      arcraven::ugv::CommandDomain::Mobility,    arcraven::ugv::CommandPriority::Normal,     kAnyAuthority,        false},
+    {arcraven::ugv::UgvCommand::FollowTarget,      "FollowTarget",      arcraven::ugv::CommandDomain::Mobility,    arcraven::ugv::CommandPriority::Normal,     kAnyAuthority,        false},
+    {arcraven::ugv::UgvCommand::Evade,             "Evade",             arcraven::ugv::CommandDomain::Mobility,    arcraven::ugv::CommandPriority::High,       kAnyAuthority,        false},
+    {arcraven::ugv::UgvCommand::Dock,              "Dock",              arcraven::ugv::CommandDomain::Mobility,    arcraven::ugv::CommandPriority::Normal,     kAnyAuthority,        false},
+
+    {arcraven::ugv::UgvCommand::SetSpeedLimit,     "SetSpeedLimit",     arcraven::ugv::CommandDomain::Posture,     arcraven::ugv::CommandPriority::Normal,     kAnyAuthority,        true},
+    {arcraven::ugv::UgvCommand::SetStance,         "SetStance",         arcraven::ugv::CommandDomain::Posture,     arcraven::ugv::CommandPriority::Normal,     kAnyAuthority,        false},
+    {arcraven::ugv::UgvCommand::AlignHeading,      "AlignHeading",      arcraven::ugv::CommandDomain::Posture,     arcraven::ugv::CommandPriority::Normal,     kAnyAuthority,        true},
+    {arcraven::ugv::UgvCommand::FaceTarget,        "FaceTarget",        arcraven::ugv::CommandDomain::Posture,     arcraven::ugv::CommandPriority::Normal,     kAnyAuthority,        true},
+    {arcraven::ugv::UgvCommand::Stabilize,         "Stabilize",         arcraven::ugv::CommandDomain::Posture,     arcraven::ugv::CommandPriority::High,       kAnyAuthority,        false},
+
+    {arcraven::ugv::UgvCommand::ScanArea,          "ScanArea",          arcraven::ugv::CommandDomain::Perception,  arcraven::ugv::CommandPriority::Background, kAnyAuthority,        false},
+    {arcraven::ugv::UgvCommand::Observe,           "Observe",           arcraven::ugv::CommandDomain::Perception,  arcraven::ugv::CommandPriority::Background, kAnyAuthority,        false},
+    {arcraven::ugv::UgvCommand::FocusSensor,       "FocusSensor",       arcraven::ugv::CommandDomain::Perception,  arcraven::ugv::CommandPriority::Normal,     kAnyAuthority,        false},
+    {arcraven::ugv::UgvCommand::TrackEntity,       "TrackEntity",       arcraven::ugv::CommandDomain::Perception,  arcraven::ugv::CommandPriority::Normal,     kAnyAuthority,        false},
+    {arcraven::ugv::UgvCommand::CalibrateSensors,  "CalibrateSensors",  arcraven::ugv::CommandDomain::Perception,  arcraven::ugv::CommandPriority::Background, kAnyAuthority,        false},
+
+    {arcraven::ugv::UgvCommand::Sentinel,          "Sentinel",          arcraven::ugv::CommandDomain::Security,    arcraven::ugv::CommandPriority::High,       kAnyAuthority,        false},
+    {arcraven::ugv::UgvCommand::SecureArea,        "SecureArea",        arcraven::ugv::CommandDomain::Security,    arcraven::ugv::CommandPriority::High,       kAnyAuthority,        false},
+    {arcraven::ugv::UgvCommand::Escort,            "Escort",            arcraven::ugv::CommandDomain::Security,    arcraven::ugv::CommandPriority::High,       kAnyAuthority,        false},
+    {arcraven::ugv::UgvCommand::Checkpoint,        "Checkpoint",        arcraven::ugv::CommandDomain::Security,    arcraven::ugv::CommandPriority::High,       kAnyAuthority,        false},
+    {arcraven::ugv::UgvCommand::Investigate,       "Investigate",       arcraven::ugv::CommandDomain::Security,    arcraven::ugv::CommandPriority::High,       kAnyAuthority,        false},
+    {arcraven::ugv::UgvCommand::Shadow,            "Shadow",            arcraven::ugv::CommandDomain::Security,    arcraven::ugv::CommandPriority::High,       kAnyAuthority,        false},
+
+    {arcraven::ugv::UgvCommand::ExecuteMission,    "ExecuteMission",    arcraven::ugv::CommandDomain::Mission,     arcraven::ugv::CommandPriority::Normal,     kAnyAuthority,        false},
+    {arcraven::ugv::UgvCommand::AbortMission,      "AbortMission",      arcraven::ugv::CommandDomain::Mission,     arcraven::ugv::CommandPriority::High,       kAnyAuthority,        false},
+    {arcraven::ugv::UgvCommand::PauseMission,      "PauseMission",      arcraven::ugv::CommandDomain::Mission,     arcraven::ugv::CommandPriority::High,       kAnyAuthority,        false},
+    {arcraven::ugv::UgvCommand::ResumeMission,     "ResumeMission",     arcraven::ugv::CommandDomain::Mission,     arcraven::ugv::CommandPriority::Normal,     kAnyAuthority,        false},
+    {arcraven::ugv::UgvCommand::Wait,              "Wait",              arcraven::ugv::CommandDomain::Mission,     arcraven::ugv::CommandPriority::Normal,     kAnyAuthority,        false},
+    {arcraven::ugv::UgvCommand::HandoffControl,    "HandoffControl",    arcraven::ugv::CommandDomain::Mission,     arcraven::ugv::CommandPriority::High,       kIdentifiedAuthority, false},
+
+    {arcraven::ugv::UgvCommand::Signal,            "Signal",            arcraven::ugv::CommandDomain::Interaction, arcraven::ugv::CommandPriority::Normal,     kAnyAuthority,        false},
+    {arcraven::ugv::UgvCommand::Broadcast,         "Broadcast",         arcraven::ugv::CommandDomain::Interaction, arcraven::ugv::CommandPriority::Normal,     kAnyAuthority,        false},
+    {arcraven::ugv::UgvCommand::Acknowledge,       "Acknowledge",       arcraven::ugv::CommandDomain::Interaction, arcraven::ugv::CommandPriority::Normal,     kAnyAuthority,        false},
+    {arcraven::ugv::UgvCommand::RequestAssistance, "RequestAssistance", arcraven::ugv::CommandDomain::Interaction, arcraven::ugv::CommandPriority::High,       kAnyAuthority,        false},
+
+    {arcraven::ugv::UgvCommand::EmergencyStop,     "EmergencyStop",     arcraven::ugv::CommandDomain::Health,      arcraven::ugv::CommandPriority::Critical,   kAnyAuthority,        false},
+    {arcraven::ugv::UgvCommand::SafeMode,          "SafeMode",          arcraven::ugv::CommandDomain::Health,      arcraven::ugv::CommandPriority::Critical,   kAnyAuthority,        false},
+    {arcraven::ugv::UgvCommand::SelfCheck,         "SelfCheck",         arcraven::ugv::CommandDomain::Health,      arcraven::ugv::CommandPriority::Background, kAnyAuthority,        false},
+    {arcraven::ugv::UgvCommand::Recover,           "Recover",           arcraven::ugv::CommandDomain::Health,      arcraven::ugv::CommandPriority::High,       kAnyAuthority,        false},
+    {arcraven::ugv::UgvCommand::Shutdown,          "Shutdown",          arcraven::ugv::CommandDomain::Health,      arcraven::ugv::CommandPriority::Critical,   kOperatorAuthority,   false},
+    {arcraven::ugv::UgvCommand::Reboot,            "Reboot",            arcraven::ugv::CommandDomain::Health,      arcraven::ugv::CommandPriority::High,       kOperatorAuthority,   false},
+
+    {arcraven::ugv::UgvCommand::SetRuleset,        "SetRuleset",        arcraven::ugv::CommandDomain::Authority,   arcraven::ugv::CommandPriority::High,       kOperatorAuthority,   false},
+    {arcraven::ugv::UgvCommand::SetOwnership,      "SetOwnership",      arcraven::ugv::CommandDomain::Authority,   arcraven::ugv::CommandPriority::High,       kIdentifiedAuthority, false},
+    {arcraven::ugv::UgvCommand::LockCommandSet,    "LockCommandSet",    arcraven::ugv::CommandDomain::Authority,   arcraven::ugv::CommandPriority::High,       kIdentifiedAuthority, false},
+    {arcraven::ugv::UgvCommand::UnlockCommandSet,  "UnlockCommandSet",  arcraven::ugv::CommandDomain::Authority,   arcraven::ugv::CommandPriority::High,       kIdentifiedAuthority, false},
+    // clang-format on
+});
+
+inline constexpr uint8_t kNoRegistryEntry = UINT8_MAX;
+
+// command_slot -> index into kCommandRegistry.
+inline constexpr auto kCommandRegistryIndex = [] {
+    std::array<uint8_t, kHandlerSlots> idx{};
+    idx.fill(kNoRegistryEntry);
+    for (size_t i = 0; i < kCommandRegistry.size(); ++i) {
+        idx[command_slot(kCommandRegistry[i].command)] = static_cast<uint8_t>(i);
+    }
+    return idx;
+}();
+
+constexpr const CommandInfo* command_info(arcraven::ugv::UgvCommand cmd) {
+    const size_t slot = command_slot(cmd);
+    if (slot >= kHandlerSlots || kCommandRegistryIndex[slot] == kNoRegistryEntry) return nullptr;
+    return &kCommandRegistry[kCommandRegistryIndex[slot]];
+}
+
+constexpr std::string_view command_name(arcraven::ugv::UgvCommand cmd) {
+    const CommandInfo* info = command_info(cmd);
+    return info ? info->name : std::string_view{"Unknown"};
+}
+
+namespace registry_checks {
+
+// Ascending ids imply uniqueness; every id must map to a slot; the id's hundreds group must match
+// its domain (100 = Mobility ... 800 = Authority) and the name must be present.
+constexpr bool well_formed() {
+    for (size_t i = 0; i < kCommandRegistry.size(); ++i) {
+        const CommandInfo& c = kCommandRegistry[i];
+        const auto id = static_cast<uint16_t>(c.command);
+        if (command_slot(c.command) >= kHandlerSlots) return false;
+        if (id / 100u != static_cast<unsigned>(c.domain) + 1u) return false;
+        if (c.name.empty() || c.authorities == 0 || (c.authorities & ~kAnyAuthority) != 0) return false;
+        if (i > 0 && id <= static_cast<uint16_t>(kCommandRegistry[i - 1].command)) return false;
+    }
+    return true;
+}
+
+constexpr bool names_unique() {
+    for (size_t i = 0; i < kCommandRegistry.size(); ++i) {
+        for (size_t j = i + 1; j < kCommandRegistry.size(); ++j) {
+            if (kCommandRegistry[i].name == kCommandRegistry[j].name) return false;
+        }
+    }
+    return true;
+}
+
+// Default-less switch: -Wswitch flags any UgvCommand enumerator added without a case here.
+constexpr bool is_enumerator(arcraven::ugv::UgvCommand cmd) {
+    switch (cmd) {
+        case arcraven::ugv::UgvCommand::FollowPath:
+        case arcraven::ugv::UgvCommand::GoTo:
+        case arcraven::ugv::UgvCommand::Stop:
+        case arcraven::ugv::UgvCommand::HoldPosition:
+        case arcraven::ugv::UgvCommand::Anchor:
+        case arcraven::ugv::UgvCommand::ReplanTo:
+        case arcraven::ugv::UgvCommand::Loiter:
+        case arcraven::ugv::UgvCommand::ReturnToBase:
+        case arcraven::ugv::UgvCommand::FollowTarget:
+        case arcraven::ugv::UgvCommand::Evade:
+        case arcraven::ugv::UgvCommand::Dock:
+        case arcraven::ugv::UgvCommand::SetSpeedLimit:
+        case arcraven::ugv::UgvCommand::SetStance:
+        case arcraven::ugv::UgvCommand::AlignHeading:
+        case arcraven::ugv::UgvCommand::FaceTarget:
+        case arcraven::ugv::UgvCommand::Stabilize:
+        case arcraven::ugv::UgvCommand::ScanArea:
+        case arcraven::ugv::UgvCommand::Observe:
+        case arcraven::ugv::UgvCommand::FocusSensor:
+        case arcraven::ugv::UgvCommand::TrackEntity:
+        case arcraven::ugv::UgvCommand::CalibrateSensors:
+        case arcraven::ugv::UgvCommand::Sentinel:
+        case arcraven::ugv::UgvCommand::SecureArea:
+        case arcraven::ugv::UgvCommand::Escort:
+        case arcraven::ugv::UgvCommand::Checkpoint:
+        case arcraven::ugv::UgvCommand::Investigate:
+        case arcraven::ugv::UgvCommand::Shadow:
+        case arcraven::ugv::UgvCommand::ExecuteMission:
+        case arcraven::ugv::UgvCommand::AbortMission:
+        case arcraven::ugv::UgvCommand::PauseMission:
+        case arcraven::ugv::UgvCommand::ResumeMission:
+        case arcraven::ugv::UgvCommand::Wait:
+        case arcraven::ugv::UgvCommand::HandoffControl:
+        case arcraven::ugv::UgvCommand::Signal:
+        case arcraven::ugv::UgvCommand::Broadcast:
+        case arcraven::ugv::UgvCommand::Acknowledge:
+        case arcraven::ugv::UgvCommand::RequestAssistance:
+        case arcraven::ugv::UgvCommand::EmergencyStop:
+        case arcraven::ugv::UgvCommand::SafeMode:
+        case arcraven::ugv::UgvCommand::SelfCheck:
+        case arcraven::ugv::UgvCommand::Recover:
+        case arcraven::ugv::UgvCommand::Shutdown:
+        case arcraven::ugv::UgvCommand::Reboot:
+        case arcraven::ugv::UgvCommand::SetRuleset:
+        case arcraven::ugv::UgvCommand::SetOwnership:
+        case arcraven::ugv::UgvCommand::LockCommandSet:
+        case arcraven::ugv::UgvCommand::UnlockCommandSet:
+            return true;
+    }
+    return false;
+}
+
+// Coverage both ways: every enumerator has an entry and every entry is an enumerator.
+constexpr bool covers_enum() {
+    for (uint16_t id = 0; id < 1000; ++id) {
+        const auto cmd = static_cast<arcraven::ugv::UgvCommand>(id);
+        // Index lookup rather than command_info() != nullptr: GCC's -fsanitize=null does not
+        // treat that pointer comparison as a constant expression.
+        const size_t slot = command_slot(cmd);
+        const bool has_entry = slot < kHandlerSlots && kCommandRegistryIndex[slot] != kNoRegistryEntry;
+        if (is_enumerator(cmd) != has_entry) return false;
+    }
+    return true;
+}
+
+} // namespace registry_checks
+
+static_assert(registry_checks::well_formed(), "kCommandRegistry: ids must ascend, match their domain group and fit a slot");
+static_assert(registry_checks::names_unique(), "kCommandRegistry: duplicate command name");
+static_assert(registry_checks::covers_enum(), "kCommandRegistry: must hold exactly one entry per UgvCommand");
+
+// Commands coalesced by CoalesceMode::PerCommand/PerDomain (latest setpoint wins).
+inline std::bitset<kHandlerSlots> registry_superseding_commands() {
+    std::bitset<kHandlerSlots> s;
+    for (const CommandInfo& c : kCommandRegistry) {
+        if (c.superseding) s.set(command_slot(c.command));
+    }
+    return s;
+}
+
+} // namespace arcraven::ugv
@@ -1,80 +1,290 @@
 
 #include "CommandRouter.hpp"
 
+#include <algorithm>
 #include <cstdint>
 
 #include "CommandTypes.hpp"
 
 namespace arcraven::ugv {
 
-static inline uint16_t key(arcraven::ugv::UgvCommand c) {
-    return static_cast<uint16_t>(c);
+namespace {
+
+constexpr size_t kPayloadHeadroom = 16;
+
+SubmitResult rejected(arcraven::ugv::RejectReason reason, const char* message) {
+    return {SubmitOutcome::Rejected, {arcraven::ugv::CommandStatus::Rejected, reason, message}};
 }
 
-CommandRouter::CommandRouter(CommandRouterConfig cfg) : cfg_(cfg) {}
+} // namespace
+
+CommandRouter::CommandRouter(CommandRouterConfig cfg)
+    : cfg_(cfg),
+      // Evictions let the queue overshoot max_queue until the consumer catches up, so the ring
+      // and lanes get headroom for one eviction per lower-priority entry.
+      ingress_(cfg.max_queue * 2),
+      high_watermark_(std::max<size_t>(1, cfg.max_queue * cfg.high_watermark_pct / 100)),
+      low_watermark_(std::min(high_watermark_ - 1, cfg.max_queue * cfg.low_watermark_pct / 100)),
+      recent_(cfg.dedupe_window),
+      sched_(cfg.max_queue * 2, cfg.starvation_budget, cfg.ttl_wheel_resolution_ns) {
+    outcomes_.reserve(cfg_.max_queue * 2);
+    // A queued command can hold a payload block (FollowPath waypoints); the ring takes up to
+    // 2 * max_queue of them, plus a few being decoded by the links.
+    PayloadSlab::instance().reserve(cfg_.max_queue * 2 + kPayloadHeadroom);
+    current_ = std::make_unique<HandlerTable>();
+    table_.store(current_.get(), std::memory_order_release);
+}
 
 void CommandRouter::register_handler(arcraven::ugv::UgvCommand cmd, CommandHandler handler) {
+    const size_t slot = command_slot(cmd);
+    if (slot >= kHandlerSlots) return;
+
+    auto fresh = handler ? std::make_unique<CommandHandler>(std::move(handler)) : nullptr;
+
     std::lock_guard<std::mutex> lk(mu_);
-    handlers_[key(cmd)] = std::move(handler);
+    auto next = std::make_unique<HandlerTable>(*current_);
+    next->slots[slot] = fresh.get();
+
+    publish(std::move(next));
+    retired_.back().handler = std::move(handlers_[slot]);
+    handlers_[slot] = std::move(fresh);
+
+    reclaim_retired();
 }
 
-bool CommandRouter::has_handler(arcraven::ugv::UgvCommand cmd) const {
+void CommandRouter::register_handlers(std::span<const CommandInfo> commands, const CommandHandler& handler) {
+    std::bitset<kHandlerSlots> listed;
+    std::array<std::unique_ptr<CommandHandler>, kHandlerSlots> fresh;
+    for (const CommandInfo& info : commands) {
+        const size_t slot = command_slot(info.command);
+        if (slot >= kHandlerSlots || listed[slot]) continue;
+        listed.set(slot);
+        if (handler) fresh[slot] = std::make_unique<CommandHandler>(handler);
+    }
+
     std::lock_guard<std::mutex> lk(mu_);
-    return handlers_.find(key(cmd)) != handlers_.end();
+    auto next = std::make_unique<HandlerTable>(*current_);
+    for (size_t slot = 0; slot < kHandlerSlots; ++slot) {
+        if (listed[slot]) next->slots[slot] = fresh[slot].get();
+    }
+
+    publish(std::move(next));
+    const uint64_t retire_epoch = retired_.back().epoch;
+    for (size_t slot = 0; slot < kHandlerSlots; ++slot) {
+        if (!listed[slot]) continue;
+        if (handlers_[slot]) retired_.push_back(Retired{retire_epoch, nullptr, std::move(handlers_[slot])});
+        handlers_[slot] = std::move(fresh[slot]);
+    }
+
+    reclaim_retired();
 }
 
-CommandResult CommandRouter::submit(CommandEnvelope cmd) {
+void CommandRouter::publish(std::unique_ptr<HandlerTable> next) {
+    // seq_cst pairs with process_one: a consumer that announced an epoch older than the one
+    // retiring the old table may still be inside it; one that announced after loads the new one.
+    table_.store(next.get(), std::memory_order_seq_cst);
+    const uint64_t retire_epoch = epoch_.fetch_add(1, std::memory_order_seq_cst) + 1;
+    retired_.push_back(Retired{retire_epoch, std::move(current_), nullptr});
+    current_ = std::move(next);
+}
+
+void CommandRouter::reclaim_retired() {
+    const uint64_t reader = reader_epoch_.load(std::memory_order_seq_cst);
+    std::erase_if(retired_, [reader](const Retired& r) { return reader == 0 || reader >= r.epoch; });
+}
+
+bool CommandRouter::has_handler(arcraven::ugv::UgvCommand cmd) const {
     std::lock_guard<std::mutex> lk(mu_);
+    return current_->find(cmd) != nullptr;
+}
 
-    if (q_.size() >= cfg_.max_queue) {
-        return {arcraven::ugv::CommandStatus::Rejected, arcraven::ugv::RejectReason::Busy, "queue full"};
-    }
+size_t CommandRouter::pending_reclaim() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return retired_.size();
+}
 
+SubmitResult CommandRouter::submit(CommandEnvelope cmd) {
     // Minimal early validation: you can harden this later.
     if (cmd.command_id == 0) {
-        return {arcraven::ugv::CommandStatus::Rejected, arcraven::ugv::RejectReason::InvalidPayload, "command_id=0"};
+        return rejected(arcraven::ugv::RejectReason::InvalidPayload, "command_id=0");
+    }
+
+    if (auto cached = recent_.lookup(cmd.command_id)) {
+        return {SubmitOutcome::Duplicate, std::move(*cached)};
+    }
+
+    if (!authority_.permits(cmd)) {
+        return rejected(arcraven::ugv::RejectReason::NotAuthorized, "not authorized");
+    }
+
+    const uint64_t command_id = cmd.command_id;
+    const size_t lane = CommandScheduler::lane_of(cmd.priority);
+
+    // Reserve a slot first so max_queue is honoured exactly even though the ring is a power of two.
+    const size_t reserved = queued_.fetch_add(1, std::memory_order_acq_rel) + 1;
+    if (reserved >= high_watermark_) backpressure_.store(true, std::memory_order_relaxed);
+    if (reserved > cfg_.max_queue && !claim_eviction(lane)) {
+        queued_.fetch_sub(1, std::memory_order_acq_rel);
+        return rejected(arcraven::ugv::RejectReason::Busy, "queue full");
     }
 
-    q_.push_back(std::move(cmd));
-    return {arcraven::ugv::CommandStatus::Accepted, arcraven::ugv::RejectReason::None, ""};
+    // Cached before the push: once queued, the control thread may record the final status (and a
+    // retransmit may look the id up) at any moment.
+    recent_.insert(command_id);
+    lane_count_[lane].fetch_add(1, std::memory_order_acq_rel);
+    cmd.stamps.enqueue_ns = steady_now_ns();
+    if (!ingress_.try_push(std::move(cmd))) {
+        // Only reachable while the consumer is mid-pop on a completely full ring. A claimed
+        // eviction is not returned; the consumer simply finds one more slot free than needed.
+        lane_count_[lane].fetch_sub(1, std::memory_order_acq_rel);
+        queued_.fetch_sub(1, std::memory_order_acq_rel);
+        SubmitResult busy = rejected(arcraven::ugv::RejectReason::Busy, "queue full");
+        recent_.record(command_id, busy.result);
+        return busy;
+    }
+    return {SubmitOutcome::Queued, {arcraven::ugv::CommandStatus::Accepted, arcraven::ugv::RejectReason::None, ""}};
 }
 
-std::optional<std::pair<CommandEnvelope, CommandResult>> CommandRouter::process_one(uint64_t now_ns) {
+bool CommandRouter::claim_eviction(size_t lane) {
+    std::lock_guard<std::mutex> lk(evict_mu_);
+    for (size_t l = 0; l < lane; ++l) {
+        const size_t queued = lane_count_[l].load(std::memory_order_acquire);
+        const size_t claimed = evict_claims_[l].load(std::memory_order_acquire);
+        if (queued > claimed) {
+            evict_claims_[l].fetch_add(1, std::memory_order_acq_rel);
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t CommandRouter::coalesce_key(const CommandEnvelope& cmd) const {
+    if (cfg_.coalesce == CoalesceMode::Off) return CommandScheduler::kNoKey;
+
+    const size_t slot = command_slot(cmd.command);
+    if (slot >= kHandlerSlots || !cfg_.superseding.test(slot)) return CommandScheduler::kNoKey;
+
+    if (cfg_.coalesce == CoalesceMode::PerCommand) return slot;
+    const auto domain = static_cast<size_t>(cmd.domain);
+    return domain < CommandScheduler::kDomainKeys ? kHandlerSlots + domain : CommandScheduler::kNoKey;
+}
+
+void CommandRouter::drain_ingress() {
     CommandEnvelope cmd{};
-    CommandHandler handler;
+    CommandEnvelope displaced{};
+    while (!sched_.full() && ingress_.try_pop(cmd)) {
+        if (sched_.push(cmd, coalesce_key(cmd), displaced) != CommandScheduler::PushResult::Replaced) continue;
 
-    {
-        std::lock_guard<std::mutex> lk(mu_);
-        if (q_.empty()) return std::nullopt;
+        lane_count_[CommandScheduler::lane_of(displaced.priority)].fetch_sub(1, std::memory_order_acq_rel);
+        queued_.fetch_sub(1, std::memory_order_acq_rel);
+        outcomes_.emplace_back(std::move(displaced),
+            CommandResult{arcraven::ugv::CommandStatus::Preempted, arcraven::ugv::RejectReason::None, "superseded"});
+    }
+}
 
-        cmd = std::move(q_.front());
-        q_.pop_front();
+void CommandRouter::expire_queued(uint64_t now_ns) {
+    sched_.expire_due(now_ns, [this](CommandEnvelope& expired) {
+        lane_count_[CommandScheduler::lane_of(expired.priority)].fetch_sub(1, std::memory_order_acq_rel);
+        queued_.fetch_sub(1, std::memory_order_acq_rel);
+        outcomes_.emplace_back(std::move(expired),
+            CommandResult{arcraven::ugv::CommandStatus::Expired, arcraven::ugv::RejectReason::StaleCommand, "expired"});
+    });
+}
 
-        auto it = handlers_.find(key(cmd.command));
-        if (it != handlers_.end()) handler = it->second;
+void CommandRouter::apply_evictions() {
+    for (size_t l = 0; l < CommandScheduler::kLanes; ++l) {
+        const size_t claims = evict_claims_[l].load(std::memory_order_acquire);
+        if (claims == 0) continue;
+
+        // Evict before releasing the claims so producers never see a stale (count, claims) pair
+        // that would let them claim the same entry twice.
+        CommandEnvelope victim{};
+        for (size_t i = 0; i < claims && sched_.pop_oldest(l, victim); ++i) {
+            lane_count_[l].fetch_sub(1, std::memory_order_acq_rel);
+            queued_.fetch_sub(1, std::memory_order_acq_rel);
+            outcomes_.emplace_back(std::move(victim),
+                CommandResult{arcraven::ugv::CommandStatus::Preempted, arcraven::ugv::RejectReason::Busy,
+                              "evicted by higher priority"});
+        }
+        evict_claims_[l].fetch_sub(claims, std::memory_order_acq_rel);
     }
+}
 
-    if (is_expired(cmd, now_ns)) {
-        return std::make_pair(std::move(cmd),
-                              CommandResult{arcraven::ugv::CommandStatus::Rejected, arcraven::ugv::RejectReason::StaleCommand, "expired"});
+void CommandRouter::update_backpressure() {
+    if (backpressure_.load(std::memory_order_relaxed) &&
+        queued_.load(std::memory_order_acquire) <= low_watermark_) {
+        backpressure_.store(false, std::memory_order_relaxed);
     }
+}
+
+std::optional<std::pair<CommandEnvelope, CommandResult>> CommandRouter::process_one(uint64_t now_ns) {
+    drain_ingress();
+    expire_queued(now_ns);
+    apply_evictions();
+    update_backpressure();
 
-    if (!handler) {
-        return std::make_pair(std::move(cmd),
-                              CommandResult{arcraven::ugv::CommandStatus::Rejected, arcraven::ugv::RejectReason::Unsupported, "no handler"});
+    last_was_report_ = outcome_head_ < outcomes_.size();
+    if (last_was_report_) {
+        Outcome o = std::move(outcomes_[outcome_head_++]);
+        if (outcome_head_ == outcomes_.size()) {
+            outcomes_.clear();
+            outcome_head_ = 0;
+        }
+        recent_.record(o.first.command_id, o.second);
+        return o;
     }
 
-    // Execute handler (expected to be fast and non-blocking).
-    CommandResult r = handler(cmd);
-    if (r.status == arcraven::ugv::CommandStatus::None) {
-        r.status = arcraven::ugv::CommandStatus::Received;
+    CommandEnvelope cmd{};
+    if (!sched_.pop_next(cmd)) return std::nullopt;
+    lane_count_[CommandScheduler::lane_of(cmd.priority)].fetch_sub(1, std::memory_order_acq_rel);
+    queued_.fetch_sub(1, std::memory_order_acq_rel);
+    update_backpressure();
+
+    cmd.stamps.dispatch_ns = steady_now_ns();
+
+    // Read-side critical section: the table and handler stay alive until reader_epoch_ drops
+    // back to 0, even if register_handler replaces them (possibly from inside the handler).
+    reader_epoch_.store(epoch_.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+    const CommandHandler* handler = table_.load(std::memory_order_seq_cst)->find(cmd.command);
+
+    CommandResult r{};
+    if (is_expired(cmd, now_ns)) {
+        // Backstop for the sub-tick window the wheel has not scanned yet.
+        r = {arcraven::ugv::CommandStatus::Expired, arcraven::ugv::RejectReason::StaleCommand, "expired"};
+    } else if (!handler) {
+        r = {arcraven::ugv::CommandStatus::Rejected, arcraven::ugv::RejectReason::Unsupported, "no handler"};
+    } else {
+        // Execute handler (expected to be fast and non-blocking).
+        r = (*handler)(cmd);
+        if (r.status == arcraven::ugv::CommandStatus::None) {
+            r.status = arcraven::ugv::CommandStatus::Received;
+        }
     }
+    reader_epoch_.store(0, std::memory_order_release);
+    cmd.stamps.done_ns = steady_now_ns();
+    recent_.record(cmd.command_id, r);
     return std::make_pair(std::move(cmd), std::move(r));
 }
 
+void CommandRouter::record_result(uint64_t command_id, const CommandResult& result) {
+    recent_.record(command_id, result);
+}
+
 size_t CommandRouter::queued() const {
-    std::lock_guard<std::mutex> lk(mu_);
-    return q_.size();
+    return queued_.load(std::memory_order_acquire);
+}
+
+size_t CommandRouter::queued(arcraven::ugv::CommandPriority priority) const {
+    return lane_count_[CommandScheduler::lane_of(priority)].load(std::memory_order_acquire);
+}
+
+CommandCredits CommandRouter::credits() const {
+    CommandCredits c{};
+    c.capacity = cfg_.max_queue;
+    c.queued = std::min(queued_.load(std::memory_order_acquire), c.capacity);
+    c.credits = c.capacity - c.queued;
+    c.backpressure = backpressure_.load(std::memory_order_relaxed);
+    return c;
 }
 
 } // namespace arcraven::ugv
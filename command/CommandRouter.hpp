@@ -1,22 +1,77 @@
 #pragma once
+#include <array>
+#include <atomic>
+#include <bitset>
 #include <cstddef>
 #include <cstdint>
-#include <deque>
-#include <functional>
+#include <memory>
 #include <mutex>
 #include <optional>
-#include <unordered_map>
+#include <span>
+#include <utility>
+#include <vector>
 
+#include "command/AuthorityArbiter.hpp"
+#include "command/CommandRegistry.hpp"
+#include "command/CommandScheduler.hpp"
 #include "command/CommandTypes.hpp"
+#include "command/HandlerTable.hpp"
+#include "command/RecentCommandCache.hpp"
+#include "core/MpscRing.hpp"
 
 namespace arcraven::ugv {
 
-// Handler signature: execute should be fast and non-blocking. Heavy work must be staged
-// into other subsystems (e.g., set an atomic target for the control thread).
-using CommandHandler = std::function<CommandResult(const CommandEnvelope&)>;
+// Latest-wins coalescing of queued "superseding" commands (teleop setpoints resent at high rate).
+enum class CoalesceMode : uint8_t {
+    Off = 0,
+    PerCommand = 1, // a superseding command replaces a queued one with the same UgvCommand
+    PerDomain = 2,  // ... or any queued superseding command of the same CommandDomain
+};
 
 struct CommandRouterConfig {
-    size_t max_queue = 256;
+    size_t max_queue = 256; // ring slots are preallocated from this at construction
+
+    // After a waiting Background/Normal/High lane has been passed over this many times by
+    // higher lanes it gets the next dispatch. Critical is never held back.
+    uint32_t starvation_budget = 16;
+
+    // Replaced commands are acked as Preempted. Only commands in `superseding` are coalesced.
+    CoalesceMode coalesce = CoalesceMode::Off;
+    std::bitset<kHandlerSlots> superseding = registry_superseding_commands();
+
+    // Retransmit suppression: the last N accepted command_ids are remembered and a resubmitted
+    // id gets its cached result back instead of executing again. 0 disables.
+    size_t dedupe_window = 1024;
+
+    // Tick of the TTL timer wheel. Queued commands whose issued_ns + ttl_ns has passed are
+    // reported Expired/StaleCommand at most one tick late, without waiting for dispatch.
+    uint64_t ttl_wheel_resolution_ns = 1'000'000;
+
+    // Backpressure hysteresis (percent of max_queue): raised when the queue reaches the high
+    // watermark, cleared once it drains to the low one. Advisory; submit still accepts.
+    uint8_t high_watermark_pct = 75;
+    uint8_t low_watermark_pct = 25;
+};
+
+// Flow-control snapshot advertised to clients.
+struct CommandCredits {
+    size_t credits = 0;  // free queue slots
+    size_t queued = 0;
+    size_t capacity = 0; // max_queue
+    bool backpressure = false;
+};
+
+// What submit() did with a command. Only Queued commands get their result later, from the
+// consumer; the links answer Duplicate and Rejected right away with SubmitResult::result.
+enum class SubmitOutcome : uint8_t {
+    Queued = 0,
+    Duplicate = 1, // command_id seen within dedupe_window; result is the cached one
+    Rejected = 2,
+};
+
+struct SubmitResult {
+    SubmitOutcome outcome = SubmitOutcome::Rejected;
+    CommandResult result;
 };
 
 class CommandRouter final {
@@ -24,37 +79,109 @@ public:
     explicit CommandRouter(CommandRouterConfig cfg = {});
 
     // Registration: allows you to "make it possible" to call commands now,
-    // while implementing actual logic later.
+    // while implementing actual logic later. Publishes a new dispatch table; never blocks dispatch.
+    // Safe from any thread at any time, including from inside a handler (swap a stub for the
+    // real handler once CalibrateSensors completes, after a plugin loads, ...). The replaced
+    // table and handler are reclaimed once the consumer can no longer be running them.
     void register_handler(arcraven::ugv::UgvCommand cmd, CommandHandler handler);
+    // Same, for every command in commands (e.g. kCommandRegistry), with one table swap.
+    void register_handlers(std::span<const CommandInfo> commands, const CommandHandler& handler);
     bool has_handler(arcraven::ugv::UgvCommand cmd) const;
 
-    // Thread-safe enqueue (typically IO thread).
-    // Returns Accepted/Rejected with reason. If accepted, it is queued for processing.
-    CommandResult submit(CommandEnvelope cmd);
+    // Replaced tables/handlers still waiting for the consumer to leave a dispatch.
+    size_t pending_reclaim() const;
+
+    // Lock-free enqueue, safe from any number of producer threads (typically IO thread).
+    // Returns Queued (result Accepted) or Rejected with a reason.
+    // When the queue is full, a command is still accepted if a lower-priority one can be
+    // evicted for it; the evicted command is reported as Preempted/Busy by process_one.
+    // A command_id seen within dedupe_window is a Duplicate; result is its cached result with
+    // message "duplicate".
+    // A command its authority may not issue (see AuthorityArbiter) is rejected NotAuthorized
+    // before it takes a queue slot.
+    SubmitResult submit(CommandEnvelope cmd);
 
     // Processing:
-    // - can be called from control thread or a dedicated "command thread"
+    // - single consumer: call from the control thread or a dedicated "command thread", not both
     // - returns an optional (cmd, result) for ack/telemetry
+    // - dispatch order is by priority lane, FIFO within a lane
+    // - queued commands past their TTL are reported Expired before anything is dispatched
     std::optional<std::pair<CommandEnvelope, CommandResult>> process_one(uint64_t now_ns);
 
-    // Convenience: drain up to N commands.
+    // Convenience: dispatch up to N commands. Router-generated reports (evicted, superseded, expired)
+    // are delivered as well but do not count against max_n.
     template <typename Fn>
     void process_some(uint64_t now_ns, size_t max_n, Fn&& on_processed) {
-        for (size_t i = 0; i < max_n; ++i) {
+        for (size_t i = 0; i < max_n;) {
             auto r = process_one(now_ns);
             if (!r) break;
+            if (!last_was_report_) ++i;
             on_processed(*r);
         }
     }
 
+    // Updates the cached result of an already dispatched command (e.g. the final status of a
+    // long-running task), so a retransmit is answered with its latest state.
+    void record_result(uint64_t command_id, const CommandResult& result);
+
+    // Ownership and command-set locks consulted by submit.
+    AuthorityArbiter& authority() { return authority_; }
+    const AuthorityArbiter& authority() const { return authority_; }
+
     size_t queued() const;
+    size_t queued(arcraven::ugv::CommandPriority priority) const;
+
+    CommandCredits credits() const;
 
 private:
+    using Outcome = std::pair<CommandEnvelope, CommandResult>;
+
+    size_t coalesce_key(const CommandEnvelope& cmd) const;
+    bool claim_eviction(size_t lane);
+    void drain_ingress();
+    void expire_queued(uint64_t now_ns);
+    void apply_evictions();
+    void update_backpressure();
+
     CommandRouterConfig cfg_;
 
-    mutable std::mutex mu_;
-    std::deque<CommandEnvelope> q_;
-    std::unordered_map<uint16_t, CommandHandler> handlers_;
+    // Producers -> ingress ring (lock-free). The consumer moves entries into the scheduler lanes.
+    MpscRing<CommandEnvelope> ingress_;
+    std::atomic<size_t> queued_{0};
+    size_t high_watermark_;
+    size_t low_watermark_;
+    std::atomic<bool> backpressure_{false};
+    std::array<std::atomic<size_t>, CommandScheduler::kLanes> lane_count_{};
+    std::array<std::atomic<size_t>, CommandScheduler::kLanes> evict_claims_{};
+    std::mutex evict_mu_; // serialises producers on the queue-full path only
+    RecentCommandCache recent_;
+    AuthorityArbiter authority_;
+
+    // Consumer-private.
+    CommandScheduler sched_;
+    std::vector<Outcome> outcomes_;
+    size_t outcome_head_ = 0;
+    bool last_was_report_ = false;
+
+    // Handler tables, RCU style. Dispatch reads table_ lock-free and announces the epoch it
+    // started in (reader_epoch_, 0 while not dispatching). register_handler swaps in a copy,
+    // bumps epoch_ and retires the old table plus the handlers it displaced; a retired entry is
+    // freed once the consumer is idle or has started a dispatch at or after its epoch.
+    struct Retired {
+        uint64_t epoch = 0;
+        std::unique_ptr<HandlerTable> table;
+        std::unique_ptr<CommandHandler> handler;
+    };
+    void publish(std::unique_ptr<HandlerTable> next); // requires mu_; retires current_
+    void reclaim_retired();                           // requires mu_
+
+    std::atomic<const HandlerTable*> table_{nullptr};
+    std::atomic<uint64_t> epoch_{1};
+    std::atomic<uint64_t> reader_epoch_{0};
+    mutable std::mutex mu_; // writers only
+    std::unique_ptr<HandlerTable> current_;
+    std::array<std::unique_ptr<CommandHandler>, kHandlerSlots> handlers_;
+    std::vector<Retired> retired_;
 };
 
 } // namespace arcraven::ugv
@@ -0,0 +1,177 @@
+#include "command/CommandScheduler.hpp"
+
+#include <utility>
+
+namespace arcraven::ugv {
+
+CommandScheduler::CommandScheduler(size_t capacity, uint32_t starvation_budget, uint64_t wheel_resolution_ns)
+    : starvation_budget_(starvation_budget),
+      resolution_ns_(wheel_resolution_ns ? wheel_resolution_ns : 1),
+      nodes_(capacity) {
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        nodes_[i].next = (i + 1 < nodes_.size()) ? static_cast<uint32_t>(i + 1) : kNil;
+    }
+    free_head_ = nodes_.empty() ? kNil : 0;
+    key_node_.fill(kNil);
+    wheel_.fill(kNil);
+}
+
+void CommandScheduler::arm(uint32_t idx) {
+    Node& n = nodes_[idx];
+    const CommandEnvelope& c = n.env;
+    if (c.ttl_ns == 0 || c.issued_ns == 0) {
+        n.deadline_ns = 0;
+        return;
+    }
+    n.deadline_ns = (c.issued_ns > UINT64_MAX - c.ttl_ns) ? UINT64_MAX : c.issued_ns + c.ttl_ns;
+
+    // Already-due entries land in the next tick to be scanned rather than a passed bucket.
+    const uint64_t tick = std::max(n.deadline_ns / resolution_ns_, wheel_tick_ + 1);
+    n.wheel_bucket = static_cast<uint32_t>(tick % kWheelSlots);
+    uint32_t& head = wheel_[n.wheel_bucket];
+    n.wheel_prev = kNil;
+    n.wheel_next = head;
+    if (head != kNil) nodes_[head].wheel_prev = idx;
+    head = idx;
+}
+
+void CommandScheduler::disarm(uint32_t idx) {
+    Node& n = nodes_[idx];
+    if (n.deadline_ns == 0) return;
+
+    if (n.wheel_prev == kNil) {
+        wheel_[n.wheel_bucket] = n.wheel_next;
+    } else {
+        nodes_[n.wheel_prev].wheel_next = n.wheel_next;
+    }
+    if (n.wheel_next != kNil) nodes_[n.wheel_next].wheel_prev = n.wheel_prev;
+    n.wheel_prev = kNil;
+    n.wheel_next = kNil;
+    n.deadline_ns = 0;
+}
+
+void CommandScheduler::link_tail(uint32_t idx) {
+    Node& n = nodes_[idx];
+    Lane& lane = lanes_[n.lane];
+    n.prev = lane.tail;
+    n.next = kNil;
+    if (lane.tail == kNil) {
+        lane.head = idx;
+    } else {
+        nodes_[lane.tail].next = idx;
+    }
+    lane.tail = idx;
+    ++lane.count;
+    ++size_;
+}
+
+void CommandScheduler::unlink(uint32_t idx) {
+    Node& n = nodes_[idx];
+    Lane& lane = lanes_[n.lane];
+    if (n.prev == kNil) {
+        lane.head = n.next;
+    } else {
+        nodes_[n.prev].next = n.next;
+    }
+    if (n.next == kNil) {
+        lane.tail = n.prev;
+    } else {
+        nodes_[n.next].prev = n.prev;
+    }
+    --lane.count;
+    --size_;
+}
+
+void CommandScheduler::release(uint32_t idx, CommandEnvelope& out) {
+    disarm(idx);
+    Node& n = nodes_[idx];
+    if (n.key != kNil) {
+        key_node_[n.key] = kNil;
+        n.key = kNil;
+    }
+    out = std::move(n.env);
+    n.prev = kNil;
+    n.next = free_head_;
+    free_head_ = idx;
+}
+
+CommandScheduler::PushResult CommandScheduler::push(CommandEnvelope& cmd, size_t key, CommandEnvelope& displaced) {
+    const auto lane = static_cast<uint8_t>(lane_of(cmd.priority));
+    bool replaced = false;
+
+    if (key < kCoalesceKeys && key_node_[key] != kNil) {
+        const uint32_t idx = key_node_[key];
+        Node& n = nodes_[idx];
+        if (n.lane == lane) {
+            disarm(idx);
+            displaced = std::move(n.env);
+            n.env = std::move(cmd);
+            arm(idx);
+            return PushResult::Replaced;
+        }
+        // Different lane: drop the old entry and queue the new one normally (reuses its node).
+        unlink(idx);
+        release(idx, displaced);
+        replaced = true;
+    }
+
+    if (free_head_ == kNil) return PushResult::Full;
+
+    const uint32_t idx = free_head_;
+    Node& n = nodes_[idx];
+    free_head_ = n.next;
+
+    n.env = std::move(cmd);
+    n.lane = lane;
+    n.key = kNil;
+    if (key < kCoalesceKeys) {
+        n.key = static_cast<uint32_t>(key);
+        key_node_[key] = idx;
+    }
+    link_tail(idx);
+    arm(idx);
+    return replaced ? PushResult::Replaced : PushResult::Queued;
+}
+
+bool CommandScheduler::pop_oldest(size_t lane_idx, CommandEnvelope& out) {
+    const uint32_t idx = lanes_[lane_idx].head;
+    if (idx == kNil) return false;
+
+    unlink(idx);
+    release(idx, out);
+    return true;
+}
+
+bool CommandScheduler::pop_next(CommandEnvelope& out) {
+    constexpr size_t kCritical = kLanes - 1;
+    if (pop_oldest(kCritical, out)) return true;
+
+    // Starved lower lanes first (lowest lane has waited the longest relative to its share).
+    size_t pick = kLanes;
+    for (size_t l = 0; l < kCritical; ++l) {
+        if (lanes_[l].count > 0 && lanes_[l].passed_over >= starvation_budget_) {
+            pick = l;
+            break;
+        }
+    }
+    if (pick == kLanes) {
+        for (size_t l = kCritical; l-- > 0;) {
+            if (lanes_[l].count > 0) {
+                pick = l;
+                break;
+            }
+        }
+    }
+    if (pick == kLanes) return false;
+
+    for (size_t l = 0; l < kCritical; ++l) {
+        if (l == pick) {
+            lanes_[l].passed_over = 0;
+        } else if (l < pick && lanes_[l].count > 0) {
+            ++lanes_[l].passed_over;
+        }
+    }
+    return pop_oldest(pick, out);
+}
+
+} // namespace arcraven::ugv
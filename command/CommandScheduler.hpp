@@ -0,0 +1,121 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "command/CommandTypes.hpp"
+#include "command/HandlerTable.hpp"
+
+namespace arcraven::ugv {
+
+// Consumer-private priority lanes (Background/Normal/High/Critical) over a fixed node pool,
+// plus a hashed timer wheel over the same nodes for TTL expiry.
+// Not thread-safe: only the thread that calls CommandRouter::process_one touches it.
+class CommandScheduler final {
+public:
+    static constexpr size_t kLanes = 4;
+
+    // Coalescing keys: one per command slot, then one per CommandDomain.
+    static constexpr size_t kDomainKeys = 8;
+    static constexpr size_t kCoalesceKeys = kHandlerSlots + kDomainKeys;
+    static constexpr size_t kNoKey = SIZE_MAX;
+
+    static constexpr size_t kWheelSlots = 512;
+
+    enum class PushResult : uint8_t {
+        Queued,
+        Replaced, // an entry with the same coalescing key was superseded (see displaced)
+        Full,
+    };
+
+    CommandScheduler(size_t capacity, uint32_t starvation_budget, uint64_t wheel_resolution_ns);
+
+    static size_t lane_of(arcraven::ugv::CommandPriority p) {
+        const auto v = static_cast<size_t>(p);
+        return v < kLanes ? v : static_cast<size_t>(arcraven::ugv::CommandPriority::Normal);
+    }
+
+    // Queues cmd at the tail of its lane. With a coalescing key, a queued entry holding the same
+    // key is replaced: in place when both share a lane, otherwise the old one is unlinked.
+    // On Full, cmd is left untouched.
+    PushResult push(CommandEnvelope& cmd, size_t key, CommandEnvelope& displaced);
+
+    // Critical is always served first. Otherwise the highest non-empty lane wins, except that a
+    // lower lane which has been passed over starvation_budget times gets the next turn.
+    bool pop_next(CommandEnvelope& out);
+
+    // Removes the oldest entry of one lane (used for queue-full eviction).
+    bool pop_oldest(size_t lane, CommandEnvelope& out);
+
+    // Removes every queued entry whose TTL ran out before now_ns and hands it to on_expired.
+    // Only fully elapsed wheel ticks are scanned, so cost is O(ticks elapsed + entries due),
+    // bounded by one wheel rotation, and an entry is reported at most one resolution late.
+    template <typename Fn>
+    void expire_due(uint64_t now_ns, Fn&& on_expired) {
+        const uint64_t now_tick = now_ns / resolution_ns_;
+        if (now_tick == 0 || now_tick - 1 <= wheel_tick_) return;
+
+        const uint64_t last = now_tick - 1;
+        const uint64_t steps = std::min<uint64_t>(last - wheel_tick_, kWheelSlots);
+        CommandEnvelope expired{};
+        for (uint64_t t = last - steps + 1; t <= last; ++t) {
+            uint32_t idx = wheel_[t % kWheelSlots];
+            while (idx != kNil) {
+                const uint32_t next = nodes_[idx].wheel_next;
+                if (nodes_[idx].deadline_ns < now_ns) {
+                    unlink(idx);
+                    release(idx, expired);
+                    on_expired(expired);
+                }
+                idx = next;
+            }
+        }
+        wheel_tick_ = last;
+    }
+
+    size_t size() const { return size_; }
+    bool full() const { return free_head_ == kNil; }
+    size_t lane_size(size_t lane) const { return lanes_[lane].count; }
+
+private:
+    static constexpr uint32_t kNil = UINT32_MAX;
+
+    struct Node {
+        CommandEnvelope env;
+        uint64_t deadline_ns = 0; // 0 = no TTL (not on the wheel)
+        uint32_t prev = kNil;
+        uint32_t next = kNil;
+        uint32_t wheel_prev = kNil;
+        uint32_t wheel_next = kNil;
+        uint32_t wheel_bucket = 0;
+        uint32_t key = kNil;
+        uint8_t lane = 0;
+    };
+
+    struct Lane {
+        uint32_t head = kNil;
+        uint32_t tail = kNil;
+        size_t count = 0;
+        uint32_t passed_over = 0;
+    };
+
+    void link_tail(uint32_t idx);
+    void unlink(uint32_t idx);
+    void release(uint32_t idx, CommandEnvelope& out);
+    void arm(uint32_t idx);
+    void disarm(uint32_t idx);
+
+    uint32_t starvation_budget_;
+    uint64_t resolution_ns_;
+    std::vector<Node> nodes_;
+    uint32_t free_head_ = kNil;
+    std::array<Lane, kLanes> lanes_{};
+    std::array<uint32_t, kCoalesceKeys> key_node_{};
+    std::array<uint32_t, kWheelSlots> wheel_{};
+    uint64_t wheel_tick_ = 0; // last fully scanned tick
+    size_t size_ = 0;
+};
+
+} // namespace arcraven::ugv
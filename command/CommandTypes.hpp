@@ -3,6 +3,8 @@
 #include <string>
 #include <chrono>
 
+#include "command/CommandPayload.hpp"
+#include "command/TypedPayload.hpp"
 #include "models/enums/CommandAuthority.hpp"
 #include "models/enums/CommandDomain.hpp"
 #include "models/enums/CommandPriority.hpp"
@@ -14,6 +16,25 @@ namespace arcraven::ugv {
 
 using SteadyClock = std::chrono::steady_clock;
 
+inline uint64_t steady_now_ns() {
+    const auto now = SteadyClock::now().time_since_epoch();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+}
+
+// Pipeline timestamps (steady clock ns, 0 = stage not reached) for latency accounting.
+struct CommandStamps {
+    uint64_t rx_ns = 0;       // line parsed by the bridge
+    uint64_t enqueue_ns = 0;  // accepted by CommandRouter::submit
+    uint64_t dispatch_ns = 0; // popped for execution
+    uint64_t done_ns = 0;     // handler returned
+};
+
+// Who a command's results go to. Set by the code that builds the envelope, never by the wire.
+enum class CommandOrigin : uint8_t {
+    Client = 0,  // a command link: acks and task reports are published to the client
+    Mission = 1, // a MissionEngine step: they go back to the engine
+};
+
 struct CommandEnvelope {
     arcraven::ugv::UgvCommand command = arcraven::ugv::UgvCommand::Stop;
     arcraven::ugv::CommandDomain domain = arcraven::ugv::CommandDomain::Mobility;
@@ -24,9 +45,16 @@ struct CommandEnvelope {
     uint64_t issued_ns = 0;      // monotonic timestamp in ns (optional)
     uint64_t ttl_ns = 0;         // 0 = no expiry
 
-    // Placeholder payload. Replace with a variant/flatbuffer/protobuf later.
-    // Keep it string for now so you can wire it quickly over Iceoryx2.
-    std::string payload_json;
+    // Raw payload bytes as received on the wire. Inline for small commands, slab-backed for
+    // large ones, so moving an envelope through the router never allocates. Cleared at ingress
+    // once a FollowPath is decoded: its waypoints are in typed.
+    CommandPayload payload_json;
+
+    // Decoded and validated form of payload_json, filled on the IO thread before submit.
+    TypedPayload typed;
+
+    CommandStamps stamps;
+    CommandOrigin origin = CommandOrigin::Client;
 };
 
 struct CommandResult {
@@ -0,0 +1,46 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "command/CommandTypes.hpp"
+
+namespace arcraven::ugv {
+
+// Handler signature: execute should be fast and non-blocking. Heavy work must be staged
+// into other subsystems (e.g., set an atomic target for the control thread).
+using CommandHandler = std::function<CommandResult(const CommandEnvelope&)>;
+
+// UgvCommand ids are grouped by hundreds (100 = Mobility ... 800 = Authority) with small offsets,
+// so (group, offset) maps onto a dense array without hashing.
+inline constexpr size_t kCommandGroups = 8;
+inline constexpr size_t kCommandGroupStride = 16;
+inline constexpr size_t kHandlerSlots = kCommandGroups * kCommandGroupStride;
+inline constexpr size_t kNoHandlerSlot = kHandlerSlots;
+
+constexpr size_t command_slot(arcraven::ugv::UgvCommand cmd) {
+    const auto id = static_cast<uint16_t>(cmd);
+    const size_t group = id / 100u;
+    const size_t offset = id % 100u;
+    if (group == 0 || group > kCommandGroups || offset >= kCommandGroupStride) return kNoHandlerSlot;
+    return (group - 1) * kCommandGroupStride + offset;
+}
+
+static_assert(command_slot(arcraven::ugv::UgvCommand::FollowPath) == 0);
+static_assert(command_slot(arcraven::ugv::UgvCommand::Dock) < kCommandGroupStride);
+static_assert(command_slot(arcraven::ugv::UgvCommand::UnlockCommandSet) < kHandlerSlots);
+static_assert(command_slot(static_cast<arcraven::ugv::UgvCommand>(0)) == kNoHandlerSlot);
+
+// Immutable once published: the router builds a new table per registration and swaps a pointer,
+// so dispatch is two loads (table, slot) with no lock, hash or std::function copy.
+struct HandlerTable {
+    std::array<const CommandHandler*, kHandlerSlots> slots{};
+
+    const CommandHandler* find(arcraven::ugv::UgvCommand cmd) const {
+        const size_t slot = command_slot(cmd);
+        return slot < kHandlerSlots ? slots[slot] : nullptr;
+    }
+};
+
+} // namespace arcraven::ugv
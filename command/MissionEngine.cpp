@@ -0,0 +1,255 @@
+#include "command/MissionEngine.hpp"
+
+#include <charconv>
+#include <type_traits>
+#include <variant>
+
+#include "command/CommandRegistry.hpp"
+
+namespace arcraven::ugv {
+
+namespace {
+
+constexpr uint16_t kUnset = 0xFFFE;
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) s.remove_suffix(1);
+    return s;
+}
+
+template <typename T>
+bool parse_uint(std::string_view tok, T& out) {
+    const auto [ptr, ec] = std::from_chars(tok.data(), tok.data() + tok.size(), out);
+    return !tok.empty() && ec == std::errc{} && ptr == tok.data() + tok.size();
+}
+
+const CommandInfo* find_command(std::string_view tok) {
+    uint16_t id = 0;
+    if (parse_uint(tok, id)) return command_info(static_cast<arcraven::ugv::UgvCommand>(id));
+    for (const CommandInfo& info : kCommandRegistry) {
+        if (info.name == tok) return &info;
+    }
+    return nullptr;
+}
+
+bool is_mission_control(arcraven::ugv::UgvCommand cmd) {
+    return cmd == arcraven::ugv::UgvCommand::ExecuteMission || cmd == arcraven::ugv::UgvCommand::AbortMission ||
+           cmd == arcraven::ugv::UgvCommand::PauseMission || cmd == arcraven::ugv::UgvCommand::ResumeMission;
+}
+
+// "<command>[><next>][!<on_fail>]"
+bool parse_head(std::string_view head, MissionStep& step, const char*& error) {
+    const size_t mark = head.find_first_of(">!");
+    const CommandInfo* info = find_command(head.substr(0, mark));
+    if (!info) {
+        error = "unknown command in mission";
+        return false;
+    }
+    if (is_mission_control(info->command)) {
+        error = "mission control command used as a step";
+        return false;
+    }
+    step.command = info->command;
+    step.domain = info->domain;
+    step.next = kUnset;
+    step.on_fail = kMissionEnd;
+
+    head = mark == std::string_view::npos ? std::string_view{} : head.substr(mark);
+    while (!head.empty()) {
+        const char kind = head.front();
+        head.remove_prefix(1);
+        const size_t end = head.find_first_of(">!");
+        uint16_t target = 0;
+        if (!parse_uint(head.substr(0, end), target) || target >= MissionGraph::kMaxSteps) {
+            error = "bad step index";
+            return false;
+        }
+        (kind == '>' ? step.next : step.on_fail) = target;
+        head = end == std::string_view::npos ? std::string_view{} : head.substr(end);
+    }
+    return true;
+}
+
+bool succeeded(arcraven::ugv::CommandStatus s) {
+    return s == arcraven::ugv::CommandStatus::Succeeded || s == arcraven::ugv::CommandStatus::Accepted ||
+           s == arcraven::ugv::CommandStatus::None;
+}
+
+} // namespace
+
+bool compile_mission(std::string_view definition, MissionGraph& out, const char*& error) {
+    out.clear();
+
+    while (!definition.empty()) {
+        const size_t eol = definition.find('\n');
+        const std::string_view line = trim(definition.substr(0, eol));
+        definition = eol == std::string_view::npos ? std::string_view{} : definition.substr(eol + 1);
+        if (line.empty() || line.front() == '#') continue;
+
+        if (out.steps.size() == MissionGraph::kMaxSteps) {
+            error = "too many mission steps";
+            return false;
+        }
+
+        const size_t space = line.find_first_of(" \t");
+        const std::string_view head = line.substr(0, space);
+        const std::string_view payload = space == std::string_view::npos ? std::string_view{} : trim(line.substr(space));
+
+        MissionStep step{};
+        if (!parse_head(head, step, error)) return false;
+        if (!decode_typed_payload(step.command, payload, step.typed, error)) return false;
+
+        step.text_offset = static_cast<uint32_t>(out.text.size());
+        step.text_size = static_cast<uint32_t>(payload.size());
+        out.text.append(payload);
+
+        if (auto* path = std::get_if<FollowPathPayload>(&step.typed)) {
+            step.points_offset = static_cast<uint32_t>(out.points.size());
+            step.points_size = static_cast<uint32_t>(path->size() * sizeof(Point2D));
+            out.points.append(path->points.view());
+            path->points.clear(); // hands the slab block back
+        }
+        out.steps.push_back(std::move(step));
+    }
+
+    if (out.steps.empty()) {
+        error = "empty mission";
+        return false;
+    }
+
+    const auto n = static_cast<uint16_t>(out.steps.size());
+    for (uint16_t i = 0; i < n; ++i) {
+        MissionStep& s = out.steps[i];
+        if (s.next == kUnset) s.next = i + 1 < n ? static_cast<uint16_t>(i + 1) : kMissionEnd;
+        if ((s.next != kMissionEnd && s.next >= n) || (s.on_fail != kMissionEnd && s.on_fail >= n)) {
+            error = "step index out of range";
+            return false;
+        }
+    }
+    return true;
+}
+
+MissionEngine::MissionEngine() {
+    reports_.reserve(8);
+}
+
+CommandResult MissionEngine::execute(const CommandEnvelope& cmd) {
+    const char* error = "";
+    if (!compile_mission(cmd.payload_json.view(), staging_, error)) {
+        return {arcraven::ugv::CommandStatus::Rejected, arcraven::ugv::RejectReason::InvalidPayload, error};
+    }
+    if (active()) {
+        finish(arcraven::ugv::CommandStatus::Preempted, "superseded by " + std::to_string(cmd.command_id));
+    }
+
+    std::swap(graph_, staging_);
+    ++generation_;
+    phase_ = Phase::Ready;
+    paused_ = false;
+    pc_ = 0;
+    mission_id_ = cmd.command_id;
+    authority_ = cmd.authority;
+    return {arcraven::ugv::CommandStatus::Running, arcraven::ugv::RejectReason::None,
+            "mission started (" + std::to_string(graph_.steps.size()) + " steps)"};
+}
+
+CommandResult MissionEngine::pause() {
+    if (!active()) {
+        return {arcraven::ugv::CommandStatus::Rejected, arcraven::ugv::RejectReason::PreconditionsFail, "no mission"};
+    }
+    if (!paused_) {
+        paused_ = true;
+        reports_.emplace_back(mission_id_, CommandResult{arcraven::ugv::CommandStatus::Running,
+                                                         arcraven::ugv::RejectReason::None, "paused"});
+    }
+    return {arcraven::ugv::CommandStatus::Succeeded, arcraven::ugv::RejectReason::None, "paused"};
+}
+
+CommandResult MissionEngine::resume() {
+    if (!active()) {
+        return {arcraven::ugv::CommandStatus::Rejected, arcraven::ugv::RejectReason::PreconditionsFail, "no mission"};
+    }
+    if (paused_) {
+        paused_ = false;
+        reports_.emplace_back(mission_id_, CommandResult{arcraven::ugv::CommandStatus::Running,
+                                                         arcraven::ugv::RejectReason::None, "resumed"});
+    }
+    return {arcraven::ugv::CommandStatus::Succeeded, arcraven::ugv::RejectReason::None, "resumed"};
+}
+
+void MissionEngine::abort(arcraven::ugv::CommandStatus status, const std::string& why) {
+    if (active()) finish(status, why);
+}
+
+void MissionEngine::on_step_report(uint64_t command_id, const CommandResult& r) {
+    if (phase_ == Phase::Waiting && command_id == step_id_ && r.status != arcraven::ugv::CommandStatus::Running) {
+        on_step_result(r);
+    }
+}
+
+void MissionEngine::build_step(uint64_t now_ns, CommandEnvelope& env) {
+    const MissionStep& step = graph_.steps[pc_];
+    const CommandInfo* info = command_info(step.command);
+
+    step_id_ = kStepIdBit | ++step_seq_;
+    env.command = step.command;
+    env.domain = step.domain;
+    env.priority = info ? info->default_priority : arcraven::ugv::CommandPriority::Normal;
+    env.authority = authority_;
+    env.command_id = step_id_;
+    env.issued_ns = now_ns;
+    env.origin = CommandOrigin::Mission;
+    std::visit([&](const auto& p) {
+        using T = std::decay_t<decltype(p)>;
+        if constexpr (std::is_same_v<T, FollowPathPayload>) {
+            FollowPathPayload path;
+            (void)path.points.assign(std::string_view(graph_.points).substr(step.points_offset, step.points_size));
+            env.typed = std::move(path); // no wire text, as for client FollowPaths
+        } else {
+            (void)env.payload_json.assign(std::string_view(graph_.text).substr(step.text_offset, step.text_size));
+            env.typed = p;
+        }
+    }, step.typed);
+
+    // "step <n>/<count>": at most 12 characters, so the message stays in std::string's inline
+    // buffer and a step costs no allocation.
+    char text[16] = "step ";
+    char* end = std::to_chars(text + 5, text + sizeof(text), pc_ + 1).ptr;
+    *end++ = '/';
+    end = std::to_chars(end, text + sizeof(text), graph_.steps.size()).ptr;
+    reports_.emplace_back(mission_id_, CommandResult{arcraven::ugv::CommandStatus::Running, arcraven::ugv::RejectReason::None,
+                                                     std::string(text, end)});
+}
+
+void MissionEngine::on_step_result(const CommandResult& r) {
+    if (r.status == arcraven::ugv::CommandStatus::Running) {
+        phase_ = Phase::Waiting;
+        return;
+    }
+
+    const MissionStep& step = graph_.steps[pc_];
+    const bool ok = succeeded(r.status);
+    const uint16_t target = ok ? step.next : step.on_fail;
+    if (target != kMissionEnd) {
+        pc_ = target;
+        phase_ = Phase::Ready;
+        return;
+    }
+    if (ok) {
+        finish(arcraven::ugv::CommandStatus::Succeeded, "mission complete");
+    } else {
+        finish(arcraven::ugv::CommandStatus::Failed, "step " + std::to_string(pc_ + 1) + " (" +
+                                                         std::string(command_name(step.command)) + ") failed: " + r.message);
+    }
+}
+
+void MissionEngine::finish(arcraven::ugv::CommandStatus status, std::string message) {
+    reports_.emplace_back(mission_id_, CommandResult{status, arcraven::ugv::RejectReason::None, std::move(message)});
+    phase_ = Phase::Idle;
+    paused_ = false;
+    step_id_ = 0;
+    ++generation_;
+}
+
+} // namespace arcraven::ugv
@@ -0,0 +1,125 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "command/CommandTypes.hpp"
+
+namespace arcraven::ugv {
+
+inline constexpr uint16_t kMissionEnd = 0xFFFF;
+
+// One precompiled step. Payloads are validated and decoded when the mission is loaded; the raw
+// text and FollowPath waypoints live in the graph's shared arenas so steps stay small and the
+// graph does not hold PayloadSlab blocks for the mission's lifetime.
+struct MissionStep {
+    arcraven::ugv::UgvCommand command = arcraven::ugv::UgvCommand::Wait;
+    arcraven::ugv::CommandDomain domain = arcraven::ugv::CommandDomain::Mission;
+    uint16_t next = kMissionEnd;    // after success; kMissionEnd = mission complete
+    uint16_t on_fail = kMissionEnd; // after failure; kMissionEnd = mission failed
+    uint32_t text_offset = 0;       // raw payload in MissionGraph::text
+    uint32_t text_size = 0;
+    uint32_t points_offset = 0;     // packed Point2D records in MissionGraph::points (FollowPath)
+    uint32_t points_size = 0;
+    TypedPayload typed;             // a FollowPathPayload here is empty; see points_*
+};
+
+struct MissionGraph {
+    static constexpr size_t kMaxSteps = 256;
+
+    std::vector<MissionStep> steps;
+    std::string text;
+    std::string points;
+
+    void clear() {
+        steps.clear();
+        text.clear();
+        points.clear();
+    }
+};
+
+// Compiles an ExecuteMission payload. One step per line ('#' starts a comment):
+//
+//   <command>[><next>][!<on_fail>] [payload]
+//
+// command is a registry name (GoTo) or wire id (101); payload uses that command's wire format.
+// next/on_fail are 0-based step indices and may point backwards (patrol loops); by default a
+// step continues with the following line and a failure fails the mission. Mission-control
+// commands cannot be steps. On failure returns false with a short static error.
+bool compile_mission(std::string_view definition, MissionGraph& out, const char*& error);
+
+// Runs one mission at a time from the control loop.
+//
+// ExecuteMission compiles the graph once; after that the engine only moves an index through
+// it: tick() dispatches at most one step, and a step that starts a long-running task waits for
+// that task's final report (fed back through on_step_report). Pause, resume and abort flip the
+// engine state in O(1); a step already in flight runs to completion before a pause takes hold.
+// Mission progress and the final outcome are reported against the ExecuteMission command id.
+// Not thread-safe: call everything from the control thread.
+class MissionEngine final {
+public:
+    MissionEngine();
+
+    // ExecuteMission. Replaces (Preempted) a running mission once the new one has compiled.
+    CommandResult execute(const CommandEnvelope& cmd);
+    CommandResult pause();
+    CommandResult resume();
+    // AbortMission, Stop, E-STOP. No-op without a mission.
+    void abort(arcraven::ugv::CommandStatus status, const std::string& why);
+
+    bool active() const { return phase_ != Phase::Idle; }
+
+    // Step commands are built with CommandOrigin::Mission: their acks and task reports belong to
+    // the engine, not to a client. Their ids have this bit set, which only tells them apart in
+    // logs and the journal.
+    static constexpr uint64_t kStepIdBit = uint64_t{1} << 63;
+
+    // Executor report for a task started by a step command (origin Mission).
+    void on_step_report(uint64_t command_id, const CommandResult& r);
+
+    // Dispatches the next step (if any) through dispatch(const CommandEnvelope&) -> CommandResult,
+    // then hands progress/final reports to on_result(command_id, result).
+    template <typename Dispatch, typename Fn>
+    void tick(uint64_t now_ns, Dispatch&& dispatch, Fn&& on_result) {
+        if (phase_ == Phase::Ready && !paused_) {
+            CommandEnvelope env{};
+            build_step(now_ns, env);
+            const uint64_t generation = generation_;
+            const CommandResult r = dispatch(env);
+            // The step itself may have ended the mission (Stop, EmergencyStop).
+            if (generation == generation_) on_step_result(r);
+        }
+        for (const auto& r : reports_) on_result(r.first, r.second);
+        reports_.clear();
+    }
+
+private:
+    enum class Phase : uint8_t {
+        Idle,
+        Ready,   // pc_ is dispatched on the next tick (unless paused)
+        Waiting, // pc_ is running as a task with id step_id_
+    };
+
+    void build_step(uint64_t now_ns, CommandEnvelope& env);
+    void on_step_result(const CommandResult& r);
+    void finish(arcraven::ugv::CommandStatus status, std::string message);
+
+    MissionGraph graph_;
+    MissionGraph staging_; // compile target; swapped in on success so a bad load keeps the old graph
+
+    Phase phase_ = Phase::Idle;
+    bool paused_ = false;
+    uint16_t pc_ = 0;
+    uint64_t generation_ = 0;
+    uint64_t mission_id_ = 0;
+    arcraven::ugv::CommandAuthority authority_ = arcraven::ugv::CommandAuthority::Unknown;
+    uint64_t step_seq_ = 0;
+    uint64_t step_id_ = 0;
+
+    std::vector<std::pair<uint64_t, CommandResult>> reports_;
+};
+
+} // namespace arcraven::ugv
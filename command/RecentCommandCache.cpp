@@ -0,0 +1,113 @@
+#include "command/RecentCommandCache.hpp"
+
+namespace arcraven::ugv {
+
+RecentCommandCache::RecentCommandCache(size_t window) : window_(window) {
+    if (window_ == 0) return;
+
+    size_t cap = kProbe;
+    while (cap < window_ * 2) cap <<= 1u;
+    mask_ = cap - 1;
+    slots_ = std::make_unique<Slot[]>(cap);
+}
+
+size_t RecentCommandCache::home(uint64_t command_id) const {
+    // Fibonacci hashing; probe groups are aligned so a lookup touches at most two cache lines.
+    const uint64_t h = command_id * 0x9E3779B97F4A7C15ull;
+    return static_cast<size_t>(h >> 20u) & mask_ & ~(kProbe - 1);
+}
+
+bool RecentCommandCache::in_window(uint64_t meta) const {
+    const uint64_t seq = meta >> 16u;
+    return seq != 0 && seq_.load(std::memory_order_relaxed) - seq <= window_;
+}
+
+std::optional<CommandResult> RecentCommandCache::lookup(uint64_t command_id) const {
+    if (!enabled() || command_id == 0) return std::nullopt;
+
+    const size_t base = home(command_id);
+    for (size_t i = 0; i < kProbe; ++i) {
+        const Slot& s = slots_[base + i];
+        if (s.id.load(std::memory_order_acquire) != command_id) continue;
+
+        const uint64_t meta = s.meta.load(std::memory_order_acquire);
+        if (meta == kBusy) {
+            // Being inserted right now by another producer: it was accepted.
+            return CommandResult{arcraven::ugv::CommandStatus::Accepted, arcraven::ugv::RejectReason::None, "duplicate"};
+        }
+        if (!in_window(meta)) return std::nullopt;
+
+        const auto status = static_cast<arcraven::ugv::CommandStatus>((meta >> 8u) & 0xFFu);
+        const auto reason = static_cast<arcraven::ugv::RejectReason>(meta & 0xFFu);
+        // A transient Busy rejection is not an execution; let the retransmit through.
+        if (status == arcraven::ugv::CommandStatus::Rejected && reason == arcraven::ugv::RejectReason::Busy) {
+            return std::nullopt;
+        }
+        return CommandResult{status, reason, "duplicate"};
+    }
+    return std::nullopt;
+}
+
+void RecentCommandCache::insert(uint64_t command_id) {
+    if (!enabled() || command_id == 0) return;
+
+    const uint64_t seq = seq_.fetch_add(1, std::memory_order_relaxed);
+    const CommandResult accepted{arcraven::ugv::CommandStatus::Accepted, arcraven::ugv::RejectReason::None, ""};
+    const size_t base = home(command_id);
+
+    for (;;) {
+        // Victim: the id's own slot if it is still cached (a retransmit after a Busy rejection),
+        // else an empty/expired slot, otherwise the oldest entry in the probe group. Reusing the
+        // id's slot keeps one entry per id, so lookup() and record() cannot pick a stale one.
+        size_t victim = SIZE_MAX;
+        uint64_t victim_meta = 0;
+        uint64_t victim_seq = UINT64_MAX;
+        for (size_t i = 0; i < kProbe; ++i) {
+            const uint64_t meta = slots_[base + i].meta.load(std::memory_order_acquire);
+            if (meta == kBusy) continue;
+            if (meta != 0 && slots_[base + i].id.load(std::memory_order_acquire) == command_id) {
+                victim_meta = meta;
+                victim = base + i;
+                break;
+            }
+            const uint64_t s = in_window(meta) ? (meta >> 16u) : 0;
+            if (s < victim_seq) {
+                victim_seq = s;
+                victim_meta = meta;
+                victim = base + i;
+            }
+        }
+        if (victim == SIZE_MAX) continue; // whole group mid-rewrite by other producers
+
+        // Claim the slot by flipping its meta to kBusy; only one producer can win the CAS.
+        Slot& slot = slots_[victim];
+        if (!slot.meta.compare_exchange_strong(victim_meta, kBusy, std::memory_order_acq_rel)) continue;
+        slot.id.store(command_id, std::memory_order_release);
+        slot.meta.store(pack(seq, accepted), std::memory_order_release);
+        return;
+    }
+}
+
+void RecentCommandCache::record(uint64_t command_id, const CommandResult& result) {
+    if (!enabled() || command_id == 0) return;
+
+    const size_t base = home(command_id);
+    for (size_t i = 0; i < kProbe; ++i) {
+        Slot& s = slots_[base + i];
+        if (s.id.load(std::memory_order_acquire) != command_id) continue;
+
+        uint64_t meta = s.meta.load(std::memory_order_acquire);
+        for (;;) {
+            // A producer is rewriting the slot (a few stores); wait for it rather than drop the
+            // final status, then make sure the slot still holds this id.
+            if (meta == kBusy) {
+                meta = s.meta.load(std::memory_order_acquire);
+                continue;
+            }
+            if (meta == 0 || s.id.load(std::memory_order_acquire) != command_id) break;
+            if (s.meta.compare_exchange_weak(meta, pack(meta >> 16u, result), std::memory_order_acq_rel)) return;
+        }
+    }
+}
+
+} // namespace arcraven::ugv
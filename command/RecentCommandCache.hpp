@@ -0,0 +1,60 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include "command/CommandTypes.hpp"
+
+namespace arcraven::ugv {
+
+// Fixed-memory set of recently accepted command_ids with their latest status, used to answer
+// client retransmits without executing the command twice.
+//
+// Open addressing with a short probe group; an id is remembered while it is among the last
+// `window` insertions (older entries are overwritten first). Lock-free for any number of
+// producers plus the consumer. Two producers inserting the *same* id in the same instant can
+// both miss each other; retransmits are paced by ack timeouts, so that window is not a concern.
+class RecentCommandCache final {
+public:
+    explicit RecentCommandCache(size_t window);
+
+    bool enabled() const { return window_ != 0; }
+
+    // Returns the cached result if command_id was accepted within the window.
+    std::optional<CommandResult> lookup(uint64_t command_id) const;
+
+    // Remembers command_id as Accepted. Called before the command is queued, so neither a
+    // retransmit nor the command's own final record() can get ahead of it.
+    void insert(uint64_t command_id);
+
+    // Updates the cached status (consumer thread with the final result, or a producer undoing
+    // insert() with a Busy rejection, which lets the next retransmit through).
+    void record(uint64_t command_id, const CommandResult& result);
+
+private:
+    static constexpr size_t kProbe = 8;
+
+    // meta = (insert_seq << 16) | (status << 8) | reject_reason. 0 = empty, kBusy = being rewritten.
+    static constexpr uint64_t kBusy = 1;
+
+    struct Slot {
+        std::atomic<uint64_t> id{0};
+        std::atomic<uint64_t> meta{0};
+    };
+
+    static uint64_t pack(uint64_t seq, const CommandResult& r) {
+        return (seq << 16u) | (static_cast<uint64_t>(r.status) << 8u) | static_cast<uint64_t>(r.reject_reason);
+    }
+
+    size_t home(uint64_t command_id) const;
+    bool in_window(uint64_t meta) const;
+
+    size_t window_;
+    size_t mask_ = 0;
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<uint64_t> seq_{1};
+};
+
+} // namespace arcraven::ugv
@@ -0,0 +1,236 @@
+#include "command/TypedPayload.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <system_error>
+
+namespace arcraven::ugv {
+
+namespace {
+
+constexpr size_t kMaxWaypoints = CommandPayload::kMaxSize / sizeof(Point2D);
+
+// Splits off the next token up to delim (or end). Returns false once input is exhausted.
+bool next_token(std::string_view& in, char delim, std::string_view& tok) {
+    if (in.data() == nullptr) return false;
+    const size_t pos = in.find(delim);
+    if (pos == std::string_view::npos) {
+        tok = in;
+        in = std::string_view{};
+        return true;
+    }
+    tok = in.substr(0, pos);
+    in.remove_prefix(pos + 1);
+    return true;
+}
+
+bool parse_double(std::string_view tok, double& out) {
+    if (tok.empty()) return false;
+    const char* end = tok.data() + tok.size();
+    const auto r = std::from_chars(tok.data(), end, out);
+    return r.ec == std::errc{} && r.ptr == end && std::isfinite(out);
+}
+
+template <typename T>
+bool parse_uint(std::string_view tok, T& out) {
+    if (tok.empty()) return false;
+    const char* end = tok.data() + tok.size();
+    const auto r = std::from_chars(tok.data(), end, out);
+    return r.ec == std::errc{} && r.ptr == end;
+}
+
+bool parse_point(std::string_view& in, Point2D& p) {
+    std::string_view tok;
+    return next_token(in, '|', tok) && parse_double(tok, p.x) &&
+           next_token(in, '|', tok) && parse_double(tok, p.y);
+}
+
+bool decode_goto(std::string_view raw, TypedPayload& out, const char*& error) {
+    GoToPayload p{};
+    if (!parse_point(raw, p.target)) {
+        error = "expected x|y[|heading]";
+        return false;
+    }
+    std::string_view tok;
+    if (next_token(raw, '|', tok)) {
+        if (!parse_double(tok, p.heading_rad) || raw.data() != nullptr) {
+            error = "expected x|y[|heading]";
+            return false;
+        }
+        p.has_heading = true;
+    }
+    out = p;
+    return true;
+}
+
+bool decode_follow_path(std::string_view raw, TypedPayload& out, const char*& error) {
+    size_t count = 1;
+    for (const char c : raw) count += (c == ';') ? 1 : 0;
+    if (raw.empty() || count > kMaxWaypoints) {
+        error = "waypoint count out of range";
+        return false;
+    }
+
+    FollowPathPayload p{};
+    char* dst = p.points.prepare(count * sizeof(Point2D));
+    if (!dst) {
+        error = kPayloadStorageExhausted;
+        return false;
+    }
+
+    std::string_view wp;
+    for (size_t i = 0; i < count && next_token(raw, ';', wp); ++i) {
+        Point2D pt{};
+        if (!parse_point(wp, pt) || wp.data() != nullptr) {
+            error = "expected x|y;x|y;...";
+            return false;
+        }
+        std::memcpy(dst + i * sizeof(Point2D), &pt, sizeof(Point2D));
+    }
+    out = std::move(p);
+    return true;
+}
+
+bool decode_signal(std::string_view raw, TypedPayload& out, const char*& error) {
+    constexpr std::string_view kFlashlight = "flashlight|";
+    SignalPayload p{};
+    if (raw.substr(0, kFlashlight.size()) == kFlashlight) {
+        raw.remove_prefix(kFlashlight.size());
+        std::string_view id_tok;
+        std::string_view state_tok;
+        if (!next_token(raw, '|', id_tok) || !parse_uint(id_tok, p.id) ||
+            !next_token(raw, '|', state_tok) || raw.data() != nullptr ||
+            (state_tok != "0" && state_tok != "1")) {
+            error = "expected flashlight|<id>|<0|1>";
+            return false;
+        }
+        p.kind = SignalKind::Flashlight;
+        p.on = state_tok == "1";
+    }
+    out = p;
+    return true;
+}
+
+constexpr auto kMaxAuthority = arcraven::ugv::CommandAuthority::SafetySystem;
+constexpr auto kMaxDomain = arcraven::ugv::CommandDomain::Authority;
+
+bool parse_authority(std::string_view tok, arcraven::ugv::CommandAuthority& out) {
+    uint8_t v = 0;
+    if (!parse_uint(tok, v) || v > static_cast<uint8_t>(kMaxAuthority)) return false;
+    out = static_cast<arcraven::ugv::CommandAuthority>(v);
+    return true;
+}
+
+bool decode_ownership(std::string_view raw, TypedPayload& out, const char*& error) {
+    OwnershipPayload p{};
+    std::string_view dom_tok;
+    std::string_view auth_tok;
+    uint8_t dom = 0;
+    if (!next_token(raw, '|', dom_tok) || !parse_uint(dom_tok, dom) || dom > static_cast<uint8_t>(kMaxDomain) ||
+        !next_token(raw, '|', auth_tok) || raw.data() != nullptr || !parse_authority(auth_tok, p.owner)) {
+        error = "expected <domain>|<authority>";
+        return false;
+    }
+    p.domain = static_cast<arcraven::ugv::CommandDomain>(dom);
+    out = p;
+    return true;
+}
+
+bool decode_command_set(std::string_view raw, bool allow_empty, TypedPayload& out, const char*& error) {
+    CommandSetPayload p{};
+    if (raw.empty()) {
+        if (!allow_empty) {
+            error = "expected <command>[,<command>...]";
+            return false;
+        }
+        out = p;
+        return true;
+    }
+
+    std::string_view tok;
+    while (next_token(raw, ',', tok)) {
+        uint16_t id = 0;
+        if (p.count == CommandSetPayload::kMaxCommands || !parse_uint(tok, id)) {
+            error = "expected 1..32 command ids";
+            return false;
+        }
+        p.commands[p.count++] = static_cast<arcraven::ugv::UgvCommand>(id);
+    }
+    out = p;
+    return true;
+}
+
+} // namespace
+
+bool decode_typed_payload(arcraven::ugv::UgvCommand cmd, std::string_view raw, TypedPayload& out,
+                          const char*& error) {
+    using arcraven::ugv::UgvCommand;
+    error = "";
+
+    switch (cmd) {
+        case UgvCommand::GoTo:
+        case UgvCommand::ReplanTo:
+            return decode_goto(raw, out, error);
+
+        case UgvCommand::FollowPath:
+            return decode_follow_path(raw, out, error);
+
+        case UgvCommand::SetSpeedLimit: {
+            SpeedLimitPayload p{};
+            if (!parse_double(raw, p.mps) || p.mps < 0.0) {
+                error = "expected speed limit >= 0";
+                return false;
+            }
+            out = p;
+            return true;
+        }
+
+        case UgvCommand::AlignHeading: {
+            HeadingPayload p{};
+            if (!parse_double(raw, p.heading_rad)) {
+                error = "expected heading";
+                return false;
+            }
+            out = p;
+            return true;
+        }
+
+        case UgvCommand::FaceTarget: {
+            FaceTargetPayload p{};
+            if (!parse_point(raw, p.target) || raw.data() != nullptr) {
+                error = "expected x|y";
+                return false;
+            }
+            out = p;
+            return true;
+        }
+
+        case UgvCommand::Signal:
+            return decode_signal(raw, out, error);
+
+        case UgvCommand::SetOwnership:
+            return decode_ownership(raw, out, error);
+
+        case UgvCommand::LockCommandSet:
+            return decode_command_set(raw, /*allow_empty=*/false, out, error);
+
+        case UgvCommand::UnlockCommandSet:
+            return decode_command_set(raw, /*allow_empty=*/true, out, error);
+
+        case UgvCommand::HandoffControl: {
+            HandoffPayload p{};
+            if (!parse_authority(raw, p.to) || p.to == arcraven::ugv::CommandAuthority::Unknown) {
+                error = "expected target authority";
+                return false;
+            }
+            out = p;
+            return true;
+        }
+
+        default:
+            out = std::monostate{};
+            return true;
+    }
+}
+
+} // namespace arcraven::ugv
@@ -0,0 +1,113 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <variant>
+
+#include "command/CommandPayload.hpp"
+#include "models/enums/CommandAuthority.hpp"
+#include "models/enums/CommandDomain.hpp"
+#include "models/enums/UgvCommand.hpp"
+
+namespace arcraven::ugv {
+
+// Binary, pre-validated command payloads. The bridge decodes the wire text once on the IO
+// thread; handlers on the control thread only read these structs.
+//
+// Wire text formats (fields are '|'-separated, waypoints ';'-separated):
+//   GoTo / ReplanTo   x|y[|heading_rad]
+//   FollowPath        x|y;x|y;...            (1..256 waypoints)
+//   SetSpeedLimit     mps                    (>= 0)
+//   AlignHeading      heading_rad
+//   FaceTarget        x|y
+//   Signal            flashlight|<id>|<0|1>  (other Signal payloads pass through as Generic)
+//   SetOwnership      <domain>|<authority>   (authority 0 releases the domain)
+//   LockCommandSet    <command>[,<command>...]   (1..32 UgvCommand wire ids)
+//   UnlockCommandSet  [<command>[,<command>...]] (empty = every lock held by the issuer)
+//   HandoffControl    <authority>
+
+struct Point2D {
+    double x = 0.0;
+    double y = 0.0;
+};
+
+struct GoToPayload {
+    Point2D target{};
+    double heading_rad = 0.0;
+    bool has_heading = false;
+};
+
+struct FollowPathPayload {
+    // Packed Point2D records in inline/slab storage (keeps the envelope small and allocation-free).
+    CommandPayload points;
+
+    size_t size() const { return points.size() / sizeof(Point2D); }
+    Point2D at(size_t i) const {
+        Point2D p{};
+        std::memcpy(&p, points.data() + i * sizeof(Point2D), sizeof(Point2D));
+        return p;
+    }
+};
+
+struct SpeedLimitPayload {
+    double mps = 0.0;
+};
+
+struct HeadingPayload {
+    double heading_rad = 0.0;
+};
+
+struct FaceTargetPayload {
+    Point2D target{};
+};
+
+enum class SignalKind : uint8_t {
+    Generic = 0,
+    Flashlight = 1,
+};
+
+struct SignalPayload {
+    SignalKind kind = SignalKind::Generic;
+    uint16_t id = 0;
+    bool on = false;
+};
+
+struct OwnershipPayload {
+    arcraven::ugv::CommandDomain domain = arcraven::ugv::CommandDomain::Mobility;
+    arcraven::ugv::CommandAuthority owner = arcraven::ugv::CommandAuthority::Unknown;
+};
+
+struct CommandSetPayload {
+    static constexpr size_t kMaxCommands = 32;
+    std::array<arcraven::ugv::UgvCommand, kMaxCommands> commands{};
+    uint8_t count = 0; // 0 = every command (UnlockCommandSet only)
+};
+
+struct HandoffPayload {
+    arcraven::ugv::CommandAuthority to = arcraven::ugv::CommandAuthority::Unknown;
+};
+
+// std::monostate = command has no typed schema; handlers may still read the raw bytes.
+using TypedPayload = std::variant<std::monostate,
+                                  GoToPayload,
+                                  FollowPathPayload,
+                                  SpeedLimitPayload,
+                                  HeadingPayload,
+                                  FaceTargetPayload,
+                                  SignalPayload,
+                                  OwnershipPayload,
+                                  CommandSetPayload,
+                                  HandoffPayload>;
+
+// decode_typed_payload's error when no PayloadSlab block is free. Unlike the other errors it is
+// transient: links report it as Busy so the client retries.
+inline constexpr const char* kPayloadStorageExhausted = "payload storage exhausted";
+
+// Decodes and validates raw payload bytes for cmd. On failure returns false and sets error to a
+// short static string suitable for a CommandResult message.
+bool decode_typed_payload(arcraven::ugv::UgvCommand cmd, std::string_view raw, TypedPayload& out,
+                          const char*& error);
+
+} // namespace arcraven::ugv
@@ -1,10 +1,21 @@
 #pragma once
 #include <filesystem>
 
+#include "command/CommandExecutor.hpp"
+#include "command/CommandJournal.hpp"
+#include "command/CommandRouter.hpp"
 #include "core/Rate.hpp"
+#include "subsystems/JointDeltaEncoder.hpp"
+#include "subsystems/ShmCommandLink.hpp"
+#include "subsystems/TelemetryWriter.hpp"
 
 namespace arcraven::ugv {
 
+enum class CommandTransport : uint8_t {
+    SharedMemory = 0, // /dev/shm rings (ShmCommandLink), for ugv_api's ShmTransport
+    File = 1,         // commands.in / telemetry.<seq>.out, binary frames or text lines (Iceoryx2Bridge)
+};
+
 struct UgvConfig {
     std::filesystem::path data_dir;
 
@@ -18,6 +29,52 @@ struct UgvConfig {
     Rate sensor_rate{std::chrono::microseconds(10000)};    // 100 Hz
     Rate persist_rate{std::chrono::microseconds(1000000)}; // 1 Hz
     Rate estop_rate{std::chrono::microseconds(2000)};      // 500 Hz
+
+    // Latest-wins coalescing of resent teleop setpoints (GoTo, SetSpeedLimit, AlignHeading, FaceTarget).
+    CoalesceMode command_coalesce = CoalesceMode::Off;
+
+    // Per-tick budget and progress reporting of long-running commands (FollowPath, Dock, ...).
+    CommandExecutorConfig command_executor{};
+
+    // How commands, results and telemetry reach clients.
+    CommandTransport command_transport = CommandTransport::SharedMemory;
+    ShmLinkConfig shm_link{};
+
+    // File transport: pick up commands.in writes through inotify instead of reading the file every io tick. Turn
+    // off where inotify never fires (network filesystems); Linux only, polls elsewhere.
+    bool command_watch = true;
+
+    // File transport: switch telemetry output to binary frames once a client says Hello (see WireProtocol.hpp). Off
+    // keeps it text for reading by eye; commands.in takes both formats either way.
+    bool file_binary_framing = true;
+
+    // File transport: announce joint and sensor ids once per segment (schema record) and send frames with joint
+    // values in schema order and numeric sensor channels. Binary clients get it only if their Hello asks for it.
+    // Off repeats every id, name and type in each frame.
+    bool file_interned_telemetry = true;
+
+    // File transport, with interned telemetry: joint values as a keyframe every keyframe_interval frames and
+    // zigzag-varint deltas of the quantized values between them, for constrained links. Off by default; binary clients
+    // get it only if their Hello asks for it. Reconstruction is within resolution / 2 per field and never drifts.
+    JointDeltaConfig file_joint_delta{};
+
+    // File transport: telemetry buffering between the sensor and IO threads, whether it is fdatasync'ed
+    // (TelemetryDurability::Periodic, every sync_interval) or left to the kernel (None), and the segment files:
+    // rollover at segment_bytes / segment_age, oldest deleted beyond retention_bytes, a timestamp index entry every
+    // index_interval_bytes.
+    TelemetryWriterConfig telemetry_writer{};
+
+    // Queue credit/backpressure records ("F|...") in the telemetry stream.
+    std::chrono::milliseconds credit_interval{250};
+
+    // Binary journal of every executed command and task report (data_dir/commands.journal),
+    // readable with ugv_replay.
+    bool command_journal_enabled = true;
+    CommandJournalConfig command_journal{};
+
+    // Per-command latency summary in the log (0 disables). A full table is written to
+    // data_dir/latency.txt whenever data_dir/latency.request appears.
+    std::chrono::seconds latency_summary_period{60};
 };
 
 } // namespace arcraven::ugv
@@ -1,20 +1,75 @@
 #include "UgvCore.hpp"
 
+#include <algorithm>
+#include <charconv>
 #include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
 #include <string>
 #include <string_view>
+#include <variant>
 
 #include "utils/Logger.hpp"
 
 namespace arcraven::ugv {
 
+namespace {
+
+// Placeholder for behaviours that run over many control ticks; finishes on its first step.
+class StubTask final : public CommandTask {
+public:
+    explicit StubTask(std::string label) : label_(std::move(label)) {}
+
+    CommandResult step(uint64_t now_ns) override {
+        (void)now_ns;
+        // TODO: advance the real behaviour by one bounded slice and return Running until done.
+        return {arcraven::ugv::CommandStatus::Succeeded, arcraven::ugv::RejectReason::None, label_ + " done (stub)"};
+    }
+
+private:
+    std::string label_;
+};
+
+// Per-command trail, "<what>: id=<id> status=<n>", built on the stack. Debug level: the
+// logger drops it before formatting a line, so the default command path does not allocate.
+void log_command(std::string_view what, uint64_t command_id, arcraven::ugv::CommandStatus status) {
+    char text[64];
+    char* end = std::copy(what.begin(), what.end(), text);
+    end = std::copy_n(": id=", 5, end);
+    end = std::to_chars(end, text + sizeof(text), command_id).ptr;
+    end = std::copy_n(" status=", 8, end);
+    end = std::to_chars(end, text + sizeof(text), static_cast<int>(status)).ptr;
+    ARC_LOG_DEBUG(std::string_view(text, static_cast<size_t>(end - text)));
+}
+
+} // namespace
+
 UgvCore::UgvCore(UgvConfig cfg)
     : cfg_(std::move(cfg)),
       state_store_(cfg_.data_dir / "state.bin"),
       drives_(cfg_.expected_drives),
-      cmd_router_(CommandRouterConfig{.max_queue = 256}) {
-    cmd_link_.attach_router(&cmd_router_);
-    cmd_link_.configure_paths(cfg_.data_dir / "bridge");
+      cmd_router_(CommandRouterConfig{.max_queue = 256, .coalesce = cfg_.command_coalesce}),
+      cmd_executor_(cfg_.command_executor),
+      cmd_journal_(cfg_.command_journal) {
+    if (cfg_.command_transport == CommandTransport::File) {
+        file_link_.attach_router(&cmd_router_);
+        file_link_.attach_latency_stats(&cmd_latency_);
+        file_link_.configure_paths(cfg_.data_dir / "bridge");
+        file_link_.configure_credit_interval(cfg_.credit_interval);
+        file_link_.configure_command_watch(cfg_.command_watch);
+        file_link_.configure_binary_framing(cfg_.file_binary_framing);
+        file_link_.configure_interned_telemetry(cfg_.file_interned_telemetry);
+        file_link_.configure_joint_delta(cfg_.file_joint_delta);
+        file_link_.configure_telemetry_writer(cfg_.telemetry_writer);
+        cmd_link_ = &file_link_;
+    } else {
+        shm_link_.attach_router(&cmd_router_);
+        shm_link_.attach_latency_stats(&cmd_latency_);
+        shm_link_.configure(cfg_.shm_link);
+        shm_link_.configure_credit_interval(cfg_.credit_interval);
+        cmd_link_ = &shm_link_;
+    }
 }
 
 int UgvCore::run() {
@@ -57,6 +112,7 @@ int UgvCore::run() {
 
 void UgvCore::request_stop() {
     stop_.request_stop();
+    cmd_link_->wake();
 }
 
 bool UgvCore::hardware_bringup() {
@@ -64,7 +120,7 @@ bool UgvCore::hardware_bringup() {
 
     if (!drives_.init()) return false;
     if (!sensors_.init()) return false;
-    if (!cmd_link_.init()) return false;
+    if (!cmd_link_->init()) return false;
 
     return true;
 }
@@ -104,6 +160,10 @@ bool UgvCore::start_runtime() {
         return false;
     }
 
+    if (cfg_.command_journal_enabled && !cmd_journal_.open(cfg_.data_dir / "commands.journal")) {
+        ARC_LOG_WARN("Command journal unavailable; continuing without it");
+    }
+
     threads_.emplace_back(&UgvCore::control_thread, this);
     threads_.emplace_back(&UgvCore::sensor_thread, this);
     threads_.emplace_back(&UgvCore::io_thread, this);
@@ -122,6 +182,7 @@ void UgvCore::safe_shutdown() {
     ARC_LOG_WARN("Shutdown requested");
 
     stop_.request_stop();
+    cmd_link_->wake();
 
     if (estop_.latched()) {
         ARC_LOG_WARN("Shutdown while E-STOP latched: " + estop_.reason_string());
@@ -135,6 +196,19 @@ void UgvCore::safe_shutdown() {
     }
     threads_.clear();
 
+    if (cmd_link_->results_dropped() > 0) {
+        ARC_LOG_WARN("Command link dropped " + std::to_string(cmd_link_->results_dropped()) + " results (tx queue full)");
+    }
+    if (cmd_link_->telemetry_dropped() > 0) {
+        ARC_LOG_WARN("Command link dropped " + std::to_string(cmd_link_->telemetry_dropped()) + " telemetry frames (no room)");
+    }
+
+    // After the control thread has stopped appending.
+    cmd_journal_.close();
+    if (cmd_journal_.dropped() > 0) {
+        ARC_LOG_WARN("Command journal dropped " + std::to_string(cmd_journal_.dropped()) + " records");
+    }
+
     (void)state_store_.save(state_);
     ARC_LOG_INFO("Shutdown complete");
 }
@@ -144,142 +218,148 @@ uint64_t UgvCore::now_ns() const {
     return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
 }
 
+void UgvCore::report_command_latency(SteadyClock::time_point& next_summary) {
+    const auto now = SteadyClock::now();
+    if (cfg_.latency_summary_period.count() > 0 && now >= next_summary) {
+        next_summary = now + cfg_.latency_summary_period;
+        const std::string summary = cmd_latency_.summary();
+        size_t begin = 0;
+        for (size_t end = summary.find('\n'); end != std::string::npos; end = summary.find('\n', begin)) {
+            ARC_LOG_INFO("Cmd latency: " + summary.substr(begin, end - begin));
+            begin = end + 1;
+        }
+    }
+
+    std::error_code ec;
+    const auto request = cfg_.data_dir / "latency.request";
+    if (!std::filesystem::exists(request, ec)) return;
+
+    std::ofstream out(cfg_.data_dir / "latency.txt", std::ios::trunc);
+    out << cmd_latency_.report();
+    std::filesystem::remove(request, ec);
+    ARC_LOG_INFO("Cmd latency table written to " + (cfg_.data_dir / "latency.txt").string());
+}
+
 void UgvCore::register_default_command_handlers() {
+    // Table-driven: every command in the registry routes to execute_command.
+    cmd_router_.register_handlers(kCommandRegistry,
+        [this](const CommandEnvelope& c) -> CommandResult { return execute_command(c); });
+}
+
+CommandResult UgvCore::execute_command(const CommandEnvelope& c) {
     // This is intentionally thin: it makes command execution callable now
     // (routing + stubs), without implementing the real behaviors yet.
+    const auto stub = []() -> CommandResult {
+        // TODO: implement command handling.
+        return {arcraven::ugv::CommandStatus::Accepted, arcraven::ugv::RejectReason::None, "accepted (stub)"};
+    };
+    // Long-running commands: the handler only starts a task, the control loop steps it.
+    const auto start_task_stub = [this, &c]() -> CommandResult {
+        return cmd_executor_.start(c, std::make_unique<StubTask>(std::string(command_name(c.command))));
+    };
 
-    cmd_router_.register_handler(arcraven::ugv::UgvCommand::EmergencyStop,
-        [this](const CommandEnvelope& c) -> CommandResult {
-            (void)c;
+    // No default: -Wswitch flags a UgvCommand that is added without a case here.
+    switch (c.command) {
+        case arcraven::ugv::UgvCommand::EmergencyStop:
             estop_.trigger("EmergencyStop command");
             stop_.request_stop();
             return {arcraven::ugv::CommandStatus::Succeeded, arcraven::ugv::RejectReason::None, "estop latched"};
-        });
 
-    cmd_router_.register_handler(arcraven::ugv::UgvCommand::Shutdown,
-        [this](const CommandEnvelope& c) -> CommandResult {
-            (void)c;
+        case arcraven::ugv::UgvCommand::Shutdown:
             request_stop();
             return {arcraven::ugv::CommandStatus::Succeeded, arcraven::ugv::RejectReason::None, "shutdown requested"};
-        });
 
-    cmd_router_.register_handler(arcraven::ugv::UgvCommand::Stop,
-        [this](const CommandEnvelope& c) -> CommandResult {
-            (void)c;
+        case arcraven::ugv::UgvCommand::Stop:
             if (estop_.latched()) {
-                return {arcraven::ugv::CommandStatus::Rejected, arcraven::ugv::RejectReason::SafetyLockout, "estop latched"};
+                return {arcraven::ugv::CommandStatus::Rejected, arcraven::ugv::RejectReason::Unsafe, "estop latched"};
             }
+            cmd_executor_.abort_all(arcraven::ugv::CommandStatus::Aborted, "stopped");
+            mission_.abort(arcraven::ugv::CommandStatus::Aborted, "stopped");
             drives_.disable();
             return {arcraven::ugv::CommandStatus::Succeeded, arcraven::ugv::RejectReason::None, "drives disabled"};
-        });
 
-    cmd_router_.register_handler(arcraven::ugv::UgvCommand::Wait,
-        [](const CommandEnvelope& c) -> CommandResult {
-            (void)c;
+        case arcraven::ugv::UgvCommand::Wait:
             // TODO: implement wait/idle behavior.
             return {arcraven::ugv::CommandStatus::Accepted, arcraven::ugv::RejectReason::None, "wait accepted (stub)"};
-        });
 
-    cmd_router_.register_handler(arcraven::ugv::UgvCommand::Reboot,
-        [this](const CommandEnvelope& c) -> CommandResult {
-            (void)c;
+        case arcraven::ugv::UgvCommand::Reboot:
             // TODO: integrate platform reboot sequence.
             request_stop();
             return {arcraven::ugv::CommandStatus::Accepted, arcraven::ugv::RejectReason::None, "reboot requested (stub)"};
-        });
-
-    cmd_router_.register_handler(arcraven::ugv::UgvCommand::FollowPath,
-        [](const CommandEnvelope& c) -> CommandResult {
-            (void)c;
-            // TODO: implement follow path behavior.
-            return {arcraven::ugv::CommandStatus::Accepted, arcraven::ugv::RejectReason::None, "FollowPath accepted (stub)"};
-        });
-
-    cmd_router_.register_handler(arcraven::ugv::UgvCommand::GoTo,
-        [](const CommandEnvelope& c) -> CommandResult {
-            (void)c;
-            // TODO: implement goto behavior.
-            return {arcraven::ugv::CommandStatus::Accepted, arcraven::ugv::RejectReason::None, "GoTo accepted (stub)"};
-        });
-
-    cmd_router_.register_handler(arcraven::ugv::UgvCommand::SafeMode,
-        [](const CommandEnvelope& c) -> CommandResult {
-            (void)c;
-            // TODO: implement safe mode behavior.
-            return {arcraven::ugv::CommandStatus::Accepted, arcraven::ugv::RejectReason::None, "SafeMode accepted (stub)"};
-        });
-
-    cmd_router_.register_handler(arcraven::ugv::UgvCommand::SelfCheck,
-        [](const CommandEnvelope& c) -> CommandResult {
-            (void)c;
-            // TODO: implement self check behavior.
-            return {arcraven::ugv::CommandStatus::Accepted, arcraven::ugv::RejectReason::None, "SelfCheck accepted (stub)"};
-        });
-
-    cmd_router_.register_handler(arcraven::ugv::UgvCommand::CalibrateSensors,
-        [](const CommandEnvelope& c) -> CommandResult {
-            (void)c;
-            // TODO: implement sensor calibration behavior.
-            return {arcraven::ugv::CommandStatus::Accepted, arcraven::ugv::RejectReason::None, "CalibrateSensors accepted (stub)"};
-        });
 
-    cmd_router_.register_handler(arcraven::ugv::UgvCommand::Signal,
-        [](const CommandEnvelope& c) -> CommandResult {
-            // Basic flashlight control payload format:
-            // "flashlight|<id>|<state>"
-            // state: 1 = on, 0 = off
-            std::string_view payload(c.payload_json);
-            if (payload.rfind("flashlight|", 0) == 0) {
+        case arcraven::ugv::UgvCommand::Signal: {
+            // Flashlight payloads ("flashlight|<id>|<state>") arrive pre-decoded by the bridge.
+            const auto* signal = std::get_if<SignalPayload>(&c.typed);
+            if (signal && signal->kind == SignalKind::Flashlight) {
+                // TODO: drive flashlight signal->id to signal->on.
                 return {arcraven::ugv::CommandStatus::Accepted, arcraven::ugv::RejectReason::None, "flashlight command accepted"};
             }
-            return {arcraven::ugv::CommandStatus::Accepted, arcraven::ugv::RejectReason::None, "Signal accepted (stub)"};
-        });
-
-    const auto register_stub = [this](arcraven::ugv::UgvCommand cmd, std::string label) {
-        cmd_router_.register_handler(cmd,
-            [label = std::move(label)](const CommandEnvelope& c) -> CommandResult {
-                (void)c;
-                // TODO: implement command handling.
-                return {arcraven::ugv::CommandStatus::Accepted, arcraven::ugv::RejectReason::None, label + " accepted (stub)"};
-            });
-    };
+            return stub();
+        }
 
-    register_stub(arcraven::ugv::UgvCommand::HoldPosition, "HoldPosition");
-    register_stub(arcraven::ugv::UgvCommand::Anchor, "Anchor");
-    register_stub(arcraven::ugv::UgvCommand::ReplanTo, "ReplanTo");
-    register_stub(arcraven::ugv::UgvCommand::Loiter, "Loiter");
-    register_stub(arcraven::ugv::UgvCommand::ReturnToBase, "ReturnToBase");
-    register_stub(arcraven::ugv::UgvCommand::FollowTarget, "FollowTarget");
-    register_stub(arcraven::ugv::UgvCommand::Evade, "Evade");
-    register_stub(arcraven::ugv::UgvCommand::Dock, "Dock");
-    register_stub(arcraven::ugv::UgvCommand::SetSpeedLimit, "SetSpeedLimit");
-    register_stub(arcraven::ugv::UgvCommand::SetStance, "SetStance");
-    register_stub(arcraven::ugv::UgvCommand::AlignHeading, "AlignHeading");
-    register_stub(arcraven::ugv::UgvCommand::FaceTarget, "FaceTarget");
-    register_stub(arcraven::ugv::UgvCommand::Stabilize, "Stabilize");
-    register_stub(arcraven::ugv::UgvCommand::ScanArea, "ScanArea");
-    register_stub(arcraven::ugv::UgvCommand::Observe, "Observe");
-    register_stub(arcraven::ugv::UgvCommand::FocusSensor, "FocusSensor");
-    register_stub(arcraven::ugv::UgvCommand::TrackEntity, "TrackEntity");
-    register_stub(arcraven::ugv::UgvCommand::Sentinel, "Sentinel");
-    register_stub(arcraven::ugv::UgvCommand::SecureArea, "SecureArea");
-    register_stub(arcraven::ugv::UgvCommand::Escort, "Escort");
-    register_stub(arcraven::ugv::UgvCommand::Checkpoint, "Checkpoint");
-    register_stub(arcraven::ugv::UgvCommand::Investigate, "Investigate");
-    register_stub(arcraven::ugv::UgvCommand::Shadow, "Shadow");
-    register_stub(arcraven::ugv::UgvCommand::ExecuteMission, "ExecuteMission");
-    register_stub(arcraven::ugv::UgvCommand::AbortMission, "AbortMission");
-    register_stub(arcraven::ugv::UgvCommand::PauseMission, "PauseMission");
-    register_stub(arcraven::ugv::UgvCommand::ResumeMission, "ResumeMission");
-    register_stub(arcraven::ugv::UgvCommand::HandoffControl, "HandoffControl");
-    register_stub(arcraven::ugv::UgvCommand::Broadcast, "Broadcast");
-    register_stub(arcraven::ugv::UgvCommand::Acknowledge, "Acknowledge");
-    register_stub(arcraven::ugv::UgvCommand::RequestAssistance, "RequestAssistance");
-    register_stub(arcraven::ugv::UgvCommand::Recover, "Recover");
-    register_stub(arcraven::ugv::UgvCommand::SetRuleset, "SetRuleset");
-    register_stub(arcraven::ugv::UgvCommand::SetOwnership, "SetOwnership");
-    register_stub(arcraven::ugv::UgvCommand::LockCommandSet, "LockCommandSet");
-    register_stub(arcraven::ugv::UgvCommand::UnlockCommandSet, "UnlockCommandSet");
+        case arcraven::ugv::UgvCommand::FollowPath:
+        case arcraven::ugv::UgvCommand::SelfCheck:
+        case arcraven::ugv::UgvCommand::Dock:
+        case arcraven::ugv::UgvCommand::ScanArea:
+            return start_task_stub();
+
+        case arcraven::ugv::UgvCommand::ExecuteMission: {
+            CommandResult r = mission_.execute(c);
+            if (r.status == arcraven::ugv::CommandStatus::Running) {
+                // Any step task still running belongs to the mission this one replaced.
+                cmd_executor_.abort_origin(CommandOrigin::Mission, arcraven::ugv::CommandStatus::Preempted,
+                                           "mission superseded");
+            }
+            return r;
+        }
+        case arcraven::ugv::UgvCommand::PauseMission:
+            return mission_.pause();
+        case arcraven::ugv::UgvCommand::ResumeMission:
+            return mission_.resume();
+        case arcraven::ugv::UgvCommand::AbortMission:
+            cmd_executor_.abort_origin(CommandOrigin::Mission, arcraven::ugv::CommandStatus::Aborted, "mission aborted");
+            mission_.abort(arcraven::ugv::CommandStatus::Aborted, "mission aborted");
+            return {arcraven::ugv::CommandStatus::Succeeded, arcraven::ugv::RejectReason::None, "mission aborted"};
+
+        // Authority arbitration: submit has already checked the issuer may send these.
+        case arcraven::ugv::UgvCommand::SetOwnership:
+        case arcraven::ugv::UgvCommand::LockCommandSet:
+        case arcraven::ugv::UgvCommand::UnlockCommandSet:
+        case arcraven::ugv::UgvCommand::HandoffControl:
+            return cmd_router_.authority().execute(c);
+
+        case arcraven::ugv::UgvCommand::GoTo:
+        case arcraven::ugv::UgvCommand::SafeMode:
+        case arcraven::ugv::UgvCommand::CalibrateSensors:
+        case arcraven::ugv::UgvCommand::HoldPosition:
+        case arcraven::ugv::UgvCommand::Anchor:
+        case arcraven::ugv::UgvCommand::ReplanTo:
+        case arcraven::ugv::UgvCommand::Loiter:
+        case arcraven::ugv::UgvCommand::ReturnToBase:
+        case arcraven::ugv::UgvCommand::FollowTarget:
+        case arcraven::ugv::UgvCommand::Evade:
+        case arcraven::ugv::UgvCommand::SetSpeedLimit:
+        case arcraven::ugv::UgvCommand::SetStance:
+        case arcraven::ugv::UgvCommand::AlignHeading:
+        case arcraven::ugv::UgvCommand::FaceTarget:
+        case arcraven::ugv::UgvCommand::Stabilize:
+        case arcraven::ugv::UgvCommand::Observe:
+        case arcraven::ugv::UgvCommand::FocusSensor:
+        case arcraven::ugv::UgvCommand::TrackEntity:
+        case arcraven::ugv::UgvCommand::Sentinel:
+        case arcraven::ugv::UgvCommand::SecureArea:
+        case arcraven::ugv::UgvCommand::Escort:
+        case arcraven::ugv::UgvCommand::Checkpoint:
+        case arcraven::ugv::UgvCommand::Investigate:
+        case arcraven::ugv::UgvCommand::Shadow:
+        case arcraven::ugv::UgvCommand::Broadcast:
+        case arcraven::ugv::UgvCommand::Acknowledge:
+        case arcraven::ugv::UgvCommand::RequestAssistance:
+        case arcraven::ugv::UgvCommand::Recover:
+        case arcraven::ugv::UgvCommand::SetRuleset:
+            return stub();
+    }
+    return {arcraven::ugv::CommandStatus::Rejected, arcraven::ugv::RejectReason::Unsupported, "no handler"};
 }
 
 void UgvCore::estop_thread() {
@@ -305,26 +385,57 @@ void UgvCore::control_thread() {
     state_.last_authority = static_cast<uint8_t>(arcraven::ugv::CommandAuthority::Unknown);
 
     while (!stop_.stop_requested()) {
+        const uint64_t now = now_ns();
         if (!estop_.latched()) {
             // Command processing can be done here to keep "control owns actuation".
-            cmd_router_.process_some(now_ns(), /*max_n=*/8,
+            cmd_router_.process_some(now, /*max_n=*/8,
                 [this](const std::pair<CommandEnvelope, CommandResult>& processed) {
-                    // In real code, forward ACK to cmd_link_ tx queue.
-                    // For now, just log a minimal trail.
                     const auto& cmd = processed.first;
                     const auto& res = processed.second;
                     if (res.status != arcraven::ugv::CommandStatus::Rejected) {
                         state_.last_authority = static_cast<uint8_t>(cmd.authority);
                     }
-                    ARC_LOG_INFO("Cmd processed: id=" + std::to_string(cmd.command_id) +
-                                 " status=" + std::to_string(static_cast<int>(res.status)));
-                    (void)cmd_link_.publish_command_result(cmd.command_id, res);
+                    log_command("Cmd processed", cmd.command_id, res.status);
+                    // The link records the Publish/Total latency once the ack is written.
+                    (void)cmd_link_->publish_command_result(cmd.command_id, res, ack_timing(cmd));
+                    cmd_latency_.record(cmd);
+                    (void)cmd_journal_.append(cmd, res, now_ns());
                 });
 
             // TODO: compute control outputs based on latest accepted commands
             // (read atomics / blackboard that handlers update).
+        } else if (cmd_executor_.active() > 0 || mission_.active()) {
+            cmd_executor_.abort_all(arcraven::ugv::CommandStatus::Aborted, "estop latched");
+            mission_.abort(arcraven::ugv::CommandStatus::Aborted, "estop latched");
         }
 
+        // Long-running commands: bounded stepping, then progress/final/preempted reports.
+        const auto report = [this](uint64_t command_id, const CommandResult& res) {
+            cmd_router_.record_result(command_id, res);
+            log_command("Cmd task", command_id, res.status);
+            (void)cmd_link_->publish_command_result(command_id, res, AckTiming{});
+            (void)cmd_journal_.append_result(command_id, res, now_ns());
+        };
+        cmd_executor_.tick(now, [&](uint64_t command_id, CommandOrigin origin, const CommandResult& res) {
+            // Mission steps report to the mission, which reports against ExecuteMission's id.
+            if (origin == CommandOrigin::Mission) {
+                mission_.on_step_report(command_id, res);
+                (void)cmd_journal_.append_result(command_id, res, now_ns());
+                return;
+            }
+            report(command_id, res);
+        });
+
+        // Mission: at most one step per tick, checked against the arbiter like a submitted command.
+        mission_.tick(now,
+            [this](const CommandEnvelope& step) -> CommandResult {
+                if (!cmd_router_.authority().permits(step)) {
+                    return {arcraven::ugv::CommandStatus::Rejected, arcraven::ugv::RejectReason::NotAuthorized, "not authorized"};
+                }
+                return execute_command(step);
+            },
+            report);
+
         sleep_until_next(next, cfg_.control_rate);
     }
 
@@ -351,7 +462,7 @@ void UgvCore::sensor_thread() {
         if (!has_joints) {
             joints.clear();
         }
-        (void)cmd_link_.publish_telemetry(frame, joints);
+        (void)cmd_link_->publish_telemetry(frame, joints);
         sleep_until_next(next, cfg_.sensor_rate);
     }
 
@@ -363,14 +474,16 @@ void UgvCore::io_thread() {
     auto next = SteadyClock::now();
 
     while (!stop_.stop_requested()) {
-        (void)cmd_link_.pump_rx();
-        (void)cmd_link_.pump_tx();
+        (void)cmd_link_->pump_rx();
+        (void)cmd_link_->pump_tx();
 
         // TODO: When you wire Iceoryx2:
         // - cmd_link_ receives a wire packet and calls cmd_router_.submit(envelope)
         // - tx path sends acks/telemetry produced by the core
 
-        sleep_until_next(next, cfg_.io_rate);
+        // Keeps the io_rate cadence for tx, but wakes as soon as a command is written.
+        if (SteadyClock::now() >= next) next += cfg_.io_rate.period;
+        cmd_link_->wait_until(next);
     }
 
     ARC_LOG_INFO("IO thread exiting");
@@ -380,8 +493,11 @@ void UgvCore::persist_thread() {
     ARC_LOG_INFO("Persist thread started");
     auto next = SteadyClock::now();
 
+    auto next_summary = next + cfg_.latency_summary_period;
+
     while (!stop_.stop_requested()) {
         (void)state_store_.save(state_);
+        report_command_latency(next_summary);
         sleep_until_next(next, cfg_.persist_rate);
     }
 
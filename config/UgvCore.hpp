@@ -3,11 +3,17 @@
 #include <vector>
 
 #include "UgvConfig.hpp"
+#include "command/CommandExecutor.hpp"
+#include "command/CommandJournal.hpp"
+#include "command/CommandLatency.hpp"
+#include "command/CommandRegistry.hpp"
 #include "command/CommandRouter.hpp"
+#include "command/MissionEngine.hpp"
 #include "core/EStopLatch.hpp"
 #include "core/StateStore.hpp"
 #include "core/StopController.hpp"
 #include "subsystems/Iceoryx2Bridge.hpp"
+#include "subsystems/ShmCommandLink.hpp"
 #include "subsystems/Stubs.hpp"
 
 namespace arcraven::ugv {
@@ -29,7 +35,9 @@ private:
 
     // ---- Command integration ----
     void register_default_command_handlers();
+    CommandResult execute_command(const CommandEnvelope& c);
     uint64_t now_ns() const;
+    void report_command_latency(SteadyClock::time_point& next_summary);
 
     // ---- Threads ----
     void estop_thread();
@@ -49,9 +57,15 @@ private:
     // Replace stubs with real subsystems.
     DriveSystemStub drives_;
     SensorSuiteStub sensors_;
-    Iceoryx2Bridge cmd_link_;
+    Iceoryx2Bridge file_link_;
+    ShmCommandLink shm_link_;
+    ICommandLink* cmd_link_ = nullptr; // one of the above, per cfg_.command_transport
 
     CommandRouter cmd_router_;
+    CommandExecutor cmd_executor_;
+    MissionEngine mission_;
+    CommandLatencyStats cmd_latency_;
+    CommandJournal cmd_journal_;
 
     std::vector<std::thread> threads_;
     bool estop_thread_started_ = false;
@@ -0,0 +1,77 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace arcraven::ugv {
+
+// Log-linear (HDR-style) histogram of nanosecond durations: every power of two is split into
+// 8 linear sub-buckets, so a reported percentile is within 12.5% of the recorded value over
+// 1 ns .. 2^40 ns (~18 min, larger values land in the last bucket). Fixed ~1.2 KiB, no allocation.
+//
+// record() is lock-free (relaxed counters) and may run on any number of threads while another
+// thread reads; readers get a snapshot that is at most a few in-flight samples behind.
+class LatencyHistogram final {
+public:
+    static constexpr unsigned kSubBits = 3;
+    static constexpr size_t kSub = size_t{1} << kSubBits;
+    static constexpr unsigned kMaxExp = 40;
+    static constexpr size_t kBuckets = (kMaxExp - kSubBits + 1) * kSub;
+
+    static constexpr size_t bucket_of(uint64_t v) {
+        if (v < kSub) return static_cast<size_t>(v);
+        const auto e = static_cast<unsigned>(63 - std::countl_zero(v));
+        if (e >= kMaxExp) return kBuckets - 1;
+        return (e - kSubBits + 1) * kSub + static_cast<size_t>((v >> (e - kSubBits)) & (kSub - 1));
+    }
+
+    // Highest value that maps into bucket i.
+    static constexpr uint64_t bucket_high(size_t i) {
+        if (i + 1 >= kBuckets) return UINT64_MAX;
+        if (i + 1 < kSub) return i;
+        const unsigned e = static_cast<unsigned>((i + 1) / kSub) + kSubBits - 1;
+        const uint64_t next_low = (uint64_t{1} << e) | (static_cast<uint64_t>((i + 1) % kSub) << (e - kSubBits));
+        return next_low - 1;
+    }
+
+    void record(uint64_t v) {
+        counts_[bucket_of(v)].fetch_add(1, std::memory_order_relaxed);
+        total_.fetch_add(1, std::memory_order_relaxed);
+        uint64_t seen = max_.load(std::memory_order_relaxed);
+        while (v > seen && !max_.compare_exchange_weak(seen, v, std::memory_order_relaxed)) {
+        }
+    }
+
+    uint64_t count() const { return total_.load(std::memory_order_relaxed); }
+    uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+
+    // Upper bound of the bucket holding the q-quantile (0 < q <= 1); 0 when empty.
+    uint64_t quantile(double q) const {
+        const uint64_t n = count();
+        if (n == 0) return 0;
+        auto rank = static_cast<uint64_t>(q * static_cast<double>(n));
+        if (rank == 0) rank = 1;
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBuckets; ++i) {
+            seen += counts_[i].load(std::memory_order_relaxed);
+            if (seen >= rank) return bucket_high(i) < max() ? bucket_high(i) : max();
+        }
+        return max();
+    }
+
+private:
+    std::array<std::atomic<uint32_t>, kBuckets> counts_{};
+    std::atomic<uint64_t> total_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+static_assert(LatencyHistogram::bucket_of(7) == 7 && LatencyHistogram::bucket_of(16) == 16);
+static_assert(LatencyHistogram::bucket_high(LatencyHistogram::bucket_of(1000)) >= 1000);
+static_assert(LatencyHistogram::bucket_of(LatencyHistogram::bucket_high(LatencyHistogram::bucket_of(1000)) + 1) ==
+              LatencyHistogram::bucket_of(1000) + 1);
+static_assert(LatencyHistogram::bucket_of(uint64_t{1} << LatencyHistogram::kMaxExp) == LatencyHistogram::kBuckets - 1);
+
+} // namespace arcraven::ugv
@@ -0,0 +1,87 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace arcraven::ugv {
+
+// Bounded, preallocated multi-producer / single-consumer ring.
+//
+// Each slot carries a sequence number (Vyukov scheme): producers claim a position with one CAS
+// on head_, write the value, then publish it by bumping the slot sequence. The single consumer
+// never touches head_, so the control thread only ever pays for one acquire load per pop.
+// Capacity is rounded up to a power of two; push/pop never allocate or block.
+template <typename T>
+class MpscRing final {
+public:
+    explicit MpscRing(size_t min_capacity) {
+        size_t cap = 1;
+        while (cap < min_capacity) cap <<= 1u;
+        mask_ = cap - 1;
+        slots_ = std::make_unique<Slot[]>(cap);
+        for (size_t i = 0; i < cap; ++i) {
+            slots_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    // Any thread. Returns false when the ring is full (value is left untouched).
+    bool try_push(T&& value) {
+        uint64_t pos = head_.load(std::memory_order_relaxed);
+        Slot* slot = nullptr;
+        for (;;) {
+            slot = &slots_[pos & mask_];
+            const uint64_t seq = slot->seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+        slot->value = std::move(value);
+        slot->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer thread only. Returns false when nothing is published at the tail.
+    bool try_pop(T& out) {
+        const uint64_t pos = tail_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[pos & mask_];
+        if (slot.seq.load(std::memory_order_acquire) != pos + 1) return false;
+
+        out = std::move(slot.value);
+        slot.seq.store(pos + mask_ + 1, std::memory_order_release);
+        tail_.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+    // Racy by nature; good enough for metrics and watermarks.
+    size_t size_approx() const {
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+        const uint64_t tail = tail_.load(std::memory_order_relaxed);
+        return head > tail ? static_cast<size_t>(head - tail) : 0;
+    }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> seq{0};
+        T value{};
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_ = 0;
+
+    alignas(64) std::atomic<uint64_t> head_{0}; // producers
+    alignas(64) std::atomic<uint64_t> tail_{0}; // consumer (atomic only for size_approx)
+};
+
+} // namespace arcraven::ugv
@@ -0,0 +1,71 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace arcraven::ugv {
+
+// Bounded, preallocated single-producer / single-consumer ring.
+//
+// Each side owns one index and only reads the other's; no CAS, no per-slot sequence. Capacity is
+// rounded up to a power of two; push/pop never allocate or block.
+template <typename T>
+class SpscRing final {
+public:
+    explicit SpscRing(size_t min_capacity) {
+        size_t cap = 1;
+        while (cap < min_capacity) cap <<= 1u;
+        mask_ = cap - 1;
+        slots_ = std::make_unique<T[]>(cap);
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer thread only. Returns false when the ring is full (value is left untouched).
+    bool try_push(T&& value) {
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) > mask_) return false;
+        slots_[head & mask_] = std::move(value);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producer thread only: fill the next slot in place, then publish(). Returns nullptr when full.
+    T* claim() {
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) > mask_) return nullptr;
+        return &slots_[head & mask_];
+    }
+    void publish() { head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    // Consumer thread only. Returns false when the ring is empty.
+    bool try_pop(T& out) {
+        const uint64_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) return false;
+        out = std::move(slots_[tail & mask_]);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer thread only: the oldest entry in place, or nullptr; release it with pop().
+    const T* front() const {
+        const uint64_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) return nullptr;
+        return &slots_[tail & mask_];
+    }
+    void pop() { tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    std::unique_ptr<T[]> slots_;
+    size_t mask_ = 0;
+
+    alignas(64) std::atomic<uint64_t> head_{0}; // producer
+    alignas(64) std::atomic<uint64_t> tail_{0}; // consumer
+};
+
+} // namespace arcraven::ugv
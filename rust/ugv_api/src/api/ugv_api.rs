@@ -1,6 +1,6 @@
 use crate::commands::{CommandEnvelope, CommandResultEvent};
 use crate::sensors::SensorDescriptor;
-use crate::telemetry::TelemetryFrame;
+use crate::telemetry::{FlowCredit, TelemetryFrame};
 use crate::transport::Transport;
 
 pub struct UgvApi<T: Transport> {
@@ -35,4 +35,8 @@ impl<T: Transport> UgvApi<T> {
     pub fn poll_command_results(&mut self) -> Vec<CommandResultEvent> {
         self.transport.receive_command_results()
     }
+
+    pub fn poll_flow_credit(&mut self) -> Option<FlowCredit> {
+        self.transport.latest_flow_credit()
+    }
 }
@@ -10,5 +10,7 @@ pub use commands::{
     RejectReason, UgvCommand,
 };
 pub use sensors::{SensorDescriptor, SensorField, SensorFrame, SensorReading};
-pub use telemetry::{JointState, TelemetryFrame};
-pub use transport::{Iceoryx2Transport, Transport};
+pub use telemetry::{FlowCredit, JointState, TelemetryFrame};
+pub use transport::{Iceoryx2Transport, TelemetryStart, Transport};
+#[cfg(target_os = "linux")]
+pub use transport::ShmTransport;
@@ -1,6 +1,9 @@
+use std::sync::Arc;
+
+/// `id` and `sensor_type` are shared with the telemetry schema they were decoded against.
 #[derive(Debug, Clone)]
 pub struct SensorPayload {
-    pub id: String,
-    pub sensor_type: String,
+    pub id: Arc<str>,
+    pub sensor_type: Arc<str>,
     pub payload: String,
 }
@@ -0,0 +1,10 @@
+/// Command queue credits advertised by the core (credit records in the telemetry stream).
+/// Keep fewer than `credits` commands in flight and back off while `backpressure` is set.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct FlowCredit {
+    pub timestamp_ns: u64,
+    pub credits: u32,
+    pub queued: u32,
+    pub capacity: u32,
+    pub backpressure: bool,
+}
@@ -1,7 +1,10 @@
+use std::sync::Arc;
+
+/// `id` and `name` are shared with the telemetry schema they were decoded against.
 #[derive(Debug, Clone)]
 pub struct JointState {
-    pub id: String,
-    pub name: String,
+    pub id: Arc<str>,
+    pub name: Arc<str>,
     pub position: f64,
     pub velocity: f64,
     pub load: f64,
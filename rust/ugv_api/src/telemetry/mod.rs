@@ -1,5 +1,7 @@
+mod flow_credit;
 mod joint_state;
 mod telemetry_frame;
 
+pub use flow_credit::FlowCredit;
 pub use joint_state::JointState;
 pub use telemetry_frame::TelemetryFrame;
@@ -1,43 +1,172 @@
 use std::fs::{self, OpenOptions};
-use std::io::{BufRead, BufReader, Seek, SeekFrom, Write};
+use std::io::{Read, Seek, SeekFrom, Write};
 use std::path::{Path, PathBuf};
+use std::sync::Arc;
 
 use base64::{engine::general_purpose, Engine as _};
 
-use crate::commands::{CommandEnvelope, CommandResult, CommandResultEvent, CommandStatus, RejectReason};
+use crate::commands::{CommandEnvelope, CommandResult, CommandResultEvent};
 use crate::sensors::SensorPayload;
-use crate::telemetry::{JointState, TelemetryFrame};
+use crate::telemetry::{FlowCredit, JointState, TelemetryFrame};
+use crate::transport::joint_delta::JointDeltaDecoder;
+use crate::transport::schema::{SchemaCache, TelemetrySchema};
+use crate::transport::segments::{self, TelemetryStart};
+use crate::transport::wire;
 use crate::transport::Transport;
 
+// Largest frame body accepted from the telemetry segments; anything bigger is treated as
+// corruption.
+const MAX_FRAME_BODY: usize = 64 << 20;
+// How much of a segment's head is read looking for its schema.
+const MAX_PREAMBLE: u64 = 1 << 20;
+
+/// Client of the core's file transport (`commands.in` and the `telemetry.<seq>.out` segments
+/// under the bridge directory).
+///
+/// `new` asks for binary frames (subsystems/WireProtocol.hpp) by writing a Hello to
+/// `commands.in`; commands go out as text lines until the core acknowledges it in the telemetry
+/// stream, which also carries text until then (or for good, if the core is configured for text).
+/// `with_text_protocol` never asks and stays on text lines, for debugging.
+///
+/// `new` also asks for interned telemetry: the core then announces joint and sensor identity in
+/// a schema record at the head of each segment, and frames refer to it by index. Decoded frames
+/// share the schema's strings. Text telemetry is interned whenever the core is configured for it.
+/// It also asks for joint keyframes and deltas, which the core sends if configured to; joint
+/// values are then rebuilt from quantized integers (see `UgvConfig::file_joint_delta`), and
+/// after a seek, frames start at the next keyframe.
+///
+/// Both start reading at [`TelemetryStart::Now`]; `seek_telemetry` moves elsewhere, including
+/// to a timestamp through the segments' index. Reading follows rollover to the next segment and
+/// skips ahead if the core's retention deleted the current one.
 pub struct Iceoryx2Transport {
+    base_dir: PathBuf,
     command_path: PathBuf,
-    telemetry_path: PathBuf,
+    // 0 until a segment exists; then reading starts at the oldest one.
+    segment: u64,
     telemetry_offset: u64,
+    skip_before_ns: Option<u64>,
+    rx: Vec<u8>,
+    hello_sent: bool,
+    wire_version: u8,
+    wire_features: u16,
+    schemas: SchemaCache,
+    joint_delta: JointDeltaDecoder,
     pending_telemetry: Vec<TelemetryFrame>,
     pending_results: Vec<CommandResultEvent>,
+    latest_credit: Option<FlowCredit>,
 }
 
 impl Iceoryx2Transport {
     pub fn new(base_dir: impl AsRef<Path>) -> Self {
-        let base_dir = base_dir.as_ref();
+        let mut transport = Self::with_text_protocol(base_dir);
+        let mut hello = Vec::with_capacity(wire::WIRE_HEADER_LEN + 4);
+        let features = wire::FEATURE_INTERNED_TELEMETRY | wire::FEATURE_DELTA_TELEMETRY;
+        wire::encode_hello(&mut hello, wire::WIRE_VERSION, features);
+        transport.hello_sent = transport.append_command_bytes(&hello);
+        transport
+    }
+
+    pub fn with_text_protocol(base_dir: impl AsRef<Path>) -> Self {
+        let base_dir = base_dir.as_ref().to_path_buf();
         let command_path = base_dir.join("commands.in");
-        let telemetry_path = base_dir.join("telemetry.out");
-        let _ = fs::create_dir_all(base_dir);
+        let _ = fs::create_dir_all(&base_dir);
         let _ = OpenOptions::new().create(true).append(true).open(&command_path);
-        let _ = OpenOptions::new().create(true).append(true).open(&telemetry_path);
-        Self {
+        let mut transport = Self {
+            base_dir,
             command_path,
-            telemetry_path,
+            segment: 0,
             telemetry_offset: 0,
+            skip_before_ns: None,
+            rx: Vec::new(),
+            hello_sent: false,
+            wire_version: 0,
+            wire_features: 0,
+            schemas: SchemaCache::default(),
+            joint_delta: JointDeltaDecoder::default(),
             pending_telemetry: Vec::new(),
             pending_results: Vec::new(),
+            latest_credit: None,
+        };
+        transport.seek_telemetry(TelemetryStart::Now);
+        transport
+    }
+
+    /// Moves the telemetry read position, discarding telemetry received but not yet taken.
+    pub fn seek_telemetry(&mut self, start: TelemetryStart) {
+        self.rx.clear();
+        self.pending_telemetry.clear();
+        self.skip_before_ns = None;
+        let (segment, offset) = match start {
+            TelemetryStart::Oldest => (segments::list_segments(&self.base_dir).first().copied().unwrap_or(0), 0),
+            TelemetryStart::Now => match segments::list_segments(&self.base_dir).last() {
+                Some(&seq) => {
+                    let path = segments::segment_path(&self.base_dir, seq, segments::DATA_EXT);
+                    (seq, fs::metadata(path).map_or(0, |m| m.len()))
+                }
+                None => (0, 0),
+            },
+            TelemetryStart::Timestamp(timestamp_ns) => {
+                self.skip_before_ns = Some(timestamp_ns);
+                segments::locate(&self.base_dir, timestamp_ns).unwrap_or((0, 0))
+            }
+        };
+        self.segment = segment;
+        self.telemetry_offset = offset;
+        // Reading from the head picks the schema up on the way; mid-segment it is fetched.
+        self.schemas.clear();
+        self.joint_delta.reset();
+        if offset > 0 {
+            self.load_preamble();
+        }
+    }
+
+    // Applies the schema record heading the current segment, if it has one.
+    fn load_preamble(&mut self) {
+        let path = segments::segment_path(&self.base_dir, self.segment, segments::DATA_EXT);
+        let Ok(file) = fs::File::open(path) else {
+            return;
+        };
+        let mut head = Vec::new();
+        if file.take(MAX_PREAMBLE).read_to_end(&mut head).is_err() {
+            return;
+        }
+        if wire::frame_at(&head) {
+            if let wire::Scan::Frame { kind, body, .. } = wire::scan_frame(&head, MAX_FRAME_BODY) {
+                if kind == wire::FRAME_SCHEMA {
+                    if let Some(schema) = wire::decode_schema(body) {
+                        self.schemas.insert(schema);
+                    }
+                }
+            }
+        } else if let Some(end) = head.iter().position(|&b| b == b'\n') {
+            if let Some(schema) = self.parse_schema_line(&String::from_utf8_lossy(&head[..end])) {
+                self.schemas.insert(schema);
+            }
+        }
+    }
+
+    /// Wire version agreed with the core; 0 while on text lines.
+    pub fn wire_version(&self) -> u8 {
+        self.wire_version
+    }
+
+    /// True once the core agreed to send interned telemetry frames.
+    pub fn interned_telemetry(&self) -> bool {
+        self.wire_features & wire::FEATURE_INTERNED_TELEMETRY != 0
+    }
+
+    // One write per record so concurrent appenders never interleave inside it.
+    fn append_command_bytes(&self, bytes: &[u8]) -> bool {
+        match OpenOptions::new().append(true).open(&self.command_path) {
+            Ok(mut file) => file.write_all(bytes).is_ok(),
+            Err(_) => false,
         }
     }
 
     fn encode_command(&self, command: &CommandEnvelope) -> String {
-            let payload = general_purpose::STANDARD.encode(command.payload_json.as_bytes());
+        let payload = general_purpose::STANDARD.encode(command.payload_json.as_bytes());
         format!(
-            "C|{}|{}|{}|{}|{}|{}|{}|{}",
+            "C|{}|{}|{}|{}|{}|{}|{}|{}\n",
             command.command_id,
             command.command as u16,
             command.domain as u16,
@@ -58,8 +187,8 @@ impl Iceoryx2Transport {
         let joint_count: usize = parts.next()?.parse().ok()?;
         let mut joints = Vec::with_capacity(joint_count);
         for _ in 0..joint_count {
-            let id = parts.next()?.to_string();
-            let name = parts.next()?.to_string();
+            let id = parts.next()?.into();
+            let name = parts.next()?.into();
             let position = parts.next()?.parse().ok()?;
             let velocity = parts.next()?.parse().ok()?;
             let load = parts.next()?.parse().ok()?;
@@ -74,8 +203,8 @@ impl Iceoryx2Transport {
         let sensor_count: usize = parts.next()?.parse().ok()?;
         let mut payloads = Vec::with_capacity(sensor_count);
         for _ in 0..sensor_count {
-            let id = parts.next()?.to_string();
-            let sensor_type = parts.next()?.to_string();
+            let id = parts.next()?.into();
+            let sensor_type = parts.next()?.into();
             let payload_b64 = parts.next()?.to_string();
             let payload_bytes = general_purpose::STANDARD.decode(payload_b64).ok()?;
             let payload = String::from_utf8(payload_bytes).ok()?;
@@ -93,6 +222,110 @@ impl Iceoryx2Transport {
         })
     }
 
+    fn parse_schema_line(&self, line: &str) -> Option<TelemetrySchema> {
+        let mut parts = line.split('|');
+        if parts.next()? != "S" {
+            return None;
+        }
+        let id = parts.next()?.parse().ok()?;
+        let joint_count: usize = parts.next()?.parse().ok()?;
+        let mut joints = Vec::with_capacity(joint_count.min(256));
+        for _ in 0..joint_count {
+            joints.push((parts.next()?.into(), parts.next()?.into()));
+        }
+        let channel_count: usize = parts.next()?.parse().ok()?;
+        let mut channels = Vec::with_capacity(channel_count.min(256));
+        for _ in 0..channel_count {
+            channels.push((parts.next()?.into(), parts.next()?.into()));
+        }
+        Some(TelemetrySchema { id, joints, channels })
+    }
+
+    fn parse_interned_line(&self, line: &str) -> Option<TelemetryFrame> {
+        let mut parts = line.split('|');
+        if parts.next()? != "I" {
+            return None;
+        }
+        let schema = self.schemas.get(parts.next()?.parse().ok()?)?;
+        let timestamp_ns = parts.next()?.parse().ok()?;
+        let mut joints = Vec::with_capacity(schema.joints.len());
+        for (id, name) in &schema.joints {
+            joints.push(JointState {
+                id: Arc::clone(id),
+                name: Arc::clone(name),
+                position: parts.next()?.parse().ok()?,
+                velocity: parts.next()?.parse().ok()?,
+                load: parts.next()?.parse().ok()?,
+            });
+        }
+        let sensor_count: usize = parts.next()?.parse().ok()?;
+        let mut payloads = Vec::with_capacity(sensor_count.min(256));
+        for _ in 0..sensor_count {
+            let channel: usize = parts.next()?.parse().ok()?;
+            let (id, sensor_type) = schema.channels.get(channel)?;
+            let payload_bytes = general_purpose::STANDARD.decode(parts.next()?).ok()?;
+            payloads.push(SensorPayload {
+                id: Arc::clone(id),
+                sensor_type: Arc::clone(sensor_type),
+                payload: String::from_utf8(payload_bytes).ok()?,
+            });
+        }
+        Some(TelemetryFrame {
+            timestamp_ns,
+            joints,
+            sensors: Vec::new(),
+            payloads,
+        })
+    }
+
+    // K|schema_id|seq|timestamp_ns|res_pos|res_vel|res_load|q...|sensor_count|channel|payload...
+    // D|schema_id|seq|timestamp_ns|dq...|sensor_count|channel|payload...
+    fn parse_delta_line(&mut self, line: &str) -> Option<TelemetryFrame> {
+        let mut parts = line.split('|');
+        let keyframe = match parts.next()? {
+            "K" => true,
+            "D" => false,
+            _ => return None,
+        };
+        let schema = self.schemas.get(parts.next()?.parse().ok()?)?;
+        let seq = parts.next()?.parse().ok()?;
+        let timestamp_ns = parts.next()?.parse().ok()?;
+        let resolution = if keyframe {
+            Some([
+                parts.next()?.parse().ok()?,
+                parts.next()?.parse().ok()?,
+                parts.next()?.parse().ok()?,
+            ])
+        } else {
+            None
+        };
+        self.joint_delta.scratch.clear();
+        for _ in 0..schema.joints.len() * 3 {
+            self.joint_delta.scratch.push(parts.next()?.parse().ok()?);
+        }
+        if !self.joint_delta.apply(schema.id, seq, resolution) {
+            return None;
+        }
+        let sensor_count: usize = parts.next()?.parse().ok()?;
+        let mut payloads = Vec::with_capacity(sensor_count.min(256));
+        for _ in 0..sensor_count {
+            let channel: usize = parts.next()?.parse().ok()?;
+            let (id, sensor_type) = schema.channels.get(channel)?;
+            let payload_bytes = general_purpose::STANDARD.decode(parts.next()?).ok()?;
+            payloads.push(SensorPayload {
+                id: Arc::clone(id),
+                sensor_type: Arc::clone(sensor_type),
+                payload: String::from_utf8(payload_bytes).ok()?,
+            });
+        }
+        Some(TelemetryFrame {
+            timestamp_ns,
+            joints: wire::delta_joints(schema, &self.joint_delta),
+            sensors: Vec::new(),
+            payloads,
+        })
+    }
+
     fn parse_result_line(&self, line: &str) -> Option<CommandResultEvent> {
         let mut parts = line.split('|');
         if parts.next()? != "R" {
@@ -105,78 +338,228 @@ impl Iceoryx2Transport {
         Some(CommandResultEvent {
             command_id,
             result: CommandResult {
-                status: Self::status_from_u16(status_raw),
-                reject_reason: Self::reject_from_u16(reject_raw),
+                status: wire::status_from_u16(status_raw),
+                reject_reason: wire::reject_from_u16(reject_raw),
                 message,
             },
         })
     }
 
-    fn status_from_u16(value: u16) -> CommandStatus {
-        match value {
-            1 => CommandStatus::Received,
-            2 => CommandStatus::Accepted,
-            3 => CommandStatus::Rejected,
-            4 => CommandStatus::Running,
-            5 => CommandStatus::Succeeded,
-            6 => CommandStatus::Failed,
-            7 => CommandStatus::Aborted,
-            8 => CommandStatus::Preempted,
-            9 => CommandStatus::Expired,
-            _ => CommandStatus::None,
+    fn parse_credit_line(&self, line: &str) -> Option<FlowCredit> {
+        let mut parts = line.split('|');
+        if parts.next()? != "F" {
+            return None;
         }
+        Some(FlowCredit {
+            timestamp_ns: parts.next()?.parse().ok()?,
+            credits: parts.next()?.parse().ok()?,
+            queued: parts.next()?.parse().ok()?,
+            capacity: parts.next()?.parse().ok()?,
+            backpressure: parts.next()? == "1",
+        })
     }
 
-    fn reject_from_u16(value: u16) -> RejectReason {
-        match value {
-            1 => RejectReason::NotAuthorized,
-            2 => RejectReason::InvalidPayload,
-            3 => RejectReason::Unsupported,
-            4 => RejectReason::Unsafe,
-            5 => RejectReason::Busy,
-            6 => RejectReason::PreconditionsFail,
-            7 => RejectReason::Timeout,
-            8 => RejectReason::StaleCommand,
-            _ => RejectReason::None,
+    fn drain_lines(&mut self) {
+        loop {
+            if self.segment == 0 {
+                match segments::list_segments(&self.base_dir).first() {
+                    Some(&seq) => self.segment = seq,
+                    None => return,
+                }
+                self.telemetry_offset = 0;
+            }
+            // Checked before reading: once seq + 1 exists the core has finished with seq, so
+            // reading it to the end now leaves nothing behind.
+            let complete = segments::segment_path(&self.base_dir, self.segment + 1, segments::DATA_EXT).exists();
+            if !self.read_segment() {
+                // Deleted by retention while we lagged behind: continue with what is left.
+                let seqs = segments::list_segments(&self.base_dir);
+                self.segment = seqs.iter().copied().find(|&seq| seq > self.segment).unwrap_or(0);
+                self.telemetry_offset = 0;
+                self.rx.clear();
+                if self.segment == 0 {
+                    return;
+                }
+                continue;
+            }
+            if !complete {
+                return;
+            }
+            // Records never straddle segments; a leftover is a truncated tail.
+            self.segment += 1;
+            self.telemetry_offset = 0;
+            self.rx.clear();
         }
     }
 
-    fn drain_lines(&mut self) {
-        let file = match fs::File::open(&self.telemetry_path) {
+    // Reads the current segment from telemetry_offset to its end and parses it. False if the
+    // segment is gone.
+    fn read_segment(&mut self) -> bool {
+        let path = segments::segment_path(&self.base_dir, self.segment, segments::DATA_EXT);
+        let mut file = match fs::File::open(path) {
             Ok(f) => f,
-            Err(_) => return,
+            Err(_) => return false,
         };
-        let mut reader = BufReader::new(file);
-        if reader.seek(SeekFrom::Start(self.telemetry_offset)).is_err() {
-            return;
+        if file.seek(SeekFrom::Start(self.telemetry_offset)).is_err() {
+            return true;
+        }
+        match file.read_to_end(&mut self.rx) {
+            Ok(0) | Err(_) => return true,
+            Ok(n) => self.telemetry_offset += n as u64,
         }
-        let mut line = String::new();
-        while let Ok(bytes) = reader.read_line(&mut line) {
-            if bytes == 0 {
+        self.parse_rx();
+        true
+    }
+
+    fn parse_rx(&mut self) {
+        let rx = std::mem::take(&mut self.rx);
+        let mut pos = 0;
+        while pos < rx.len() {
+            let rest = &rx[pos..];
+            if wire::frame_at(rest) {
+                match wire::scan_frame(rest, MAX_FRAME_BODY) {
+                    wire::Scan::NeedMore => break,
+                    // Skip the magic byte and resync on the next newline or frame.
+                    wire::Scan::Bad => pos += 1,
+                    wire::Scan::Corrupt(size) => pos += size,
+                    wire::Scan::Frame {
+                        version,
+                        kind,
+                        body,
+                        size,
+                    } => {
+                        self.handle_frame(version, kind, body);
+                        pos += size;
+                    }
+                }
+                continue;
+            }
+            // Text records run to their newline; anything else is skipped up to the next
+            // newline or frame.
+            if rest.len() < 2 {
                 break;
             }
-            self.telemetry_offset += bytes as u64;
-            if let Some(frame) = self.parse_telemetry_line(line.trim_end()) {
-                self.pending_telemetry.push(frame);
-            } else if let Some(result) = self.parse_result_line(line.trim_end()) {
-                self.pending_results.push(result);
+            let known = matches!(rest[0], b'T' | b'I' | b'K' | b'D' | b'S' | b'R' | b'F') && rest[1] == b'|';
+            let end = if known {
+                rest.iter().position(|&b| b == b'\n')
+            } else {
+                rest.iter().position(|&b| b == b'\n' || b == wire::WIRE_MAGIC[0])
+            };
+            let Some(end) = end else {
+                if !known {
+                    pos = rx.len();
+                }
+                break;
+            };
+            if known {
+                let line = String::from_utf8_lossy(&rest[..end]);
+                self.handle_line(line.trim_end());
             }
-            line.clear();
+            pos += if rest[end] == b'\n' { end + 1 } else { end };
+        }
+        self.rx = rx[pos..].to_vec();
+    }
+
+    fn handle_line(&mut self, line: &str) {
+        if let Some(schema) = self.parse_schema_line(line) {
+            self.schemas.insert(schema);
+            return;
+        }
+        if line.starts_with("K|") || line.starts_with("D|") {
+            if let Some(frame) = self.parse_delta_line(line) {
+                self.push_telemetry(frame);
+            }
+            return;
+        }
+        if let Some(frame) = self.parse_interned_line(line).or_else(|| self.parse_telemetry_line(line)) {
+            self.push_telemetry(frame);
+            return;
+        }
+        if self.skip_before_ns.is_some() {
+            return;
+        }
+        if let Some(result) = self.parse_result_line(line) {
+            self.pending_results.push(result);
+        } else if let Some(credit) = self.parse_credit_line(line) {
+            self.latest_credit = Some(credit);
+        }
+    }
+
+    // After a seek to a timestamp, everything up to the first telemetry frame at or after it
+    // is dropped.
+    fn push_telemetry(&mut self, frame: TelemetryFrame) {
+        if let Some(start) = self.skip_before_ns {
+            if frame.timestamp_ns < start {
+                return;
+            }
+            self.skip_before_ns = None;
+        }
+        self.pending_telemetry.push(frame);
+    }
+
+    fn handle_frame(&mut self, version: u8, kind: u8, body: &[u8]) {
+        if kind == wire::FRAME_HELLO {
+            if let Some((agreed, features)) = wire::decode_hello(body) {
+                self.wire_version = agreed.min(wire::WIRE_VERSION);
+                self.wire_features = features;
+            }
+            return;
+        }
+        if version != wire::WIRE_VERSION {
+            return;
+        }
+        match kind {
+            wire::FRAME_SCHEMA => {
+                if let Some(schema) = wire::decode_schema(body) {
+                    self.schemas.insert(schema);
+                }
+                return;
+            }
+            wire::FRAME_TELEMETRY | wire::FRAME_INTERNED_TELEMETRY | wire::FRAME_DELTA_TELEMETRY => {
+                let frame = match kind {
+                    wire::FRAME_TELEMETRY => wire::decode_telemetry(body),
+                    wire::FRAME_INTERNED_TELEMETRY => wire::decode_interned_telemetry(body, &self.schemas),
+                    _ => wire::decode_delta_telemetry(body, &self.schemas, &mut self.joint_delta),
+                };
+                if let Some(frame) = frame {
+                    self.push_telemetry(frame);
+                }
+                return;
+            }
+            _ => {}
+        }
+        if self.skip_before_ns.is_some() {
+            return;
+        }
+        match kind {
+            wire::FRAME_RESULT => {
+                if let Some(result) = wire::decode_result(body) {
+                    self.pending_results.push(result);
+                }
+            }
+            wire::FRAME_CREDIT => {
+                if let Some(credit) = wire::decode_credit(body) {
+                    self.latest_credit = Some(credit);
+                }
+            }
+            _ => {}
         }
     }
 }
 
 impl Transport for Iceoryx2Transport {
     fn send_command(&mut self, command: CommandEnvelope) -> bool {
-        let line = self.encode_command(&command);
-        let mut file = match OpenOptions::new().append(true).open(&self.command_path) {
-            Ok(f) => f,
-            Err(_) => return false,
-        };
-        if writeln!(file, "{}", line).is_err() {
-            return false;
+        // Pick up a pending Hello acknowledgement before choosing the encoding.
+        if self.hello_sent && self.wire_version == 0 {
+            self.drain_lines();
         }
-        true
+        if self.wire_version >= 1 {
+            let mut frame = Vec::with_capacity(wire::WIRE_HEADER_LEN + 32 + command.payload_json.len());
+            wire::encode_command(&mut frame, &command);
+            return self.append_command_bytes(&frame);
+        }
+        let line = self.encode_command(&command);
+        self.append_command_bytes(line.as_bytes())
     }
 
     fn receive_telemetry(&mut self) -> Vec<TelemetryFrame> {
@@ -188,4 +571,9 @@ impl Transport for Iceoryx2Transport {
         self.drain_lines();
         std::mem::take(&mut self.pending_results)
     }
+
+    fn latest_flow_credit(&mut self) -> Option<FlowCredit> {
+        self.drain_lines();
+        self.latest_credit
+    }
 }
@@ -0,0 +1,66 @@
+/// Joint values of a keyframe/delta telemetry stream (K| / D| lines, DeltaTelemetry frames;
+/// subsystems/JointDeltaEncoder.hpp on the core side).
+///
+/// Holds the quantized integers of the last frame applied. A keyframe replaces them and a delta
+/// adds to them, so they always equal the core's; values are rebuilt as `q * resolution`, within
+/// `resolution / 2` of what the core had. A delta that does not directly follow the last frame
+/// (a dropped frame, a seek) is refused, and so is everything after it until the next keyframe.
+#[derive(Debug, Default)]
+pub(crate) struct JointDeltaDecoder {
+    schema_id: u32,
+    seq: u32,
+    resolution: [f64; 3],
+    values: Vec<i64>,
+    valid: bool,
+    // Decoded but not yet applied values of the frame at hand.
+    pub scratch: Vec<i64>,
+}
+
+impl JointDeltaDecoder {
+    pub fn reset(&mut self) {
+        self.valid = false;
+    }
+
+    /// Applies `scratch`: a keyframe when `resolution` is given (position, velocity, load),
+    /// a delta otherwise. False if the frame cannot be applied.
+    pub fn apply(&mut self, schema_id: u32, seq: u32, resolution: Option<[f64; 3]>) -> bool {
+        match resolution {
+            Some(resolution) => {
+                std::mem::swap(&mut self.values, &mut self.scratch);
+                self.resolution = resolution;
+                self.schema_id = schema_id;
+                self.valid = true;
+            }
+            None => {
+                let follows = self.valid
+                    && schema_id == self.schema_id
+                    && seq == self.seq.wrapping_add(1)
+                    && self.scratch.len() == self.values.len();
+                if !follows {
+                    self.valid = false;
+                    return false;
+                }
+                for (q, d) in self.values.iter_mut().zip(&self.scratch) {
+                    *q = q.wrapping_add(*d);
+                }
+            }
+        }
+        self.seq = seq;
+        true
+    }
+
+    /// Number of joints in the last frame applied.
+    pub fn joint_count(&self) -> usize {
+        self.values.len() / 3
+    }
+
+    /// Position, velocity and load of joint i.
+    pub fn joint(&self, i: usize) -> (f64, f64, f64) {
+        let q = &self.values[3 * i..3 * i + 3];
+        (
+            q[0] as f64 * self.resolution[0],
+            q[1] as f64 * self.resolution[1],
+            q[2] as f64 * self.resolution[2],
+        )
+    }
+}
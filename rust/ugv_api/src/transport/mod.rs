@@ -1,5 +1,14 @@
 mod iceoryx2_transport;
+mod joint_delta;
+mod schema;
+mod segments;
+#[cfg(target_os = "linux")]
+mod shm_transport;
 mod transport;
+mod wire;
 
 pub use iceoryx2_transport::Iceoryx2Transport;
+pub use segments::TelemetryStart;
+#[cfg(target_os = "linux")]
+pub use shm_transport::ShmTransport;
 pub use transport::Transport;
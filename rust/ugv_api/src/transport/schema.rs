@@ -0,0 +1,41 @@
+use std::sync::Arc;
+
+/// Joint and sensor identity announced by the core's schema records (S| lines, Schema frames;
+/// subsystems/TelemetrySchema.hpp). Interned frames carry joint values in `joints` order and a
+/// channel index per sensor; the strings are shared with every frame decoded against it.
+#[derive(Debug, Clone, Default)]
+pub(crate) struct TelemetrySchema {
+    pub id: u32,
+    pub joints: Vec<(Arc<str>, Arc<str>)>,   // id, name
+    pub channels: Vec<(Arc<str>, Arc<str>)>, // id, type
+}
+
+/// The current schema and the one before it: frames encoded just before a change can land
+/// after the new schema in the stream.
+#[derive(Debug, Default)]
+pub(crate) struct SchemaCache {
+    current: Option<TelemetrySchema>,
+    previous: Option<TelemetrySchema>,
+}
+
+impl SchemaCache {
+    pub fn insert(&mut self, schema: TelemetrySchema) {
+        // The core restarts ids with each run; a repeated id replaces the old schema.
+        if self.current.as_ref().is_some_and(|current| current.id != schema.id) {
+            self.previous = self.current.take();
+        }
+        self.current = Some(schema);
+    }
+
+    pub fn get(&self, id: u32) -> Option<&TelemetrySchema> {
+        [&self.current, &self.previous]
+            .into_iter()
+            .flatten()
+            .find(|schema| schema.id == id)
+    }
+
+    pub fn clear(&mut self) {
+        self.current = None;
+        self.previous = None;
+    }
+}
@@ -0,0 +1,207 @@
+//! Telemetry segment files written by the core's TelemetryWriter
+//! (subsystems/TelemetryWriter.hpp): `telemetry.<seq>.out` with the records and
+//! `telemetry.<seq>.idx` with 16-byte little-endian `{u64 timestamp_ns, u64 offset}` entries,
+//! timestamps ascending. seq only grows; the core starts `seq + 1` once `seq` is complete.
+
+use std::fs::{self, File};
+use std::io::{Read, Seek, SeekFrom};
+use std::path::{Path, PathBuf};
+
+const PREFIX: &str = "telemetry.";
+const SEQ_DIGITS: usize = 10;
+const INDEX_ENTRY_LEN: u64 = 16;
+
+pub(crate) const DATA_EXT: &str = ".out";
+pub(crate) const INDEX_EXT: &str = ".idx";
+
+/// Where a file-transport client starts reading telemetry.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum TelemetryStart {
+    /// The oldest segment still on disk.
+    Oldest,
+    /// The end of the newest segment: only records written from now on.
+    Now,
+    /// The first telemetry frame at or after this core timestamp (steady clock, ns). Results and
+    /// credits before it are skipped as well.
+    Timestamp(u64),
+}
+
+pub(crate) fn segment_path(dir: &Path, seq: u64, ext: &str) -> PathBuf {
+    dir.join(format!("{PREFIX}{seq:0width$}{ext}", width = SEQ_DIGITS))
+}
+
+fn parse_segment_name(name: &str) -> Option<u64> {
+    let digits = name.strip_prefix(PREFIX)?.strip_suffix(DATA_EXT)?;
+    if digits.len() != SEQ_DIGITS || !digits.bytes().all(|b| b.is_ascii_digit()) {
+        return None;
+    }
+    digits.parse().ok().filter(|&seq| seq != 0)
+}
+
+/// Sequence numbers of the segments in dir, ascending.
+pub(crate) fn list_segments(dir: &Path) -> Vec<u64> {
+    let mut seqs: Vec<u64> = match fs::read_dir(dir) {
+        Ok(entries) => entries
+            .filter_map(|entry| parse_segment_name(entry.ok()?.file_name().to_str()?))
+            .collect(),
+        Err(_) => Vec::new(),
+    };
+    seqs.sort_unstable();
+    seqs
+}
+
+struct Index {
+    file: File,
+    len: u64,
+}
+
+impl Index {
+    fn open(dir: &Path, seq: u64) -> Option<Self> {
+        let file = File::open(segment_path(dir, seq, INDEX_EXT)).ok()?;
+        // A trailing partial entry is still being written; leave it out.
+        let len = file.metadata().ok()?.len() / INDEX_ENTRY_LEN;
+        Some(Self { file, len })
+    }
+
+    fn entry(&mut self, i: u64) -> Option<(u64, u64)> {
+        let mut raw = [0u8; INDEX_ENTRY_LEN as usize];
+        self.file.seek(SeekFrom::Start(i * INDEX_ENTRY_LEN)).ok()?;
+        self.file.read_exact(&mut raw).ok()?;
+        let timestamp_ns = u64::from_le_bytes(raw[..8].try_into().ok()?);
+        let offset = u64::from_le_bytes(raw[8..].try_into().ok()?);
+        Some((timestamp_ns, offset))
+    }
+
+    // Offset of the last entry at or before timestamp_ns, or 0 if there is none.
+    fn offset_before(&mut self, timestamp_ns: u64) -> u64 {
+        let (mut lo, mut hi) = (0, self.len);
+        let mut offset = 0;
+        while lo < hi {
+            let mid = lo + (hi - lo) / 2;
+            match self.entry(mid) {
+                Some((ts, at)) if ts <= timestamp_ns => {
+                    offset = at;
+                    lo = mid + 1;
+                }
+                _ => hi = mid,
+            }
+        }
+        offset
+    }
+}
+
+fn first_timestamp(dir: &Path, seq: u64) -> Option<u64> {
+    let mut index = Index::open(dir, seq)?;
+    if index.len == 0 {
+        return None;
+    }
+    index.entry(0).map(|(ts, _)| ts)
+}
+
+/// Segment and offset to start reading at for the first telemetry frame at or after
+/// timestamp_ns: a binary search over the segments' first index entries, then over the index of
+/// the one found. None when there are no segments.
+pub(crate) fn locate(dir: &Path, timestamp_ns: u64) -> Option<(u64, u64)> {
+    let seqs = list_segments(dir);
+    let (mut lo, mut hi) = (0, seqs.len());
+    let mut found = None;
+    while lo < hi {
+        let mid = lo + (hi - lo) / 2;
+        // A segment without index entries yet is treated as later than the target; at worst
+        // the search lands one segment early and reads through it.
+        match first_timestamp(dir, seqs[mid]) {
+            Some(ts) if ts <= timestamp_ns => {
+                found = Some(mid);
+                lo = mid + 1;
+            }
+            _ => hi = mid,
+        }
+    }
+    let Some(at) = found else {
+        return seqs.first().map(|&seq| (seq, 0));
+    };
+    let seq = seqs[at];
+    let offset = Index::open(dir, seq).map_or(0, |mut index| index.offset_before(timestamp_ns));
+    Some((seq, offset))
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    struct TempDir(PathBuf);
+
+    impl TempDir {
+        fn new(name: &str) -> Self {
+            let dir = std::env::temp_dir().join(format!("ugv_api_{name}_{}", std::process::id()));
+            let _ = fs::remove_dir_all(&dir);
+            fs::create_dir_all(&dir).unwrap();
+            Self(dir)
+        }
+    }
+
+    impl Drop for TempDir {
+        fn drop(&mut self) {
+            let _ = fs::remove_dir_all(&self.0);
+        }
+    }
+
+    fn write_segment(dir: &Path, seq: u64, entries: &[(u64, u64)]) {
+        fs::write(segment_path(dir, seq, DATA_EXT), b"").unwrap();
+        let mut index = Vec::new();
+        for (ts, offset) in entries {
+            index.extend_from_slice(&ts.to_le_bytes());
+            index.extend_from_slice(&offset.to_le_bytes());
+        }
+        fs::write(segment_path(dir, seq, INDEX_EXT), index).unwrap();
+    }
+
+    #[test]
+    fn segment_names_are_parsed_strictly() {
+        assert_eq!(parse_segment_name("telemetry.0000000012.out"), Some(12));
+        assert_eq!(parse_segment_name("telemetry.0000000000.out"), None);
+        assert_eq!(parse_segment_name("telemetry.12.out"), None);
+        assert_eq!(parse_segment_name("telemetry.0000000012.idx"), None);
+        assert_eq!(parse_segment_name("telemetry.00000000x2.out"), None);
+    }
+
+    #[test]
+    fn locate_searches_segments_then_index() {
+        let tmp = TempDir::new("locate");
+        let dir = tmp.0.as_path();
+        assert_eq!(locate(dir, 0), None);
+
+        write_segment(dir, 3, &[(100, 0), (200, 64), (300, 128)]);
+        write_segment(dir, 4, &[(400, 0), (500, 96)]);
+        write_segment(dir, 10, &[(900, 0), (1000, 40), (1100, 80), (1200, 120)]);
+        fs::write(dir.join("telemetry.0000000007.tmp"), b"").unwrap();
+        assert_eq!(list_segments(dir), vec![3, 4, 10]);
+
+        // Before everything: the oldest segment from its start.
+        assert_eq!(locate(dir, 50), Some((3, 0)));
+        assert_eq!(locate(dir, 100), Some((3, 0)));
+        // Between entries: the last entry at or before the target.
+        assert_eq!(locate(dir, 250), Some((3, 64)));
+        assert_eq!(locate(dir, 399), Some((3, 128)));
+        assert_eq!(locate(dir, 500), Some((4, 96)));
+        assert_eq!(locate(dir, 1150), Some((10, 80)));
+        assert_eq!(locate(dir, u64::MAX), Some((10, 120)));
+    }
+
+    #[test]
+    fn locate_tolerates_segments_being_written() {
+        let tmp = TempDir::new("locate_partial");
+        let dir = tmp.0.as_path();
+        write_segment(dir, 1, &[(100, 0), (200, 50)]);
+        // The newest segment has no complete index entry yet: the search stays on the one before.
+        write_segment(dir, 2, &[]);
+        fs::write(segment_path(dir, 2, INDEX_EXT), [0u8; 10]).unwrap();
+        assert_eq!(locate(dir, 5_000), Some((1, 50)));
+
+        // A trailing partial entry is ignored.
+        let mut index = fs::read(segment_path(dir, 1, INDEX_EXT)).unwrap();
+        index.extend_from_slice(&300u64.to_le_bytes());
+        fs::write(segment_path(dir, 1, INDEX_EXT), index).unwrap();
+        assert_eq!(locate(dir, 5_000), Some((1, 50)));
+    }
+}
@@ -0,0 +1,513 @@
+use std::ffi::CString;
+use std::io;
+use std::ptr::{self, NonNull};
+use std::sync::atomic::{AtomicI32, AtomicU32, AtomicU64, Ordering};
+use std::time::Duration;
+
+use crate::commands::{CommandEnvelope, CommandResult, CommandResultEvent};
+use crate::telemetry::{FlowCredit, TelemetryFrame};
+use crate::transport::wire;
+use crate::transport::Transport;
+
+// Segment layout, mirrored from subsystems/ShmLayout.hpp. Bump together with kShmVersion.
+const SHM_MAGIC: u32 = 0x4853_5241; // 'ARSH'
+const SHM_VERSION: u32 = 1;
+
+const HDR_MAGIC: usize = 0;
+const HDR_VERSION: usize = 4;
+const HDR_SIZE: usize = 8;
+const HDR_SESSION: usize = 16;
+const HDR_STATE: usize = 24;
+const HDR_CLIENT_PID: usize = 28;
+const HDR_COMMANDS: usize = 64;
+const HDR_RESULTS: usize = 256;
+const HDR_EVENTS: usize = 448;
+const HDR_TELEMETRY: usize = 640;
+const HDR_TO_CORE: usize = 832;
+const HDR_TO_CLIENT: usize = 896;
+const HDR_LEN: usize = 960;
+
+const RING_OFFSET: usize = 0;
+const RING_SLOTS: usize = 8;
+const RING_SLOT_SIZE: usize = 12;
+const RING_HEAD: usize = 64;
+const RING_TAIL: usize = 128;
+
+const BELL_SEQ: usize = 0;
+const BELL_WAITERS: usize = 4;
+
+const SLOT_SEQ: usize = 0;
+const SLOT_SIZE: usize = 8;
+const SLOT_HEADER_LEN: usize = 16;
+
+const STATE_READY: u32 = 1;
+
+const MAX_PAYLOAD: usize = 4096;
+const COMMAND_RECORD_LEN: usize = 32 + MAX_PAYLOAD;
+const RESULT_RECORD_LEN: usize = 160;
+const RECORD_KIND_RESULT: u8 = 1;
+const RECORD_KIND_CREDIT: u8 = 2;
+
+/// Client of the core's shared-memory command link (`/dev/shm/<name>`, see
+/// `subsystems/ShmLayout.hpp`). Commands, results and telemetry move through fixed-slot SPSC
+/// rings in the mapping; nothing goes through a file or a text parser.
+///
+/// Only one client may be attached at a time. When the core shuts down or restarts the
+/// segment is replaced: `is_closed()` turns true and the transport has to be reopened.
+pub struct ShmTransport {
+    map: NonNull<u8>,
+    len: usize,
+    session: u64,
+    commands: Ring,
+    results: Ring,
+    events: Ring,
+    telemetry: Ring,
+    pending_results: Vec<CommandResultEvent>,
+    latest_credit: Option<FlowCredit>,
+}
+
+// The mapping is owned by this value; all shared state in it is accessed through atomics.
+unsafe impl Send for ShmTransport {}
+
+impl ShmTransport {
+    /// Attaches to the segment the core created with `ShmLinkConfig::name` (default `arcraven_ugv`).
+    pub fn open(name: &str) -> io::Result<Self> {
+        let c_name = CString::new(format!("/{name}")).map_err(|_| io::Error::from(io::ErrorKind::InvalidInput))?;
+        // SAFETY: plain libc calls on an owned fd; the mapping is checked before any access below.
+        let (map, len) = unsafe {
+            let fd = libc::shm_open(c_name.as_ptr(), libc::O_RDWR | libc::O_CLOEXEC, 0);
+            if fd < 0 {
+                return Err(io::Error::last_os_error());
+            }
+            let mut st: libc::stat = std::mem::zeroed();
+            if libc::fstat(fd, &mut st) != 0 {
+                let err = io::Error::last_os_error();
+                libc::close(fd);
+                return Err(err);
+            }
+            let len = st.st_size as usize;
+            if len < HDR_LEN {
+                libc::close(fd);
+                return Err(invalid("segment too small"));
+            }
+            let map = libc::mmap(ptr::null_mut(), len, libc::PROT_READ | libc::PROT_WRITE, libc::MAP_SHARED, fd, 0);
+            libc::close(fd);
+            if map == libc::MAP_FAILED {
+                return Err(io::Error::last_os_error());
+            }
+            (NonNull::new_unchecked(map as *mut u8), len)
+        };
+
+        let mut transport = Self {
+            map,
+            len,
+            session: 0,
+            commands: Ring::default(),
+            results: Ring::default(),
+            events: Ring::default(),
+            telemetry: Ring::default(),
+            pending_results: Vec::new(),
+            latest_credit: None,
+        };
+        transport.attach()?;
+        Ok(transport)
+    }
+
+    /// True once the core has shut down (or replaced the segment); reopen to reconnect.
+    pub fn is_closed(&self) -> bool {
+        self.atomic_u32(HDR_STATE).load(Ordering::Acquire) != STATE_READY
+    }
+
+    /// Core start time of the attached segment (changes on every core restart).
+    pub fn session(&self) -> u64 {
+        self.session
+    }
+
+    /// Blocks until the core publishes a result, credit or telemetry frame, or `timeout`
+    /// passes. Returns true if something is ready to be received.
+    pub fn wait(&self, timeout: Duration) -> bool {
+        let seq = self.atomic_u32(HDR_TO_CLIENT + BELL_SEQ);
+        let waiters = self.atomic_u32(HDR_TO_CLIENT + BELL_WAITERS);
+        waiters.fetch_add(1, Ordering::SeqCst);
+        let seen = seq.load(Ordering::SeqCst);
+        if !self.has_pending() && !self.is_closed() {
+            let ts = libc::timespec {
+                tv_sec: timeout.as_secs() as libc::time_t,
+                tv_nsec: timeout.subsec_nanos() as libc::c_long,
+            };
+            // SAFETY: seq lives in the mapping for as long as self does.
+            unsafe {
+                libc::syscall(libc::SYS_futex, seq.as_ptr(), libc::FUTEX_WAIT, seen, &ts as *const libc::timespec,
+                              ptr::null::<u32>(), 0);
+            }
+        }
+        waiters.fetch_sub(1, Ordering::SeqCst);
+        self.has_pending()
+    }
+
+    fn attach(&mut self) -> io::Result<()> {
+        if self.read_u32(HDR_MAGIC) != SHM_MAGIC || self.read_u32(HDR_VERSION) != SHM_VERSION {
+            return Err(invalid("not an arcraven shm segment of this version"));
+        }
+        if self.read_u64(HDR_SIZE) as usize != self.len {
+            return Err(invalid("segment size mismatch"));
+        }
+        if self.is_closed() {
+            return Err(io::Error::new(io::ErrorKind::NotConnected, "core is not running"));
+        }
+        self.session = self.read_u64(HDR_SESSION);
+        self.commands = self.ring(HDR_COMMANDS, COMMAND_RECORD_LEN)?;
+        self.results = self.ring(HDR_RESULTS, RESULT_RECORD_LEN)?;
+        self.events = self.ring(HDR_EVENTS, RESULT_RECORD_LEN)?;
+        self.telemetry = self.ring(HDR_TELEMETRY, 16)?;
+
+        // Take the client slot; a previous client that died without detaching is replaced.
+        let me = std::process::id() as i32;
+        let owner = self.atomic_i32(HDR_CLIENT_PID);
+        let mut current = 0;
+        loop {
+            match owner.compare_exchange(current, me, Ordering::AcqRel, Ordering::Acquire) {
+                Ok(_) => return Ok(()),
+                Err(pid) if pid != 0 && !process_alive(pid) => current = pid,
+                Err(0) => current = 0,
+                Err(_) => return Err(io::Error::new(io::ErrorKind::AddrInUse, "another client is attached")),
+            }
+        }
+    }
+
+    fn ring(&self, header: usize, min_record: usize) -> io::Result<Ring> {
+        let offset = self.read_u64(header + RING_OFFSET) as usize;
+        let slots = self.read_u32(header + RING_SLOTS) as usize;
+        let slot_size = self.read_u32(header + RING_SLOT_SIZE) as usize;
+        let fits = slots
+            .checked_mul(slot_size)
+            .and_then(|n| n.checked_add(offset))
+            .is_some_and(|end| end <= self.len);
+        if !slots.is_power_of_two() || slot_size < SLOT_HEADER_LEN + min_record || slot_size & 63 != 0 || !fits {
+            return Err(invalid("bad ring geometry"));
+        }
+        // SAFETY: header and slot area were bounds-checked against the mapping above.
+        unsafe {
+            Ok(Ring {
+                header: self.map.as_ptr().add(header),
+                slots: self.map.as_ptr().add(offset),
+                mask: slots as u64 - 1,
+                slot_size,
+            })
+        }
+    }
+
+    fn has_pending(&self) -> bool {
+        self.results.front().is_some() || self.events.front().is_some() || self.telemetry.front().is_some()
+    }
+
+    fn drain_results(&mut self, from_events: bool) {
+        let ring = if from_events { &self.events } else { &self.results };
+        while let Some((rec, _)) = ring.front() {
+            // SAFETY: result slots hold at least RESULT_RECORD_LEN bytes (checked in ring()).
+            let kind = unsafe { *rec.add(28) };
+            if kind == RECORD_KIND_CREDIT {
+                self.latest_credit = Some(FlowCredit {
+                    timestamp_ns: unsafe { read_at(rec, 8) },
+                    credits: unsafe { read_at(rec, 16) },
+                    queued: unsafe { read_at(rec, 20) },
+                    capacity: unsafe { read_at(rec, 24) },
+                    backpressure: unsafe { *rec.add(31) } != 0,
+                });
+            } else if kind == RECORD_KIND_RESULT {
+                let message_len = usize::from(unsafe { *rec.add(32) }).min(RESULT_RECORD_LEN - 40);
+                let message = unsafe { std::slice::from_raw_parts(rec.add(40), message_len) };
+                self.pending_results.push(CommandResultEvent {
+                    command_id: unsafe { read_at(rec, 0) },
+                    result: CommandResult {
+                        status: wire::status_from_u16(u16::from(unsafe { *rec.add(29) })),
+                        reject_reason: wire::reject_from_u16(u16::from(unsafe { *rec.add(30) })),
+                        message: String::from_utf8_lossy(message).into_owned(),
+                    },
+                });
+            }
+            ring.pop();
+        }
+    }
+
+    fn read_u32(&self, offset: usize) -> u32 {
+        // SAFETY: offset < HDR_LEN <= len.
+        unsafe { read_at(self.map.as_ptr(), offset) }
+    }
+
+    fn read_u64(&self, offset: usize) -> u64 {
+        // SAFETY: offset < HDR_LEN <= len.
+        unsafe { read_at(self.map.as_ptr(), offset) }
+    }
+
+    fn atomic_u32(&self, offset: usize) -> &AtomicU32 {
+        // SAFETY: aligned header field inside the mapping.
+        unsafe { &*(self.map.as_ptr().add(offset) as *const AtomicU32) }
+    }
+
+    fn atomic_i32(&self, offset: usize) -> &AtomicI32 {
+        // SAFETY: aligned header field inside the mapping.
+        unsafe { &*(self.map.as_ptr().add(offset) as *const AtomicI32) }
+    }
+}
+
+impl Drop for ShmTransport {
+    fn drop(&mut self) {
+        let me = std::process::id() as i32;
+        let _ = self.atomic_i32(HDR_CLIENT_PID).compare_exchange(me, 0, Ordering::AcqRel, Ordering::Relaxed);
+        // SAFETY: map/len came from mmap in open().
+        unsafe {
+            libc::munmap(self.map.as_ptr() as *mut libc::c_void, self.len);
+        }
+    }
+}
+
+impl Transport for ShmTransport {
+    fn send_command(&mut self, command: CommandEnvelope) -> bool {
+        let payload = command.payload_json.as_bytes();
+        if self.is_closed() || payload.len() > MAX_PAYLOAD {
+            return false;
+        }
+        let Some(rec) = self.commands.claim() else {
+            return false; // core is a full ring behind: back off
+        };
+        // SAFETY: command slots hold COMMAND_RECORD_LEN bytes (checked in ring()).
+        unsafe {
+            write_at(rec, 0, command.command_id);
+            write_at(rec, 8, command.issued_ns);
+            write_at(rec, 16, command.ttl_ns);
+            write_at(rec, 24, command.command as u16);
+            *rec.add(26) = command.domain as u8;
+            *rec.add(27) = command.priority as u8;
+            *rec.add(28) = command.authority as u8;
+            *rec.add(29) = 0;
+            write_at(rec, 30, payload.len() as u16);
+            ptr::copy_nonoverlapping(payload.as_ptr(), rec.add(32), payload.len());
+        }
+        self.commands.publish((32 + payload.len()) as u32);
+        ring_doorbell(self.atomic_u32(HDR_TO_CORE + BELL_SEQ), self.atomic_u32(HDR_TO_CORE + BELL_WAITERS));
+        true
+    }
+
+    fn receive_telemetry(&mut self) -> Vec<TelemetryFrame> {
+        let mut frames = Vec::new();
+        while let Some((rec, size)) = self.telemetry.front() {
+            // SAFETY: size is clamped to the slot's record area in front().
+            let bytes = unsafe { std::slice::from_raw_parts(rec, size) };
+            if let Some(frame) = wire::decode_telemetry(bytes) {
+                frames.push(frame);
+            }
+            self.telemetry.pop();
+        }
+        frames
+    }
+
+    fn receive_command_results(&mut self) -> Vec<CommandResultEvent> {
+        self.drain_results(false);
+        self.drain_results(true);
+        std::mem::take(&mut self.pending_results)
+    }
+
+    fn latest_flow_credit(&mut self) -> Option<FlowCredit> {
+        self.drain_results(true);
+        self.latest_credit
+    }
+}
+
+// One SPSC ring of the mapping (see ShmLayout.hpp for the protocol).
+struct Ring {
+    header: *mut u8,
+    slots: *mut u8,
+    mask: u64,
+    slot_size: usize,
+}
+
+impl Default for Ring {
+    fn default() -> Self {
+        Self {
+            header: ptr::null_mut(),
+            slots: ptr::null_mut(),
+            mask: 0,
+            slot_size: 0,
+        }
+    }
+}
+
+impl Ring {
+    fn head(&self) -> &AtomicU64 {
+        // SAFETY: header points at a ShmRingHeader in the mapping.
+        unsafe { &*(self.header.add(RING_HEAD) as *const AtomicU64) }
+    }
+
+    fn tail(&self) -> &AtomicU64 {
+        // SAFETY: header points at a ShmRingHeader in the mapping.
+        unsafe { &*(self.header.add(RING_TAIL) as *const AtomicU64) }
+    }
+
+    fn slot(&self, pos: u64) -> *mut u8 {
+        // SAFETY: pos is masked to the slot count checked in ShmTransport::ring().
+        unsafe { self.slots.add((pos & self.mask) as usize * self.slot_size) }
+    }
+
+    fn slot_seq(&self, pos: u64) -> &AtomicU64 {
+        // SAFETY: slot headers are 64-byte aligned inside the mapping.
+        unsafe { &*(self.slot(pos).add(SLOT_SEQ) as *const AtomicU64) }
+    }
+
+    // Producer: record area of the next free slot.
+    fn claim(&self) -> Option<*mut u8> {
+        let head = self.head().load(Ordering::Relaxed);
+        if head - self.tail().load(Ordering::Acquire) > self.mask {
+            return None;
+        }
+        // SAFETY: the record area follows the slot header.
+        Some(unsafe { self.slot(head).add(SLOT_HEADER_LEN) })
+    }
+
+    fn publish(&self, size: u32) {
+        let head = self.head().load(Ordering::Relaxed);
+        // SAFETY: SLOT_SIZE lies inside the slot header.
+        unsafe { write_at(self.slot(head), SLOT_SIZE, size) };
+        self.slot_seq(head).store(head + 1, Ordering::Release);
+        self.head().store(head + 1, Ordering::Release);
+    }
+
+    // Consumer: oldest published record and its size.
+    fn front(&self) -> Option<(*const u8, usize)> {
+        if self.header.is_null() {
+            return None;
+        }
+        let tail = self.tail().load(Ordering::Relaxed);
+        if self.slot_seq(tail).load(Ordering::Acquire) != tail + 1 {
+            return None;
+        }
+        let slot = self.slot(tail);
+        // SAFETY: SLOT_SIZE lies inside the slot header; the record follows it.
+        let size: u32 = unsafe { read_at(slot, SLOT_SIZE) };
+        let size = (size as usize).min(self.slot_size - SLOT_HEADER_LEN);
+        Some((unsafe { slot.add(SLOT_HEADER_LEN) } as *const u8, size))
+    }
+
+    fn pop(&self) {
+        let tail = self.tail().load(Ordering::Relaxed);
+        self.tail().store(tail + 1, Ordering::Release);
+    }
+}
+
+fn ring_doorbell(seq: &AtomicU32, waiters: &AtomicU32) {
+    seq.fetch_add(1, Ordering::SeqCst);
+    if waiters.load(Ordering::SeqCst) != 0 {
+        // SAFETY: seq lives in the shared mapping; FUTEX_WAKE on it is harmless.
+        unsafe {
+            libc::syscall(libc::SYS_futex, seq.as_ptr(), libc::FUTEX_WAKE, i32::MAX, ptr::null::<libc::timespec>(),
+                          ptr::null::<u32>(), 0);
+        }
+    }
+}
+
+unsafe fn read_at<T: Copy>(base: *const u8, offset: usize) -> T {
+    ptr::read_unaligned(base.add(offset) as *const T)
+}
+
+unsafe fn write_at<T: Copy>(base: *mut u8, offset: usize, value: T) {
+    ptr::write_unaligned(base.add(offset) as *mut T, value)
+}
+
+fn process_alive(pid: i32) -> bool {
+    // SAFETY: signal 0 only checks for existence.
+    unsafe { libc::kill(pid, 0) == 0 || io::Error::last_os_error().raw_os_error() != Some(libc::ESRCH) }
+}
+
+fn invalid(what: &str) -> io::Error {
+    io::Error::new(io::ErrorKind::InvalidData, what.to_string())
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    const SLOTS: u64 = 4;
+    const SLOT_BYTES: usize = 64;
+
+    // A ring over heap memory laid out like the mapping: ShmRingHeader, then the slots.
+    struct HeapRing {
+        _mem: Vec<u64>,
+        ring: Ring,
+    }
+
+    fn heap_ring() -> HeapRing {
+        let mut mem = vec![0u64; (192 + SLOTS as usize * SLOT_BYTES) / 8];
+        let base = mem.as_mut_ptr() as *mut u8;
+        // SAFETY: both pointers stay inside mem, which outlives the ring.
+        let ring = unsafe {
+            Ring {
+                header: base,
+                slots: base.add(192),
+                mask: SLOTS - 1,
+                slot_size: SLOT_BYTES,
+            }
+        };
+        HeapRing { _mem: mem, ring }
+    }
+
+    fn push(ring: &Ring, value: u64) -> bool {
+        let Some(rec) = ring.claim() else {
+            return false;
+        };
+        // SAFETY: the record area holds SLOT_BYTES - SLOT_HEADER_LEN bytes.
+        unsafe { write_at(rec, 0, value) };
+        ring.publish(8);
+        true
+    }
+
+    fn pop(ring: &Ring) -> Option<u64> {
+        let (rec, size) = ring.front()?;
+        assert_eq!(size, 8);
+        // SAFETY: front() returned a published record of 8 bytes.
+        let value = unsafe { read_at(rec, 0) };
+        ring.pop();
+        Some(value)
+    }
+
+    #[test]
+    fn ring_wraps_around() {
+        let heap = heap_ring();
+        let ring = &heap.ring;
+        assert!(ring.front().is_none());
+        let mut next_in = 0;
+        let mut next_out = 0;
+        // Several laps with the ring alternately filled and drained part way.
+        for lap in 0..5 {
+            while push(ring, next_in) {
+                next_in += 1;
+            }
+            assert_eq!(next_in - next_out, SLOTS, "lap {lap}: a full ring takes exactly SLOTS records");
+            for _ in 0..3 {
+                assert_eq!(pop(ring), Some(next_out));
+                next_out += 1;
+            }
+        }
+        while let Some(value) = pop(ring) {
+            assert_eq!(value, next_out);
+            next_out += 1;
+        }
+        assert_eq!(next_out, next_in);
+        assert_eq!(ring.head().load(Ordering::Relaxed), next_in);
+        assert_eq!(ring.tail().load(Ordering::Relaxed), next_in);
+    }
+
+    #[test]
+    fn front_waits_for_publish_and_clamps_size() {
+        let heap = heap_ring();
+        let ring = &heap.ring;
+        assert!(ring.claim().is_some());
+        // Claimed but not published: nothing for the consumer yet.
+        assert!(ring.front().is_none());
+        ring.publish(u32::MAX);
+        let (_, size) = ring.front().expect("published record");
+        assert_eq!(size, SLOT_BYTES - SLOT_HEADER_LEN);
+        ring.pop();
+        assert!(ring.front().is_none());
+        assert!(Ring::default().front().is_none());
+    }
+}
@@ -1,8 +1,13 @@
 use crate::commands::{CommandEnvelope, CommandResultEvent};
-use crate::telemetry::TelemetryFrame;
+use crate::telemetry::{FlowCredit, TelemetryFrame};
 
 pub trait Transport {
     fn send_command(&mut self, command: CommandEnvelope) -> bool;
     fn receive_telemetry(&mut self) -> Vec<TelemetryFrame>;
     fn receive_command_results(&mut self) -> Vec<CommandResultEvent>;
+
+    /// Most recent queue credit advertisement, if the transport carries flow control.
+    fn latest_flow_credit(&mut self) -> Option<FlowCredit> {
+        None
+    }
 }
@@ -0,0 +1,501 @@
+use std::sync::Arc;
+
+use crate::commands::{CommandEnvelope, CommandResult, CommandResultEvent, CommandStatus, RejectReason};
+use crate::sensors::SensorPayload;
+use crate::telemetry::{FlowCredit, JointState, TelemetryFrame};
+use crate::transport::joint_delta::JointDeltaDecoder;
+use crate::transport::schema::{SchemaCache, TelemetrySchema};
+
+// Binary framing of the file transport, mirrored from subsystems/WireProtocol.hpp. Little-endian.
+// Header: magic, u8 version, u8 type, u16 flags, u32 length, u32 crc32c (header bytes 0..12 + body).
+pub(crate) const WIRE_MAGIC: [u8; 4] = [0xAC, b'U', b'G', b'V'];
+pub(crate) const WIRE_VERSION: u8 = 1;
+pub(crate) const WIRE_HEADER_LEN: usize = 16;
+
+pub(crate) const FRAME_HELLO: u8 = 1;
+pub(crate) const FRAME_COMMAND: u8 = 2;
+pub(crate) const FRAME_RESULT: u8 = 3;
+pub(crate) const FRAME_CREDIT: u8 = 4;
+pub(crate) const FRAME_TELEMETRY: u8 = 5;
+pub(crate) const FRAME_SCHEMA: u8 = 6;
+pub(crate) const FRAME_INTERNED_TELEMETRY: u8 = 7;
+pub(crate) const FRAME_DELTA_TELEMETRY: u8 = 8;
+
+// Hello feature bits.
+pub(crate) const FEATURE_INTERNED_TELEMETRY: u16 = 0x0001;
+pub(crate) const FEATURE_DELTA_TELEMETRY: u16 = 0x0002;
+
+pub(crate) fn status_from_u16(value: u16) -> CommandStatus {
+    match value {
+        1 => CommandStatus::Received,
+        2 => CommandStatus::Accepted,
+        3 => CommandStatus::Rejected,
+        4 => CommandStatus::Running,
+        5 => CommandStatus::Succeeded,
+        6 => CommandStatus::Failed,
+        7 => CommandStatus::Aborted,
+        8 => CommandStatus::Preempted,
+        9 => CommandStatus::Expired,
+        _ => CommandStatus::None,
+    }
+}
+
+pub(crate) fn reject_from_u16(value: u16) -> RejectReason {
+    match value {
+        1 => RejectReason::NotAuthorized,
+        2 => RejectReason::InvalidPayload,
+        3 => RejectReason::Unsupported,
+        4 => RejectReason::Unsafe,
+        5 => RejectReason::Busy,
+        6 => RejectReason::PreconditionsFail,
+        7 => RejectReason::Timeout,
+        8 => RejectReason::StaleCommand,
+        _ => RejectReason::None,
+    }
+}
+
+const CRC32C_TABLE: [u32; 256] = {
+    let mut table = [0u32; 256];
+    let mut i = 0;
+    while i < 256 {
+        let mut c = i as u32;
+        let mut b = 0;
+        while b < 8 {
+            c = if c & 1 != 0 { (c >> 1) ^ 0x82F6_3B78 } else { c >> 1 };
+            b += 1;
+        }
+        table[i] = c;
+        i += 1;
+    }
+    table
+};
+
+/// CRC-32C (Castagnoli); chainable like the C++ `arcraven::utils::crc32c`.
+pub(crate) fn crc32c(data: &[u8], crc: u32) -> u32 {
+    let mut c = !crc;
+    for &b in data {
+        c = (c >> 8) ^ CRC32C_TABLE[((c ^ u32::from(b)) & 0xFF) as usize];
+    }
+    !c
+}
+
+pub(crate) enum Scan<'a> {
+    Frame { version: u8, kind: u8, body: &'a [u8], size: usize },
+    NeedMore,
+    // Not a frame: skip a byte and resync on the next magic or newline.
+    Bad,
+    // Complete but failing its CRC: skip this many bytes.
+    Corrupt(usize),
+}
+
+/// True if `bytes` starts with the magic, or with a prefix of it when shorter.
+pub(crate) fn frame_at(bytes: &[u8]) -> bool {
+    let n = bytes.len().min(WIRE_MAGIC.len());
+    n > 0 && bytes[..n] == WIRE_MAGIC[..n]
+}
+
+pub(crate) fn scan_frame(bytes: &[u8], max_body: usize) -> Scan<'_> {
+    if bytes.len() < WIRE_HEADER_LEN {
+        return if frame_at(bytes) { Scan::NeedMore } else { Scan::Bad };
+    }
+    if bytes[..4] != WIRE_MAGIC {
+        return Scan::Bad;
+    }
+    let version = bytes[4];
+    let length = u32::from_le_bytes(bytes[8..12].try_into().unwrap()) as usize;
+    if version == 0 || length > max_body {
+        return Scan::Bad;
+    }
+    if bytes.len() - WIRE_HEADER_LEN < length {
+        return Scan::NeedMore;
+    }
+    let body = &bytes[WIRE_HEADER_LEN..WIRE_HEADER_LEN + length];
+    if crc32c(body, crc32c(&bytes[..12], 0)) != u32::from_le_bytes(bytes[12..16].try_into().unwrap()) {
+        return Scan::Corrupt(WIRE_HEADER_LEN + length);
+    }
+    Scan::Frame {
+        version,
+        kind: bytes[5],
+        body,
+        size: WIRE_HEADER_LEN + length,
+    }
+}
+
+fn begin_frame(out: &mut Vec<u8>) -> usize {
+    let at = out.len();
+    out.resize(at + WIRE_HEADER_LEN, 0);
+    at
+}
+
+fn finish_frame(out: &mut [u8], at: usize, kind: u8, version: u8) {
+    let length = (out.len() - at - WIRE_HEADER_LEN) as u32;
+    let frame = &mut out[at..];
+    frame[..4].copy_from_slice(&WIRE_MAGIC);
+    frame[4] = version;
+    frame[5] = kind;
+    frame[6..8].copy_from_slice(&0u16.to_le_bytes());
+    frame[8..12].copy_from_slice(&length.to_le_bytes());
+    let crc = crc32c(&frame[WIRE_HEADER_LEN..], crc32c(&frame[..12], 0));
+    frame[12..16].copy_from_slice(&crc.to_le_bytes());
+}
+
+pub(crate) fn encode_hello(out: &mut Vec<u8>, version: u8, features: u16) {
+    let at = begin_frame(out);
+    out.extend_from_slice(&u16::from(version).to_le_bytes());
+    out.extend_from_slice(&features.to_le_bytes());
+    finish_frame(out, at, FRAME_HELLO, 1);
+}
+
+pub(crate) fn encode_command(out: &mut Vec<u8>, command: &CommandEnvelope) {
+    let at = begin_frame(out);
+    out.extend_from_slice(&command.command_id.to_le_bytes());
+    out.extend_from_slice(&command.issued_ns.to_le_bytes());
+    out.extend_from_slice(&command.ttl_ns.to_le_bytes());
+    out.extend_from_slice(&(command.command as u16).to_le_bytes());
+    out.extend_from_slice(&[command.domain as u8, command.priority as u8, command.authority as u8, 0, 0, 0]);
+    out.extend_from_slice(command.payload_json.as_bytes());
+    finish_frame(out, at, FRAME_COMMAND, WIRE_VERSION);
+}
+
+/// Version and feature bits.
+pub(crate) fn decode_hello(body: &[u8]) -> Option<(u8, u16)> {
+    let mut r = FrameReader { bytes: body, pos: 0 };
+    let version = r.u16()?.min(u16::from(u8::MAX)) as u8;
+    Some((version, r.u16()?))
+}
+
+pub(crate) fn decode_result(body: &[u8]) -> Option<CommandResultEvent> {
+    let mut r = FrameReader { bytes: body, pos: 0 };
+    let command_id = r.u64()?;
+    let status = r.take(1)?[0];
+    let reject = r.take(1)?[0];
+    r.take(2)?;
+    Some(CommandResultEvent {
+        command_id,
+        result: CommandResult {
+            status: status_from_u16(u16::from(status)),
+            reject_reason: reject_from_u16(u16::from(reject)),
+            message: String::from_utf8_lossy(&body[r.pos..]).into_owned(),
+        },
+    })
+}
+
+pub(crate) fn decode_credit(body: &[u8]) -> Option<FlowCredit> {
+    let mut r = FrameReader { bytes: body, pos: 0 };
+    Some(FlowCredit {
+        timestamp_ns: r.u64()?,
+        credits: r.u32()?,
+        queued: r.u32()?,
+        capacity: r.u32()?,
+        backpressure: r.take(1)?[0] != 0,
+    })
+}
+
+/// Packed telemetry frame: a wire Telemetry body and a shared-memory telemetry slot alike
+/// (`pack_telemetry` in subsystems/WireProtocol.hpp).
+pub(crate) fn decode_telemetry(bytes: &[u8]) -> Option<TelemetryFrame> {
+    let mut r = FrameReader { bytes, pos: 0 };
+    let timestamp_ns = r.u64()?;
+    let joint_count = r.u32()? as usize;
+    let sensor_count = r.u32()? as usize;
+    let mut joints = Vec::with_capacity(joint_count.min(256));
+    for _ in 0..joint_count {
+        let id = r.str16()?.into();
+        let name = r.str16()?.into();
+        joints.push(JointState {
+            id,
+            name,
+            position: r.f64()?,
+            velocity: r.f64()?,
+            load: r.f64()?,
+        });
+    }
+    let mut payloads = Vec::with_capacity(sensor_count.min(256));
+    for _ in 0..sensor_count {
+        let id = r.str16()?.into();
+        let sensor_type = r.str16()?.into();
+        let len = r.u32()? as usize;
+        let payload = String::from_utf8_lossy(r.take(len)?).into_owned();
+        payloads.push(SensorPayload {
+            id,
+            sensor_type,
+            payload,
+        });
+    }
+    Some(TelemetryFrame {
+        timestamp_ns,
+        joints,
+        sensors: Vec::new(),
+        payloads,
+    })
+}
+
+pub(crate) fn decode_schema(body: &[u8]) -> Option<TelemetrySchema> {
+    let mut r = FrameReader { bytes: body, pos: 0 };
+    let id = r.u32()?;
+    let joint_count = r.u32()? as usize;
+    let channel_count = r.u32()? as usize;
+    let mut pair = || Some((Arc::<str>::from(r.str16()?), Arc::<str>::from(r.str16()?)));
+    let joints = (0..joint_count).map(|_| pair()).collect::<Option<Vec<_>>>()?;
+    let channels = (0..channel_count).map(|_| pair()).collect::<Option<Vec<_>>>()?;
+    Some(TelemetrySchema { id, joints, channels })
+}
+
+/// Interned telemetry frame; None if its schema is unknown or it does not match it.
+pub(crate) fn decode_interned_telemetry(body: &[u8], schemas: &SchemaCache) -> Option<TelemetryFrame> {
+    let mut r = FrameReader { bytes: body, pos: 0 };
+    let timestamp_ns = r.u64()?;
+    let schema = schemas.get(r.u32()?)?;
+    let sensor_count = r.u32()? as usize;
+    let mut joints = Vec::with_capacity(schema.joints.len());
+    for (id, name) in &schema.joints {
+        joints.push(JointState {
+            id: Arc::clone(id),
+            name: Arc::clone(name),
+            position: r.f64()?,
+            velocity: r.f64()?,
+            load: r.f64()?,
+        });
+    }
+    let mut payloads = Vec::with_capacity(sensor_count.min(256));
+    for _ in 0..sensor_count {
+        let (id, sensor_type) = schema.channels.get(usize::from(r.u16()?))?;
+        let len = r.u32()? as usize;
+        payloads.push(SensorPayload {
+            id: Arc::clone(id),
+            sensor_type: Arc::clone(sensor_type),
+            payload: String::from_utf8_lossy(r.take(len)?).into_owned(),
+        });
+    }
+    Some(TelemetryFrame {
+        timestamp_ns,
+        joints,
+        sensors: Vec::new(),
+        payloads,
+    })
+}
+
+/// Keyframe or delta telemetry frame, applied to `joints`; None if its schema is unknown, it
+/// does not match it, or (a delta) it does not follow the last frame applied.
+pub(crate) fn decode_delta_telemetry(
+    body: &[u8],
+    schemas: &SchemaCache,
+    joints: &mut JointDeltaDecoder,
+) -> Option<TelemetryFrame> {
+    let mut r = FrameReader { bytes: body, pos: 0 };
+    let timestamp_ns = r.u64()?;
+    let schema = schemas.get(r.u32()?)?;
+    let seq = r.u32()?;
+    let keyframe = r.take(4)?[0] != 0;
+    let resolution = if keyframe {
+        Some([r.f64()?, r.f64()?, r.f64()?])
+    } else {
+        None
+    };
+    joints.scratch.clear();
+    for _ in 0..schema.joints.len() * 3 {
+        joints.scratch.push(r.zigzag()?);
+    }
+    if !joints.apply(schema.id, seq, resolution) {
+        return None;
+    }
+    let sensor_count = r.u32()? as usize;
+    let mut payloads = Vec::with_capacity(sensor_count.min(256));
+    for _ in 0..sensor_count {
+        let (id, sensor_type) = schema.channels.get(usize::from(r.u16()?))?;
+        let len = r.u32()? as usize;
+        payloads.push(SensorPayload {
+            id: Arc::clone(id),
+            sensor_type: Arc::clone(sensor_type),
+            payload: String::from_utf8_lossy(r.take(len)?).into_owned(),
+        });
+    }
+    Some(TelemetryFrame {
+        timestamp_ns,
+        joints: delta_joints(schema, joints),
+        sensors: Vec::new(),
+        payloads,
+    })
+}
+
+/// Joint states of the frame just applied to `joints`, named from `schema`.
+pub(crate) fn delta_joints(schema: &TelemetrySchema, joints: &JointDeltaDecoder) -> Vec<JointState> {
+    let count = joints.joint_count().min(schema.joints.len());
+    (0..count)
+        .map(|i| {
+            let (position, velocity, load) = joints.joint(i);
+            let (id, name) = &schema.joints[i];
+            JointState {
+                id: Arc::clone(id),
+                name: Arc::clone(name),
+                position,
+                velocity,
+                load,
+            }
+        })
+        .collect()
+}
+
+struct FrameReader<'a> {
+    bytes: &'a [u8],
+    pos: usize,
+}
+
+impl<'a> FrameReader<'a> {
+    fn take(&mut self, n: usize) -> Option<&'a [u8]> {
+        let out = self.bytes.get(self.pos..self.pos.checked_add(n)?)?;
+        self.pos += n;
+        Some(out)
+    }
+
+    fn u16(&mut self) -> Option<u16> {
+        Some(u16::from_le_bytes(self.take(2)?.try_into().ok()?))
+    }
+
+    fn u32(&mut self) -> Option<u32> {
+        Some(u32::from_le_bytes(self.take(4)?.try_into().ok()?))
+    }
+
+    fn u64(&mut self) -> Option<u64> {
+        Some(u64::from_le_bytes(self.take(8)?.try_into().ok()?))
+    }
+
+    fn f64(&mut self) -> Option<f64> {
+        Some(f64::from_le_bytes(self.take(8)?.try_into().ok()?))
+    }
+
+    // LEB128 varint, at most 10 bytes.
+    fn varint(&mut self) -> Option<u64> {
+        let mut v = 0u64;
+        for shift in (0..70).step_by(7) {
+            let b = self.take(1)?[0];
+            v |= u64::from(b & 0x7F) << shift;
+            if b & 0x80 == 0 {
+                return Some(v);
+            }
+        }
+        None
+    }
+
+    fn zigzag(&mut self) -> Option<i64> {
+        let u = self.varint()?;
+        Some((u >> 1) as i64 ^ -((u & 1) as i64))
+    }
+
+    fn str16(&mut self) -> Option<String> {
+        let len = usize::from(self.u16()?);
+        Some(String::from_utf8_lossy(self.take(len)?).into_owned())
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn schema(id: u32, joints: usize) -> TelemetrySchema {
+        let name = |i: usize| (Arc::<str>::from(format!("j{i}")), Arc::<str>::from(format!("joint {i}")));
+        TelemetrySchema {
+            id,
+            joints: (0..joints).map(name).collect(),
+            channels: vec![(Arc::from("imu"), Arc::from("imu"))],
+        }
+    }
+
+    fn zigzag(out: &mut Vec<u8>, v: i64) {
+        let mut u = ((v << 1) ^ (v >> 63)) as u64;
+        while u >= 0x80 {
+            out.push(u as u8 | 0x80);
+            u >>= 7;
+        }
+        out.push(u as u8);
+    }
+
+    // DeltaTelemetry body as subsystems/WireProtocol.hpp packs it, with one sensor.
+    fn delta_body(schema_id: u32, seq: u32, resolution: Option<[f64; 3]>, values: &[i64]) -> Vec<u8> {
+        let mut out = Vec::new();
+        out.extend_from_slice(&1_000u64.to_le_bytes());
+        out.extend_from_slice(&schema_id.to_le_bytes());
+        out.extend_from_slice(&seq.to_le_bytes());
+        out.extend_from_slice(&[u8::from(resolution.is_some()), 0, 0, 0]);
+        for r in resolution.iter().flatten() {
+            out.extend_from_slice(&r.to_le_bytes());
+        }
+        for &v in values {
+            zigzag(&mut out, v);
+        }
+        out.extend_from_slice(&1u32.to_le_bytes());
+        out.extend_from_slice(&0u16.to_le_bytes());
+        out.extend_from_slice(&2u32.to_le_bytes());
+        out.extend_from_slice(b"ok");
+        out
+    }
+
+    #[test]
+    fn crc32c_matches_the_check_value() {
+        assert_eq!(crc32c(b"123456789", 0), 0xE306_9283);
+        // Chained over two halves equals one pass.
+        assert_eq!(crc32c(b"56789", crc32c(b"1234", 0)), 0xE306_9283);
+    }
+
+    #[test]
+    fn frames_round_trip_and_resync() {
+        let mut out = b"noise\n".to_vec();
+        encode_hello(&mut out, 3, FEATURE_INTERNED_TELEMETRY | FEATURE_DELTA_TELEMETRY);
+        let at = 6;
+        assert!(matches!(scan_frame(&out[..at], 1024), Scan::Bad));
+        assert!(matches!(scan_frame(&out[at..at + 3], 1024), Scan::NeedMore));
+        assert!(matches!(scan_frame(&out[at..out.len() - 1], 1024), Scan::NeedMore));
+        let Scan::Frame { version, kind, body, size } = scan_frame(&out[at..], 1024) else {
+            panic!("hello frame not found");
+        };
+        assert_eq!((version, kind, size), (1, FRAME_HELLO, out.len() - at));
+        assert_eq!(decode_hello(body), Some((3, FEATURE_INTERNED_TELEMETRY | FEATURE_DELTA_TELEMETRY)));
+        assert!(matches!(scan_frame(&out[at..], 2), Scan::Bad));
+    }
+
+    #[test]
+    fn corrupt_frames_are_skipped_whole() {
+        let mut out = Vec::new();
+        encode_hello(&mut out, 1, 0);
+        let size = out.len();
+        out[WIRE_HEADER_LEN] ^= 0x01;
+        assert!(matches!(scan_frame(&out, 1024), Scan::Corrupt(n) if n == size));
+        out[WIRE_HEADER_LEN] ^= 0x01;
+        out[6] = 0xFF; // flags are covered by the CRC as well
+        assert!(matches!(scan_frame(&out, 1024), Scan::Corrupt(n) if n == size));
+    }
+
+    #[test]
+    fn delta_frames_need_a_keyframe_and_no_gaps() {
+        let mut schemas = SchemaCache::default();
+        schemas.insert(schema(7, 2));
+        let mut joints = JointDeltaDecoder::default();
+        let resolution = Some([0.5, 0.25, 1.0]);
+
+        // A delta before any keyframe is refused.
+        assert!(decode_delta_telemetry(&delta_body(7, 1, None, &[1; 6]), &schemas, &mut joints).is_none());
+
+        let key = decode_delta_telemetry(&delta_body(7, 1, resolution, &[2, 4, -3, 10, -8, 0]), &schemas, &mut joints)
+            .expect("keyframe");
+        assert_eq!(key.joints.len(), 2);
+        assert_eq!(&*key.joints[1].name, "joint 1");
+        assert_eq!((key.joints[0].position, key.joints[0].velocity, key.joints[0].load), (1.0, 1.0, -3.0));
+        assert_eq!(key.payloads[0].payload, "ok");
+
+        let next = decode_delta_telemetry(&delta_body(7, 2, None, &[-2, 0, 3, 1, 8, -1]), &schemas, &mut joints)
+            .expect("delta after keyframe");
+        assert_eq!((next.joints[0].position, next.joints[0].velocity, next.joints[0].load), (0.0, 1.0, 0.0));
+        assert_eq!((next.joints[1].position, next.joints[1].velocity, next.joints[1].load), (5.5, 0.0, -1.0));
+
+        // seq 3 was lost: 4 and everything after it waits for the next keyframe.
+        assert!(decode_delta_telemetry(&delta_body(7, 4, None, &[0; 6]), &schemas, &mut joints).is_none());
+        assert!(decode_delta_telemetry(&delta_body(7, 5, None, &[0; 6]), &schemas, &mut joints).is_none());
+        assert!(decode_delta_telemetry(&delta_body(7, 6, resolution, &[0; 6]), &schemas, &mut joints).is_some());
+        assert!(decode_delta_telemetry(&delta_body(7, 7, None, &[0; 6]), &schemas, &mut joints).is_some());
+
+        // A delta against another schema, or of the wrong width, is refused too.
+        schemas.insert(schema(8, 1));
+        assert!(decode_delta_telemetry(&delta_body(8, 8, None, &[0; 3]), &schemas, &mut joints).is_none());
+        assert!(decode_delta_telemetry(&delta_body(9, 1, resolution, &[0; 3]), &schemas, &mut joints).is_none());
+    }
+}
@@ -0,0 +1,64 @@
+#include "subsystems/CommandIngress.hpp"
+
+#include <utility>
+#include <variant>
+
+#include "command/CommandRegistry.hpp"
+
+namespace arcraven::ugv {
+
+namespace {
+
+SubmitResult rejected(arcraven::ugv::RejectReason reason, const char* message) {
+    return {SubmitOutcome::Rejected, {arcraven::ugv::CommandStatus::Rejected, reason, message}};
+}
+
+} // namespace
+
+SubmitResult admit_command(CommandRouter& router, CommandEnvelope&& env) {
+    const CommandInfo* info = command_info(env.command);
+    if (!info) return rejected(arcraven::ugv::RejectReason::Unsupported, "unknown command");
+    if (static_cast<uint8_t>(env.domain) > static_cast<uint8_t>(arcraven::ugv::CommandDomain::Authority)) {
+        return rejected(arcraven::ugv::RejectReason::InvalidPayload, "bad domain");
+    }
+    if (static_cast<uint8_t>(env.priority) > static_cast<uint8_t>(arcraven::ugv::CommandPriority::Critical)) {
+        return rejected(arcraven::ugv::RejectReason::InvalidPayload, "bad priority");
+    }
+    if (static_cast<uint8_t>(env.authority) > static_cast<uint8_t>(arcraven::ugv::CommandAuthority::SafetySystem)) {
+        return rejected(arcraven::ugv::RejectReason::InvalidPayload, "bad authority");
+    }
+
+    // Domain always comes from the registry, so nothing downstream has to cross-check it.
+    env.domain = info->domain;
+    if (info->default_priority == arcraven::ugv::CommandPriority::Critical) {
+        env.priority = info->default_priority;
+    }
+
+    // Typed decode happens here so the control thread never parses text.
+    const char* error = "";
+    if (!decode_typed_payload(env.command, env.payload_json.view(), env.typed, error)) {
+        return rejected(error == kPayloadStorageExhausted ? arcraven::ugv::RejectReason::Busy
+                                                          : arcraven::ugv::RejectReason::InvalidPayload,
+                        error);
+    }
+    // Waypoints now live in their own slab block; keeping the text too would halve how many
+    // FollowPaths can be queued.
+    if (std::holds_alternative<FollowPathPayload>(env.typed)) env.payload_json.clear();
+    return router.submit(std::move(env));
+}
+
+void CreditSchedule::set_interval(std::chrono::milliseconds interval) {
+    interval_ns_ = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(interval).count());
+}
+
+bool CreditSchedule::due(const CommandCredits& credits, uint64_t now_ns) {
+    if (!requested_ && credits.backpressure == last_backpressure_ && now_ns - last_ns_ < interval_ns_) {
+        return false;
+    }
+    requested_ = false;
+    last_ns_ = now_ns;
+    last_backpressure_ = credits.backpressure;
+    return true;
+}
+
+} // namespace arcraven::ugv
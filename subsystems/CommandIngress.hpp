@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <utility>
+
+#include "command/CommandRouter.hpp"
+#include "command/CommandTypes.hpp"
+
+namespace arcraven::ugv {
+
+// Last step of every command link's rx path, once the wire format has been decoded into env
+// (rx_ns stamped). Checks the command against kCommandRegistry (Unsupported) and the enum
+// fields against their ranges (InvalidPayload), then takes the domain from the registry,
+// pins Critical-default commands to Critical, decodes the typed payload and submits.
+//
+// Returns the reject, or the router's answer. Links go through admit_and_ack, which decides
+// what is acked right away.
+SubmitResult admit_command(CommandRouter& router, CommandEnvelope&& env);
+
+// When a link advertises queue credits: every interval, and on the next pump_tx after a
+// backpressure change or request(). IO thread only.
+class CreditSchedule final {
+public:
+    void set_interval(std::chrono::milliseconds interval);
+    // Advertise on the next due() (a Busy reject, a renegotiated wire format).
+    void request() { requested_ = true; }
+    // True if credits should be advertised now; the caller then sends them.
+    bool due(const CommandCredits& credits, uint64_t now_ns);
+
+private:
+    uint64_t interval_ns_ = 250'000'000;
+    uint64_t last_ns_ = 0;
+    bool last_backpressure_ = false;
+    bool requested_ = true;
+};
+
+// admit_command for a link. A queued command is acked by the control thread once executed.
+// Anything else (reject, busy, duplicate retransmit with its cached result) is passed to
+// ack(command_id, result) right away; a Busy reject also schedules a credit advertisement so
+// the sender learns how far over it is on this tick.
+template <typename AckFn>
+void admit_and_ack(CommandRouter& router, CreditSchedule& credits, CommandEnvelope&& env, AckFn&& ack) {
+    const uint64_t command_id = env.command_id;
+    const SubmitResult submitted = admit_command(router, std::move(env));
+    if (submitted.outcome != SubmitOutcome::Queued) ack(command_id, submitted.result);
+    if (submitted.result.reject_reason == arcraven::ugv::RejectReason::Busy) credits.request();
+}
+
+} // namespace arcraven::ugv
@@ -0,0 +1,103 @@
+#include "subsystems/CommandLineParser.hpp"
+
+#include <charconv>
+#include <system_error>
+
+#include "command/CommandRegistry.hpp"
+#include "utils/Base64.hpp"
+
+namespace arcraven::ugv {
+
+namespace {
+
+// Splits off the next '|'-separated field. Returns false once the line is exhausted.
+bool next_field(std::string_view& in, std::string_view& tok) {
+    if (in.data() == nullptr) return false;
+    const size_t pos = in.find('|');
+    if (pos == std::string_view::npos) {
+        tok = in;
+        in = std::string_view{};
+        return true;
+    }
+    tok = in.substr(0, pos);
+    in.remove_prefix(pos + 1);
+    return true;
+}
+
+template <typename T>
+bool parse_uint(std::string_view tok, T& out) {
+    if (tok.empty()) return false;
+    const char* end = tok.data() + tok.size();
+    const auto r = std::from_chars(tok.data(), end, out);
+    return r.ec == std::errc{} && r.ptr == end;
+}
+
+template <typename E>
+bool parse_enum(std::string_view tok, E max, E& out) {
+    uint8_t v = 0;
+    if (!parse_uint(tok, v) || v > static_cast<uint8_t>(max)) return false;
+    out = static_cast<E>(v);
+    return true;
+}
+
+CommandLineResult invalid(arcraven::ugv::RejectReason reason, const char* error) {
+    return {CommandLineStatus::Invalid, reason, error};
+}
+
+} // namespace
+
+CommandLineResult parse_command_line(std::string_view line, CommandEnvelope& env) {
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+    if (!line.starts_with("C|")) return {CommandLineStatus::Ignored, arcraven::ugv::RejectReason::None, ""};
+    line.remove_prefix(2);
+
+    std::string_view tok;
+    if (!next_field(line, tok) || !parse_uint(tok, env.command_id)) {
+        return {CommandLineStatus::Malformed, arcraven::ugv::RejectReason::InvalidPayload, "bad command_id"};
+    }
+
+    uint16_t command = 0;
+    if (!next_field(line, tok) || !parse_uint(tok, command)) {
+        return invalid(arcraven::ugv::RejectReason::InvalidPayload, "bad command");
+    }
+    env.command = static_cast<arcraven::ugv::UgvCommand>(command);
+    if (!command_info(env.command)) {
+        return invalid(arcraven::ugv::RejectReason::Unsupported, "unknown command");
+    }
+
+    if (!next_field(line, tok) || !parse_enum(tok, arcraven::ugv::CommandDomain::Authority, env.domain)) {
+        return invalid(arcraven::ugv::RejectReason::InvalidPayload, "bad domain");
+    }
+    if (!next_field(line, tok) || !parse_enum(tok, arcraven::ugv::CommandPriority::Critical, env.priority)) {
+        return invalid(arcraven::ugv::RejectReason::InvalidPayload, "bad priority");
+    }
+    if (!next_field(line, tok) || !parse_enum(tok, arcraven::ugv::CommandAuthority::SafetySystem, env.authority)) {
+        return invalid(arcraven::ugv::RejectReason::InvalidPayload, "bad authority");
+    }
+    if (!next_field(line, tok) || !parse_uint(tok, env.issued_ns)) {
+        return invalid(arcraven::ugv::RejectReason::InvalidPayload, "bad issued_ns");
+    }
+    if (!next_field(line, tok) || !parse_uint(tok, env.ttl_ns)) {
+        return invalid(arcraven::ugv::RejectReason::InvalidPayload, "bad ttl_ns");
+    }
+
+    std::string_view payload_b64;
+    if (!next_field(line, payload_b64)) payload_b64 = {}; // "...|ttl_ns" with no payload field
+
+    // Decode straight into the envelope's inline/slab storage (no intermediate string).
+    const size_t max_len = arcraven::utils::base64_decoded_size(payload_b64);
+    char* payload = env.payload_json.prepare(max_len);
+    if (!payload) {
+        // Too large is permanent; an exhausted slab is not, so the client is told to retry.
+        return max_len > CommandPayload::kMaxSize ? invalid(arcraven::ugv::RejectReason::InvalidPayload, "payload too large")
+                                                  : invalid(arcraven::ugv::RejectReason::Busy, kPayloadStorageExhausted);
+    }
+    size_t payload_len = 0;
+    if (!arcraven::utils::base64_decode_into(payload_b64, payload, max_len, payload_len)) {
+        return invalid(arcraven::ugv::RejectReason::InvalidPayload, "payload decode failed");
+    }
+    env.payload_json.resize(payload_len);
+    return {};
+}
+
+} // namespace arcraven::ugv
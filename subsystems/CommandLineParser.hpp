@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+
+#include "command/CommandTypes.hpp"
+
+namespace arcraven::ugv {
+
+enum class CommandLineStatus : uint8_t {
+    Ok = 0,
+    Ignored = 1,   // not a "C|" record
+    Malformed = 2, // unusable before command_id was read; nothing to ack
+    Invalid = 3,   // command_id is set; ack Rejected with reason/error
+};
+
+struct CommandLineResult {
+    CommandLineStatus status = CommandLineStatus::Ok;
+    arcraven::ugv::RejectReason reason = arcraven::ugv::RejectReason::None;
+    const char* error = ""; // short static string, suitable for a CommandResult message
+};
+
+// Decodes one commands.in line straight into env:
+//   C|command_id|command|domain|priority|authority|issued_ns|ttl_ns|payload_base64
+//
+// string_view tokens + std::from_chars, no allocation and no exceptions. Every numeric field
+// must be fully consumed; enum fields are range-checked (command against kCommandRegistry,
+// Unsupported; domain/priority/authority, InvalidPayload). The payload is base64-decoded into
+// env.payload_json; the typed payload is left to the caller. Anything after the payload field
+// is ignored, for forward compatibility. env.domain is the wire value; callers that trust the
+// registry overwrite it.
+CommandLineResult parse_command_line(std::string_view line, CommandEnvelope& env);
+
+} // namespace arcraven::ugv
@@ -1,28 +1,111 @@
 #include "subsystems/Iceoryx2Bridge.hpp"
 
-#include <exception>
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
 #include <fstream>
-#include <sstream>
+#include <string>
+#include <thread>
 #include <vector>
 
+#if defined(__linux__)
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "subsystems/CommandIngress.hpp"
+#include "subsystems/CommandLineParser.hpp"
 #include "utils/Base64.hpp"
 #include "utils/Logger.hpp"
 
 namespace arcraven::ugv {
 
+namespace {
+
+constexpr const char* kCommandFile = "commands.in";
+constexpr char kFrameStart = static_cast<char>(kWireMagic & 0xFFu);
+
+void append_uint(std::string& out, uint64_t v) {
+    char buf[20];
+    const auto res = std::to_chars(buf, buf + sizeof(buf), v);
+    out.append(buf, res.ptr);
+}
+
+void append_int(std::string& out, int64_t v) {
+    char buf[21];
+    const auto res = std::to_chars(buf, buf + sizeof(buf), v);
+    out.append(buf, res.ptr);
+}
+
+// Shortest text that reads back to the same double.
+void append_double(std::string& out, double v) {
+    char buf[32];
+    const auto res = std::to_chars(buf, buf + sizeof(buf), v);
+    out.append(buf, res.ptr);
+}
+
+void append_base64(std::string& out, std::string_view bytes) {
+    const size_t at = out.size();
+    out.resize(at + arcraven::utils::base64_encoded_size(bytes.size()));
+    (void)arcraven::utils::base64_encode_into(bytes, out.data() + at);
+}
+
+} // namespace
+
 Iceoryx2Bridge::Iceoryx2Bridge() = default;
 
+Iceoryx2Bridge::~Iceoryx2Bridge() {
+    close_commands();
+#if defined(__linux__)
+    if (watch_fd_ >= 0) ::close(watch_fd_);
+    if (wake_fd_ >= 0) ::close(wake_fd_);
+#endif
+}
+
 void Iceoryx2Bridge::attach_router(CommandRouter* router) {
     router_ = router;
 }
 
+void Iceoryx2Bridge::attach_latency_stats(CommandLatencyStats* stats) {
+    latency_ = stats;
+}
+
 void Iceoryx2Bridge::configure_paths(std::filesystem::path base_dir) {
-    command_path_ = base_dir / "commands.in";
-    telemetry_path_ = base_dir / "telemetry.out";
+    command_path_ = base_dir / kCommandFile;
+    telemetry_dir_ = base_dir;
+}
+
+void Iceoryx2Bridge::configure_command_watch(bool enabled) {
+    watch_enabled_ = enabled;
+}
+
+void Iceoryx2Bridge::configure_binary_framing(bool enabled) {
+    binary_enabled_ = enabled;
+}
+
+void Iceoryx2Bridge::configure_interned_telemetry(bool enabled) {
+    interning_enabled_ = enabled;
+}
+
+void Iceoryx2Bridge::configure_joint_delta(const JointDeltaConfig& cfg) {
+    joint_delta_.configure(cfg);
+}
+
+void Iceoryx2Bridge::configure_telemetry_writer(TelemetryWriterConfig cfg) {
+    telemetry_out_.configure(cfg);
+}
+
+void Iceoryx2Bridge::configure_credit_interval(std::chrono::milliseconds interval) {
+    credits_.set_interval(interval);
 }
 
 bool Iceoryx2Bridge::init() {
-    if (command_path_.empty() || telemetry_path_.empty()) {
+    if (command_path_.empty() || telemetry_dir_.empty()) {
         ARC_LOG_ERROR("Iceoryx2Bridge: missing base paths");
         return false;
     }
@@ -37,74 +120,316 @@ bool Iceoryx2Bridge::init() {
         std::ofstream create(command_path_);
         create.close();
     }
-    if (!std::filesystem::exists(telemetry_path_)) {
-        std::ofstream create(telemetry_path_);
-        create.close();
+    rx_buf_.resize(kRxChunk + kMaxCommandLine);
+    if (!open_commands()) {
+        ARC_LOG_ERROR("Iceoryx2Bridge: cannot open command input");
+        return false;
+    }
+
+#if defined(__linux__)
+    wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (watch_enabled_) {
+        watch_fd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (watch_fd_ >= 0) {
+            file_watch_ = ::inotify_add_watch(watch_fd_, command_path_.c_str(), IN_MODIFY);
+            dir_watch_ = ::inotify_add_watch(watch_fd_, command_path_.parent_path().c_str(), IN_CREATE | IN_MOVED_TO);
+        }
+        if (watch_fd_ < 0 || file_watch_ < 0 || dir_watch_ < 0) {
+            ARC_LOG_WARN("Iceoryx2Bridge: inotify unavailable, polling commands.in");
+            if (watch_fd_ >= 0) ::close(watch_fd_);
+            watch_fd_ = -1;
+        }
+    }
+#endif
+    if (!telemetry_out_.open(telemetry_dir_)) {
+        ARC_LOG_ERROR("Iceoryx2Bridge: cannot open telemetry output");
+        return false;
     }
+    tx_batch_.reserve(16 * 1024);
+    tx_acks_.reserve(kResultQueueCapacity);
+    telemetry_scratch_.reserve(16 * 1024);
 
     initialized_.store(true, std::memory_order_release);
     ARC_LOG_INFO("Iceoryx2Bridge: init (stub)");
     return true;
 }
 
+bool Iceoryx2Bridge::open_commands() {
+    command_offset_ = 0;
+    rx_len_ = 0;
+    rx_skip_line_ = false;
+#if defined(__linux__)
+    command_fd_ = ::open(command_path_.c_str(), O_RDONLY | O_CLOEXEC);
+    return command_fd_ >= 0;
+#else
+    command_in_.open(command_path_, std::ios::binary);
+    return command_in_.good();
+#endif
+}
+
+void Iceoryx2Bridge::close_commands() {
+#if defined(__linux__)
+    if (command_fd_ >= 0) ::close(command_fd_);
+    command_fd_ = -1;
+#else
+    command_in_.close();
+#endif
+}
+
+size_t Iceoryx2Bridge::read_commands(char* dst, size_t cap) {
+#if defined(__linux__)
+    for (;;) {
+        const ssize_t n = ::read(command_fd_, dst, cap);
+        if (n > 0) return static_cast<size_t>(n);
+        if (n < 0 && errno == EINTR) continue;
+        break;
+    }
+    // Nothing new: if the file shrank below what we consumed it was truncated, so start over.
+    struct stat st {};
+    if (::fstat(command_fd_, &st) != 0) return 0;
+    if (watch_fd_ < 0 && !rx_reopen_) {
+        // Polling has no directory watch: notice a replaced commands.in by its inode.
+        struct stat path_st {};
+        if (::stat(command_path_.c_str(), &path_st) == 0 && (path_st.st_ino != st.st_ino || path_st.st_dev != st.st_dev)) {
+            rx_reopen_ = true;
+            return 0;
+        }
+    }
+    if (static_cast<uint64_t>(st.st_size) < command_offset_) {
+        ARC_LOG_WARN("Iceoryx2Bridge: commands.in truncated, reading from the start");
+        (void)::lseek(command_fd_, 0, SEEK_SET);
+        command_offset_ = 0;
+        rx_len_ = 0;
+        rx_skip_line_ = false;
+    }
+    return 0;
+#else
+    command_in_.clear();
+    command_in_.read(dst, static_cast<std::streamsize>(cap));
+    return static_cast<size_t>(command_in_.gcount());
+#endif
+}
+
 bool Iceoryx2Bridge::pump_rx() {
     if (!initialized_.load(std::memory_order_acquire)) return false;
     if (!router_) return false;
+    // With a watch, an idle tick costs nothing: no read until inotify reports a write.
+    if (!rx_ready_) return false;
+    rx_ready_ = watch_fd_ < 0 || file_watch_ < 0;
 
-    std::ifstream in(command_path_);
-    if (!in.good()) return false;
-    in.seekg(static_cast<std::streamoff>(command_offset_));
+    bool received = false;
+    for (;;) {
+        const size_t n = read_commands(rx_buf_.data() + rx_len_, kRxChunk);
+        if (n == 0) {
+            // Drain the old file completely before following a replacement.
+            if (!rx_reopen_) break;
+            close_commands();
+            if (!open_commands()) {
+                ARC_LOG_ERROR("Iceoryx2Bridge: cannot reopen command input");
+                rx_ready_ = true; // retry next tick
+                break;
+            }
+            rx_reopen_ = false;
+            continue;
+        }
+        received = true;
+        rx_len_ += n;
 
-    std::string line;
-    while (std::getline(in, line)) {
-        command_offset_ += static_cast<uint64_t>(line.size() + 1);
-        if (line.empty()) continue;
-        if (!line.empty() && line.back() == '\r') {
-            line.pop_back();
+        size_t begin = 0;
+        while (begin < rx_len_) {
+            const size_t used = consume_record(std::string_view(rx_buf_.data() + begin, rx_len_ - begin));
+            if (used == 0) break;
+            begin += used;
         }
-        if (line.rfind("C|", 0) != 0) continue;
+        command_offset_ += begin;
 
-        std::vector<std::string> parts;
-        std::stringstream ss(line);
-        std::string segment;
-        while (std::getline(ss, segment, '|')) {
-            parts.push_back(segment);
+        // Keep the incomplete tail for the next read; a record this long is not a command.
+        rx_len_ -= begin;
+        if (rx_len_ > kMaxCommandLine) {
+            ARC_LOG_WARN("Iceoryx2Bridge: command record too long, skipped");
+            command_offset_ += rx_len_;
+            rx_len_ = 0;
+            rx_skip_line_ = true;
+        } else if (begin > 0) {
+            std::memmove(rx_buf_.data(), rx_buf_.data() + begin, rx_len_);
         }
-        if (parts.size() < 9) {
-            ARC_LOG_WARN("Iceoryx2Bridge: command line malformed");
-            continue;
+        if (n < kRxChunk && !rx_reopen_) break; // short read on a regular file: caught up
+    }
+    return received;
+}
+
+// Returns the bytes taken by the record at the front of in, 0 while it is incomplete.
+size_t Iceoryx2Bridge::consume_record(std::string_view in) {
+    if (wire_frame_at(in)) {
+        WireFrame frame;
+        switch (scan_wire_frame(in, kWireMaxCommandBody, frame)) {
+        case WireScan::NeedMore:
+            return 0;
+        case WireScan::Frame:
+            handle_frame(frame);
+            return frame.size;
+        case WireScan::Corrupt:
+            ARC_LOG_WARN("Iceoryx2Bridge: command frame CRC mismatch, skipped");
+            return frame.size;
+        case WireScan::Bad:
+            break;
         }
+        // Drop the magic byte; what follows is skipped as an unknown text line up to the next
+        // newline or frame.
+        ARC_LOG_WARN("Iceoryx2Bridge: bad command frame header, resyncing");
+        return 1;
+    }
 
-        CommandEnvelope env{};
-        try {
-            env.command_id = std::stoull(parts[1]);
-            env.command = static_cast<arcraven::ugv::UgvCommand>(std::stoul(parts[2]));
-            env.domain = static_cast<arcraven::ugv::CommandDomain>(std::stoul(parts[3]));
-            env.priority = static_cast<arcraven::ugv::CommandPriority>(std::stoul(parts[4]));
-            env.authority = static_cast<arcraven::ugv::CommandAuthority>(std::stoul(parts[5]));
-            env.issued_ns = std::stoull(parts[6]);
-            env.ttl_ns = std::stoull(parts[7]);
-        } catch (const std::exception&) {
-            ARC_LOG_WARN("Iceoryx2Bridge: command parse failed");
-            continue;
+    // Text lines end at a newline, or where a frame starts right after a partial line.
+    const size_t nl = in.find('\n');
+    const size_t frame_at = in.substr(0, nl).find(kFrameStart);
+    if (nl == std::string_view::npos && frame_at == std::string_view::npos) return 0;
+    const size_t end = frame_at != std::string_view::npos ? frame_at : nl;
+    if (rx_skip_line_) {
+        rx_skip_line_ = false;
+    } else {
+        handle_command_line(in.substr(0, end));
+    }
+    return end == nl ? end + 1 : end;
+}
+
+void Iceoryx2Bridge::handle_command_line(std::string_view line) {
+    if (line.empty()) return;
+    const uint64_t rx_ns = steady_now_ns();
+    CommandEnvelope env{};
+    const CommandLineResult parsed = parse_command_line(line, env);
+    submit_command(std::move(env), parsed, rx_ns);
+}
+
+void Iceoryx2Bridge::handle_frame(const WireFrame& frame) {
+    if (frame.type == WireFrameType::Hello) {
+        uint8_t version = 0;
+        uint16_t features = 0;
+        if (!decode_hello_frame(frame.body, version, features)) return;
+        if (!binary_enabled_) {
+            ARC_LOG_INFO("Iceoryx2Bridge: client hello ignored, telemetry stays text");
+            return;
         }
+        const uint8_t agreed = std::min(version, kWireVersion);
+        uint16_t agreed_features = interning_enabled_ ? features & kWireFeatureInternedTelemetry : 0;
+        if (agreed_features != 0 && joint_delta_.config().enabled) agreed_features |= features & kWireFeatureDeltaTelemetry;
+        append_hello_frame(tx_batch_, agreed, agreed_features);
+        // Features first: the sensor thread reads them after seeing the version.
+        tx_features_.store(agreed_features, std::memory_order_release);
+        tx_version_.store(agreed, std::memory_order_release);
+        credits_.request(); // re-advertise in the agreed format
+        ARC_LOG_INFO("Iceoryx2Bridge: client hello, wire version " + std::to_string(agreed) + ", features " +
+                     std::to_string(agreed_features));
+        return;
+    }
+    if (frame.type != WireFrameType::Command || frame.version != kWireVersion) {
+        ARC_LOG_WARN("Iceoryx2Bridge: unsupported frame type " + std::to_string(static_cast<unsigned>(frame.type)) +
+                     " version " + std::to_string(frame.version) + ", skipped");
+        return;
+    }
+    const uint64_t rx_ns = steady_now_ns();
+    CommandEnvelope env{};
+    const CommandLineResult decoded = decode_command_frame(frame.body, env);
+    submit_command(std::move(env), decoded, rx_ns);
+}
 
-        bool ok = false;
-        env.payload_json = arcraven::utils::base64_decode(parts[8], ok);
-        if (!ok) {
-            ARC_LOG_WARN("Iceoryx2Bridge: payload decode failed");
+void Iceoryx2Bridge::submit_command(CommandEnvelope&& env, const CommandLineResult& decoded, uint64_t rx_ns) {
+    // Immediate answers go straight into this tick's tx batch (pump_tx runs right after).
+    if (decoded.status == CommandLineStatus::Ignored) return;
+    if (decoded.status == CommandLineStatus::Malformed) {
+        ARC_LOG_WARN("Iceoryx2Bridge: command record malformed");
+        return;
+    }
+    if (decoded.status == CommandLineStatus::Invalid) {
+        append_result(env.command_id, arcraven::ugv::CommandStatus::Rejected, decoded.reason, decoded.error);
+        return;
+    }
+
+    env.stamps.rx_ns = rx_ns;
+    admit_and_ack(*router_, credits_, std::move(env), [this](uint64_t command_id, const CommandResult& result) {
+        append_result(command_id, result.status, result.reject_reason, result.message);
+    });
+}
+
+void Iceoryx2Bridge::wait_until(std::chrono::steady_clock::time_point deadline) {
+#if defined(__linux__)
+    if (watch_fd_ >= 0) {
+        const auto left = deadline - std::chrono::steady_clock::now();
+        if (left <= std::chrono::steady_clock::duration::zero()) return;
+        const auto left_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(left).count();
+        const timespec timeout{static_cast<time_t>(left_ns / 1'000'000'000), static_cast<long>(left_ns % 1'000'000'000)};
+        pollfd fds[2] = {{watch_fd_, POLLIN, 0}, {wake_fd_, POLLIN, 0}};
+        if (::ppoll(fds, wake_fd_ >= 0 ? 2 : 1, &timeout, nullptr) <= 0) return;
+        if (fds[0].revents & POLLIN) drain_watch_events();
+        if (wake_fd_ >= 0 && (fds[1].revents & POLLIN)) {
+            uint64_t count = 0;
+            (void)!::read(wake_fd_, &count, sizeof(count));
         }
+        return;
+    }
+#endif
+    std::this_thread::sleep_until(deadline);
+}
 
-        (void)router_->submit(std::move(env));
+void Iceoryx2Bridge::wake() {
+#if defined(__linux__)
+    if (wake_fd_ >= 0) {
+        const uint64_t one = 1;
+        (void)!::write(wake_fd_, &one, sizeof(one));
+    }
+#endif
+}
+
+void Iceoryx2Bridge::drain_watch_events() {
+#if defined(__linux__)
+    alignas(inotify_event) char buf[4096];
+    for (;;) {
+        const ssize_t n = ::read(watch_fd_, buf, sizeof(buf));
+        if (n <= 0) break;
+        for (ssize_t off = 0; off < n;) {
+            const auto* ev = reinterpret_cast<const inotify_event*>(buf + off);
+            off += static_cast<ssize_t>(sizeof(inotify_event) + ev->len);
+            if (ev->wd == file_watch_ || (ev->mask & IN_Q_OVERFLOW)) {
+                rx_ready_ = true;
+            } else if (ev->wd == dir_watch_ && ev->len > 0 && std::strcmp(ev->name, kCommandFile) == 0) {
+                // commands.in was recreated or renamed over: follow the new file.
+                (void)::inotify_rm_watch(watch_fd_, file_watch_);
+                file_watch_ = ::inotify_add_watch(watch_fd_, command_path_.c_str(), IN_MODIFY);
+                rx_reopen_ = true;
+                rx_ready_ = true;
+            }
+        }
     }
-    return false;
+#endif
 }
 
 bool Iceoryx2Bridge::pump_tx() {
     if (!initialized_.load(std::memory_order_acquire)) return false;
 
-    // TODO: publish command acks over Iceoryx2.
-    return false;
+    // Everything the control thread produced since the last tick, in order.
+    while (const PendingResult* r = results_.front()) {
+        append_result(r->command_id, r->status, r->reject_reason, std::string_view(r->message.data(), r->message_size));
+        if (latency_ && r->ack.command != arcraven::ugv::UgvCommand{}) tx_acks_.push_back(r->ack);
+        results_.pop();
+    }
+
+    if (router_) {
+        const CommandCredits credits = router_->credits();
+        if (credits_.due(credits, steady_now_ns())) (void)publish_credits(credits);
+    }
+    return flush_tx();
+}
+
+bool Iceoryx2Bridge::flush_tx() {
+    const bool wrote = !tx_batch_.empty();
+    const bool ok = telemetry_out_.flush(tx_batch_);
+    tx_batch_.clear();
+    if (ok && !tx_acks_.empty()) {
+        const uint64_t written_ns = steady_now_ns();
+        for (const AckTiming& ack : tx_acks_) latency_->record_ack(ack, written_ns);
+    }
+    tx_acks_.clear();
+    return ok && wrote;
 }
 
 bool Iceoryx2Bridge::publish_sensor_frame(const SensorFrame& frame) {
@@ -114,36 +439,230 @@ bool Iceoryx2Bridge::publish_sensor_frame(const SensorFrame& frame) {
 bool Iceoryx2Bridge::publish_telemetry(const SensorFrame& frame, const std::vector<JointState>& joints) {
     if (!initialized_.load(std::memory_order_acquire)) return false;
 
-    std::ofstream out(telemetry_path_, std::ios::app);
-    if (!out.good()) return false;
+    // Encoded into a reused buffer: no allocation once it has grown to the usual frame size.
+    std::string& out = telemetry_scratch_;
+    out.clear();
+    const bool binary = tx_version_.load(std::memory_order_acquire) != 0;
+    const bool interned =
+        interning_enabled_ && (!binary || (tx_features_.load(std::memory_order_acquire) & kWireFeatureInternedTelemetry) != 0);
+    if (interned) {
+        const bool delta = joint_delta_.config().enabled &&
+                           (!binary || (tx_features_.load(std::memory_order_acquire) & kWireFeatureDeltaTelemetry) != 0);
+        return publish_interned(frame, joints, binary, delta);
+    }
+    if (preamble_mode_ != SchemaMode::None) {
+        telemetry_out_.set_preamble({});
+        preamble_mode_ = SchemaMode::None;
+    }
+    if (binary) {
+        if (!append_telemetry_frame(out, frame, joints)) return false;
+        return telemetry_out_.push(out, frame.timestamp_ns);
+    }
 
-    out << "T|" << frame.timestamp_ns << "|" << joints.size();
+    out += "T|";
+    append_uint(out, frame.timestamp_ns);
+    out += '|';
+    append_uint(out, joints.size());
     for (const auto& joint : joints) {
-        out << "|" << joint.id << "|" << joint.name << "|" << joint.position << "|" << joint.velocity << "|" << joint.load;
+        out += '|';
+        out += joint.id;
+        out += '|';
+        out += joint.name;
+        out += '|';
+        append_double(out, joint.position);
+        out += '|';
+        append_double(out, joint.velocity);
+        out += '|';
+        append_double(out, joint.load);
     }
-    const size_t sensor_count = std::min(frame.ids.size(), std::min(frame.types.size(), frame.payloads.size()));
-    out << "|" << sensor_count;
+    const size_t sensor_count = telemetry_sensor_count(frame);
+    out += '|';
+    append_uint(out, sensor_count);
     for (size_t i = 0; i < sensor_count; ++i) {
-        const auto payload = arcraven::utils::base64_encode(frame.payloads[i]);
-        out << "|" << frame.ids[i] << "|" << frame.types[i] << "|" << payload;
+        out += '|';
+        out += frame.ids[i];
+        out += '|';
+        out += frame.types[i];
+        out += '|';
+        append_base64(out, frame.payloads[i]);
     }
-    out << "\n";
-    return true;
+    out += '\n';
+    return telemetry_out_.push(out, frame.timestamp_ns);
 }
 
-bool Iceoryx2Bridge::publish_command_result(uint64_t command_id, const CommandResult& result) {
+bool Iceoryx2Bridge::publish_interned(const SensorFrame& frame, const std::vector<JointState>& joints, bool binary,
+                                      bool delta) {
+    std::string& out = telemetry_scratch_;
+    const SchemaMode mode = binary ? SchemaMode::Binary : SchemaMode::Text;
+    const bool changed = schema_.update(frame, joints, channels_);
+    if (changed || mode != preamble_mode_) {
+        // The schema heads every segment from here on; the writer starts a new one for it.
+        if (binary) {
+            if (!append_schema_frame(out, schema_)) {
+                preamble_mode_ = SchemaMode::None; // retried with the next frame
+                return false;
+            }
+        } else {
+            append_schema_line(out);
+        }
+        telemetry_out_.set_preamble(out);
+        preamble_mode_ = mode;
+        out.clear();
+        joint_delta_.reset();
+        ARC_LOG_INFO("Iceoryx2Bridge: telemetry schema " + std::to_string(schema_.id()) + ", " +
+                     std::to_string(schema_.joints().size()) + " joints, " + std::to_string(schema_.channels().size()) +
+                     " channels");
+    }
+
+    if (delta) {
+        if (joint_delta_.prepare(joints, schema_.id())) return publish_delta(frame, binary);
+        // Not quantizable: this frame goes out whole and the next delta frame is a keyframe.
+    } else {
+        joint_delta_.reset();
+    }
+
+    if (binary) {
+        if (!append_interned_telemetry_frame(out, schema_.id(), frame, joints, channels_)) return false;
+        return telemetry_out_.push(out, frame.timestamp_ns);
+    }
+
+    out += "I|";
+    append_uint(out, schema_.id());
+    out += '|';
+    append_uint(out, frame.timestamp_ns);
+    for (const auto& joint : joints) {
+        out += '|';
+        append_double(out, joint.position);
+        out += '|';
+        append_double(out, joint.velocity);
+        out += '|';
+        append_double(out, joint.load);
+    }
+    append_channel_payloads(out, frame);
+    return telemetry_out_.push(out, frame.timestamp_ns);
+}
+
+bool Iceoryx2Bridge::publish_delta(const SensorFrame& frame, bool binary) {
+    std::string& out = telemetry_scratch_;
+    if (binary) {
+        if (!append_delta_telemetry_frame(out, schema_.id(), joint_delta_, frame, channels_)) {
+            joint_delta_.commit(false);
+            return false;
+        }
+    } else {
+        out += joint_delta_.keyframe() ? "K|" : "D|";
+        append_uint(out, schema_.id());
+        out += '|';
+        append_uint(out, joint_delta_.seq());
+        out += '|';
+        append_uint(out, frame.timestamp_ns);
+        if (joint_delta_.keyframe()) {
+            const JointDeltaConfig& cfg = joint_delta_.config();
+            for (const double resolution : {cfg.position_resolution, cfg.velocity_resolution, cfg.load_resolution}) {
+                out += '|';
+                append_double(out, resolution);
+            }
+        }
+        for (const int64_t v : joint_delta_.values()) {
+            out += '|';
+            append_int(out, v);
+        }
+        append_channel_payloads(out, frame);
+    }
+    // Only keyframes are indexed, so a reader seeking by timestamp lands on one.
+    const bool pushed = telemetry_out_.push(out, joint_delta_.keyframe() ? frame.timestamp_ns : 0);
+    joint_delta_.commit(pushed);
+    return pushed;
+}
+
+void Iceoryx2Bridge::append_channel_payloads(std::string& out, const SensorFrame& frame) const {
+    out += '|';
+    append_uint(out, channels_.size());
+    for (size_t i = 0; i < channels_.size(); ++i) {
+        out += '|';
+        append_uint(out, channels_[i]);
+        out += '|';
+        append_base64(out, frame.payloads[i]);
+    }
+    out += '\n';
+}
+
+void Iceoryx2Bridge::append_schema_line(std::string& out) const {
+    out += "S|";
+    append_uint(out, schema_.id());
+    out += '|';
+    append_uint(out, schema_.joints().size());
+    for (const auto& joint : schema_.joints()) {
+        out += '|';
+        out += joint.id;
+        out += '|';
+        out += joint.name;
+    }
+    out += '|';
+    append_uint(out, schema_.channels().size());
+    for (const auto& channel : schema_.channels()) {
+        out += '|';
+        out += channel.id;
+        out += '|';
+        out += channel.type;
+    }
+    out += '\n';
+}
+
+bool Iceoryx2Bridge::publish_command_result(uint64_t command_id, const CommandResult& result, const AckTiming& ack) {
     if (!initialized_.load(std::memory_order_acquire)) return false;
 
-    std::ofstream out(telemetry_path_, std::ios::app);
-    if (!out.good()) return false;
+    PendingResult* slot = results_.claim();
+    if (!slot) {
+        results_dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    const size_t n = std::min(result.message.size(), kMaxResultMessage);
+    slot->command_id = command_id;
+    slot->status = result.status;
+    slot->reject_reason = result.reject_reason;
+    slot->message_size = static_cast<uint8_t>(n);
+    std::memcpy(slot->message.data(), result.message.data(), n);
+    slot->ack = ack;
+    results_.publish();
+    return true;
+}
 
-    std::string message = result.message;
-    for (auto& c : message) {
-        if (c == '|') c = '/';
+void Iceoryx2Bridge::append_result(uint64_t command_id, arcraven::ugv::CommandStatus status,
+                                   arcraven::ugv::RejectReason reason, std::string_view message) {
+    if (tx_version_.load(std::memory_order_relaxed) != 0) {
+        append_result_frame(tx_batch_, command_id, status, reason, message.substr(0, kMaxResultMessage));
+        return;
     }
+    tx_batch_ += "R|";
+    append_uint(tx_batch_, command_id);
+    tx_batch_ += '|';
+    append_uint(tx_batch_, static_cast<uint64_t>(status));
+    tx_batch_ += '|';
+    append_uint(tx_batch_, static_cast<uint64_t>(reason));
+    tx_batch_ += '|';
+    const size_t start = tx_batch_.size();
+    tx_batch_ += message.substr(0, kMaxResultMessage);
+    std::replace(tx_batch_.begin() + static_cast<std::ptrdiff_t>(start), tx_batch_.end(), '|', '/');
+    tx_batch_ += '\n';
+}
 
-    out << "R|" << command_id << "|" << static_cast<int>(result.status) << "|"
-        << static_cast<int>(result.reject_reason) << "|" << message << "\n";
+bool Iceoryx2Bridge::publish_credits(const CommandCredits& credits) {
+    if (!initialized_.load(std::memory_order_acquire)) return false;
+
+    if (tx_version_.load(std::memory_order_relaxed) != 0) {
+        append_credit_frame(tx_batch_, steady_now_ns(), credits);
+        return true;
+    }
+    tx_batch_ += "F|";
+    append_uint(tx_batch_, steady_now_ns());
+    tx_batch_ += '|';
+    append_uint(tx_batch_, credits.credits);
+    tx_batch_ += '|';
+    append_uint(tx_batch_, credits.queued);
+    tx_batch_ += '|';
+    append_uint(tx_batch_, credits.capacity);
+    tx_batch_ += credits.backpressure ? "|1\n" : "|0\n";
     return true;
 }
 
@@ -1,37 +1,165 @@
 #pragma once
 
+#include <array>
 #include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <filesystem>
+#include <fstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "command/CommandRouter.hpp"
 #include "command/CommandTypes.hpp"
+#include "core/SpscRing.hpp"
+#include "subsystems/CommandIngress.hpp"
+#include "subsystems/CommandLineParser.hpp"
 #include "subsystems/Interfaces.hpp"
+#include "subsystems/TelemetrySchema.hpp"
+#include "subsystems/TelemetryWriter.hpp"
+#include "subsystems/WireProtocol.hpp"
 
 namespace arcraven::ugv {
 
 class Iceoryx2Bridge final : public ICommandLink {
 public:
     Iceoryx2Bridge();
+    ~Iceoryx2Bridge() override;
 
     void attach_router(CommandRouter* router);
+    // Publish/Total ack latency, recorded once pump_tx has written the ack. Before init().
+    void attach_latency_stats(CommandLatencyStats* stats);
     void configure_paths(std::filesystem::path base_dir);
+    // Watch commands.in for writes (inotify) instead of reading it on every tick. Falls back to
+    // polling when off, when inotify is unavailable, or on non-Linux builds. Before init().
+    void configure_command_watch(bool enabled);
+    // Answer a client's Hello frame by switching telemetry output to binary frames
+    // (WireProtocol.hpp). Off keeps it text for reading by eye; commands.in takes both either way.
+    void configure_binary_framing(bool enabled);
+    // Announce joint and sensor identity once in a schema record and send frames with joint
+    // values in schema order and numeric sensor channels (S| / I| lines, or Schema /
+    // InternedTelemetry frames for clients that ask for them). Off sends full T| lines and
+    // Telemetry frames.
+    void configure_interned_telemetry(bool enabled);
+    // On top of interned telemetry: joint values as periodic keyframes and quantized deltas
+    // between them (K| / D| lines, or DeltaTelemetry frames for clients that ask for them).
+    // Before init().
+    void configure_joint_delta(const JointDeltaConfig& cfg);
+    // Buffering, durability, segment rollover and retention of the telemetry segments
+    // (telemetry.<seq>.out). Before init().
+    void configure_telemetry_writer(TelemetryWriterConfig cfg);
+    // How often pump_tx advertises queue credits (always sooner on a backpressure change or a
+    // Busy reject).
+    void configure_credit_interval(std::chrono::milliseconds interval);
 
     bool init() override;
     bool pump_rx() override;
     bool pump_tx() override;
 
+    // IO thread: sleeps until deadline, returning early when commands.in is written or wake() is
+    // called. Without a watch this is a plain sleep and pump_rx reads on every tick.
+    void wait_until(std::chrono::steady_clock::time_point deadline) override;
+    void wake() override;
+
     bool publish_sensor_frame(const SensorFrame& frame);
-    bool publish_telemetry(const SensorFrame& frame, const std::vector<JointState>& joints);
-    bool publish_command_result(uint64_t command_id, const CommandResult& result);
+    // Sensor thread only (single producer): encodes the frame into the telemetry buffer; the
+    // next pump_tx writes it. False when the buffer is full (counted in telemetry_dropped()).
+    bool publish_telemetry(const SensorFrame& frame, const std::vector<JointState>& joints) override;
+    // Control thread only (single producer): queues the ack for the next pump_tx and returns.
+    // Never touches the file; false when the queue is full (counted in results_dropped()).
+    bool publish_command_result(uint64_t command_id, const CommandResult& result, const AckTiming& ack) override;
+    // IO thread: adds a credit record to the pending tx batch.
+    bool publish_credits(const CommandCredits& credits);
+
+    uint64_t results_dropped() const override { return results_dropped_.load(std::memory_order_relaxed); }
+    uint64_t telemetry_dropped() const override { return telemetry_out_.dropped(); }
 
 private:
+    static constexpr size_t kResultQueueCapacity = 1024;
+    static constexpr size_t kMaxResultMessage = 119;
+    static constexpr size_t kRxChunk = 64 * 1024;
+    // Longest command record kept while waiting for the rest of it (4096-byte payload as a
+    // base64 line or a frame).
+    static constexpr size_t kMaxCommandLine = 8 * 1024;
+
+    // Fixed-size so the control thread never allocates to hand a result over.
+    struct PendingResult {
+        uint64_t command_id = 0;
+        arcraven::ugv::CommandStatus status = arcraven::ugv::CommandStatus::None;
+        arcraven::ugv::RejectReason reject_reason = arcraven::ugv::RejectReason::None;
+        uint8_t message_size = 0;
+        std::array<char, kMaxResultMessage> message{};
+        AckTiming ack;
+    };
+
+    // IO thread only.
+    bool open_commands();
+    void close_commands();
+    size_t read_commands(char* dst, size_t cap);
+    void drain_watch_events();
+    size_t consume_record(std::string_view in);
+    void handle_command_line(std::string_view line);
+    void handle_frame(const WireFrame& frame);
+    void submit_command(CommandEnvelope&& env, const CommandLineResult& decoded, uint64_t rx_ns);
+    void append_result(uint64_t command_id, arcraven::ugv::CommandStatus status,
+                       arcraven::ugv::RejectReason reason, std::string_view message);
+    bool flush_tx();
+    // Sensor thread only.
+    bool publish_interned(const SensorFrame& frame, const std::vector<JointState>& joints, bool binary, bool delta);
+    bool publish_delta(const SensorFrame& frame, bool binary);
+    void append_schema_line(std::string& out) const;
+    void append_channel_payloads(std::string& out, const SensorFrame& frame) const;
+
     std::filesystem::path command_path_;
-    std::filesystem::path telemetry_path_;
+    std::filesystem::path telemetry_dir_;
     uint64_t command_offset_ = 0;
 
+    // commands.in stays open; rx_buf_ holds what was read past the last complete line.
+    int command_fd_ = -1;
+    std::ifstream command_in_; // non-Linux builds
+    std::vector<char> rx_buf_;
+    size_t rx_len_ = 0;
+    bool rx_skip_line_ = false;
+
+    // Wire version and features agreed through Hello; version 0 = text. Set by the IO thread,
+    // read by the sensor thread.
+    bool binary_enabled_ = true;
+    bool interning_enabled_ = true;
+    std::atomic<uint8_t> tx_version_{0};
+    std::atomic<uint16_t> tx_features_{0};
+
+    // inotify on commands.in (writes) and its directory (replacement), eventfd for wake().
+    bool watch_enabled_ = true;
+    int watch_fd_ = -1;
+    int file_watch_ = -1;
+    int dir_watch_ = -1;
+    int wake_fd_ = -1;
+    bool rx_ready_ = true;   // data may be waiting (always true while polling)
+    bool rx_reopen_ = false; // commands.in was replaced
+
+    CreditSchedule credits_;
+
+    // Results: control thread -> IO thread. Each pump_tx writes tx_batch_ and the telemetry
+    // buffered since the last tick to the current telemetry segment in one writev.
+    SpscRing<PendingResult> results_{kResultQueueCapacity};
+    std::atomic<uint64_t> results_dropped_{0};
+    std::string tx_batch_;
+    std::vector<AckTiming> tx_acks_; // timed acks in tx_batch_
+    TelemetryWriter telemetry_out_;
+    std::string telemetry_scratch_; // sensor thread only
+
+    // Interned telemetry (sensor thread only): the schema, the channel of each sensor of the
+    // frame being encoded, how the writer's current preamble is encoded, and the joint
+    // keyframe/delta state.
+    enum class SchemaMode : uint8_t { None, Text, Binary };
+    TelemetrySchema schema_;
+    std::vector<uint16_t> channels_;
+    SchemaMode preamble_mode_ = SchemaMode::None;
+    JointDeltaEncoder joint_delta_;
+
     CommandRouter* router_ = nullptr;
+    CommandLatencyStats* latency_ = nullptr;
     std::atomic<bool> initialized_{false};
 };
 
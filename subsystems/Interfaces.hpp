@@ -1,9 +1,14 @@
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include "command/CommandLatency.hpp"
+#include "command/CommandTypes.hpp"
+
 namespace arcraven::ugv {
 
 struct SensorFrame {
@@ -45,6 +50,23 @@ public:
     virtual bool init() = 0;
     virtual bool pump_rx() = 0; // non-blocking; should enqueue into CommandRouter
     virtual bool pump_tx() = 0;
+
+    // IO thread: sleep until deadline; links that can tell when commands arrive return early.
+    virtual void wait_until(std::chrono::steady_clock::time_point deadline) {
+        std::this_thread::sleep_until(deadline);
+    }
+    // Any thread: interrupts wait_until (used on shutdown).
+    virtual void wake() {}
+
+    // Control thread: hand over a command result; never blocks. A link given latency stats
+    // records ack (unless default) when the result is actually written.
+    virtual bool publish_command_result(uint64_t command_id, const CommandResult& result, const AckTiming& ack) = 0;
+    // Sensor thread.
+    virtual bool publish_telemetry(const SensorFrame& frame, const std::vector<JointState>& joints) = 0;
+    // Results lost because the link's tx queue was full.
+    virtual uint64_t results_dropped() const { return 0; }
+    // Telemetry frames lost because the link had no room for them.
+    virtual uint64_t telemetry_dropped() const { return 0; }
 };
 
 } // namespace arcraven::ugv
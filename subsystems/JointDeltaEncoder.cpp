@@ -0,0 +1,56 @@
+#include "subsystems/JointDeltaEncoder.hpp"
+
+#include <cmath>
+
+namespace arcraven::ugv {
+
+namespace {
+
+// Beyond 2^53 steps a double no longer holds every integer, and deltas could overflow.
+constexpr double kMaxSteps = 9007199254740992.0;
+
+bool quantize(double value, double resolution, int64_t& q) {
+    const double steps = value / resolution;
+    if (!std::isfinite(steps) || std::fabs(steps) > kMaxSteps) return false;
+    q = std::llround(steps);
+    return true;
+}
+
+} // namespace
+
+void JointDeltaEncoder::configure(const JointDeltaConfig& cfg) {
+    cfg_ = cfg;
+    reset();
+}
+
+bool JointDeltaEncoder::prepare(const std::vector<JointState>& joints, uint32_t schema_id) {
+    current_.resize(joints.size() * 3);
+    for (size_t i = 0; i < joints.size(); ++i) {
+        if (!quantize(joints[i].position, cfg_.position_resolution, current_[3 * i]) ||
+            !quantize(joints[i].velocity, cfg_.velocity_resolution, current_[3 * i + 1]) ||
+            !quantize(joints[i].load, cfg_.load_resolution, current_[3 * i + 2])) {
+            reset();
+            return false;
+        }
+    }
+
+    keyframe_ = !have_previous_ || schema_id != schema_id_ || previous_.size() != current_.size() ||
+                since_keyframe_ + 1 >= cfg_.keyframe_interval;
+    schema_id_ = schema_id;
+    ++seq_;
+    values_.resize(current_.size());
+    for (size_t i = 0; i < current_.size(); ++i) values_[i] = keyframe_ ? current_[i] : current_[i] - previous_[i];
+    return true;
+}
+
+void JointDeltaEncoder::commit(bool delivered) {
+    if (!delivered) {
+        reset();
+        return;
+    }
+    previous_.swap(current_);
+    have_previous_ = true;
+    since_keyframe_ = keyframe_ ? 0 : since_keyframe_ + 1;
+}
+
+} // namespace arcraven::ugv
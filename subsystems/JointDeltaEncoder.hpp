@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "subsystems/Interfaces.hpp"
+
+namespace arcraven::ugv {
+
+struct JointDeltaConfig {
+    bool enabled = false;
+    // A keyframe at least every keyframe_interval frames (and after any gap); deltas between.
+    uint32_t keyframe_interval = 100;
+    // Quantization step per field. A client reconstructs q * resolution, within resolution / 2
+    // of the value sent.
+    double position_resolution = 1e-6; // rad or m
+    double velocity_resolution = 1e-5; // rad/s or m/s
+    double load_resolution = 1e-3;     // drive units (A, Nm)
+};
+
+// Joint values as quantized integers: absolute in a keyframe, the change since the previous frame
+// in a delta frame, joint-major (position, velocity, load).
+//
+// Deltas are taken against the previously *sent* quantized values, which are exactly what the
+// client holds, so reconstruction never drifts: after any number of deltas the client's
+// integers equal the encoder's. Frames are numbered; a client that misses one (dropped, skipped
+// on a seek) waits for the next keyframe. A frame that was not delivered must be reported to
+// commit() so the next one is a keyframe.
+class JointDeltaEncoder final {
+public:
+    void configure(const JointDeltaConfig& cfg);
+    const JointDeltaConfig& config() const { return cfg_; }
+
+    // Quantizes joints and picks keyframe or delta. False if a value cannot be quantized
+    // (non-finite, or too large for the resolution): send that frame some other way; the next
+    // one is a keyframe.
+    bool prepare(const std::vector<JointState>& joints, uint32_t schema_id);
+    bool keyframe() const { return keyframe_; }
+    uint32_t seq() const { return seq_; }
+    const std::vector<int64_t>& values() const { return values_; }
+
+    // After prepare(): whether the frame reached the stream.
+    void commit(bool delivered);
+    // Next frame is a keyframe.
+    void reset() { have_previous_ = false; }
+
+private:
+    JointDeltaConfig cfg_;
+    std::vector<int64_t> previous_;
+    std::vector<int64_t> current_;
+    std::vector<int64_t> values_;
+    uint32_t schema_id_ = 0;
+    uint32_t seq_ = 0;
+    uint32_t since_keyframe_ = 0;
+    bool have_previous_ = false;
+    bool keyframe_ = true;
+};
+
+} // namespace arcraven::ugv
@@ -0,0 +1,346 @@
+#include "subsystems/ShmCommandLink.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <utility>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "subsystems/CommandIngress.hpp"
+#include "subsystems/WireProtocol.hpp"
+#include "utils/Logger.hpp"
+
+namespace arcraven::ugv {
+
+namespace {
+
+constexpr size_t kPage = 4096;
+
+constexpr size_t align_up(size_t v, size_t a) {
+    return (v + a - 1) & ~(a - 1);
+}
+
+uint32_t round_up_pow2(uint32_t v) {
+    uint32_t cap = 1;
+    while (cap < v) cap <<= 1u;
+    return cap;
+}
+
+// One ring of the mapping. Producer side: claim() / publish(); consumer side: front() / pop().
+// Only the client's counterpart (tail, or a slot's seq) is read from the mapping, and a bogus
+// value there can at worst make a ring look full or empty: every slot address is the core's own
+// position masked with its own geometry.
+class Ring {
+public:
+    explicit Ring(ShmRingState& r) : r_(r) {}
+
+    // Record area of the next free slot, or nullptr when the consumer is a full ring behind.
+    uint8_t* claim() const {
+        if (r_.position - r_.shared->tail.load(std::memory_order_acquire) > r_.mask) return nullptr;
+        return reinterpret_cast<uint8_t*>(slot(r_.position) + 1);
+    }
+    void publish(uint32_t size) const {
+        ShmSlotHeader* s = slot(r_.position);
+        s->size = size;
+        ++r_.position;
+        s->seq.store(r_.position, std::memory_order_release);
+        r_.shared->head.store(r_.position, std::memory_order_release);
+    }
+
+    const ShmSlotHeader* front() const {
+        const ShmSlotHeader* s = slot(r_.position);
+        return s->seq.load(std::memory_order_acquire) == r_.position + 1 ? s : nullptr;
+    }
+    void pop() const { r_.shared->tail.store(++r_.position, std::memory_order_release); }
+
+    uint32_t record_capacity() const { return r_.slot_size - static_cast<uint32_t>(sizeof(ShmSlotHeader)); }
+
+private:
+    ShmSlotHeader* slot(uint64_t pos) const {
+        return reinterpret_cast<ShmSlotHeader*>(r_.base + (pos & r_.mask) * r_.slot_size);
+    }
+
+    ShmRingState& r_;
+};
+
+#if defined(__linux__)
+long futex(std::atomic<uint32_t>& word, int op, uint32_t value, const timespec* timeout) {
+    // Shared (not FUTEX_PRIVATE): the other side is another process.
+    return ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), op, value, timeout, nullptr, 0);
+}
+#endif
+
+void ring_doorbell(ShmDoorbell& bell) {
+    bell.seq.fetch_add(1, std::memory_order_seq_cst);
+#if defined(__linux__)
+    if (bell.waiters.load(std::memory_order_seq_cst) != 0) (void)futex(bell.seq, FUTEX_WAKE, INT_MAX, nullptr);
+#endif
+}
+
+void fill_result(ShmResultRecord& rec, uint64_t command_id, arcraven::ugv::CommandStatus status,
+                 arcraven::ugv::RejectReason reason, std::string_view message) {
+    rec.kind = static_cast<uint8_t>(ShmRecordKind::Result);
+    rec.command_id = command_id;
+    rec.status = static_cast<uint8_t>(status);
+    rec.reject_reason = static_cast<uint8_t>(reason);
+    const size_t n = std::min(message.size(), kShmMaxMessage);
+    rec.message_size = static_cast<uint8_t>(n);
+    std::memcpy(rec.message, message.data(), n);
+}
+
+} // namespace
+
+ShmCommandLink::~ShmCommandLink() {
+    unmap();
+}
+
+void ShmCommandLink::attach_router(CommandRouter* router) {
+    router_ = router;
+}
+
+void ShmCommandLink::attach_latency_stats(CommandLatencyStats* stats) {
+    latency_ = stats;
+}
+
+void ShmCommandLink::configure(ShmLinkConfig cfg) {
+    cfg_ = std::move(cfg);
+}
+
+void ShmCommandLink::configure_credit_interval(std::chrono::milliseconds interval) {
+    credits_.set_interval(interval);
+}
+
+bool ShmCommandLink::init() {
+#if defined(__linux__)
+    if (cfg_.name.empty() || cfg_.name.find('/') != std::string::npos) {
+        ARC_LOG_ERROR("ShmCommandLink: invalid segment name");
+        return false;
+    }
+    const std::string shm_name = "/" + cfg_.name;
+
+    struct RingSpec {
+        ShmRingHeader ShmSegmentHeader::*ring;
+        ShmRingState* state;
+        uint32_t slots;
+        size_t slot_size;
+    };
+    const RingSpec rings[] = {
+        {&ShmSegmentHeader::commands, &commands_, cfg_.command_slots, sizeof(ShmSlotHeader) + sizeof(ShmCommandRecord)},
+        {&ShmSegmentHeader::results, &results_, cfg_.result_slots, sizeof(ShmSlotHeader) + sizeof(ShmResultRecord)},
+        {&ShmSegmentHeader::events, &events_, cfg_.event_slots, sizeof(ShmSlotHeader) + sizeof(ShmResultRecord)},
+        {&ShmSegmentHeader::telemetry, &telemetry_, cfg_.telemetry_slots,
+         std::max<size_t>(cfg_.telemetry_slot_bytes, sizeof(ShmSlotHeader) + 64)},
+    };
+    size_t total = align_up(sizeof(ShmSegmentHeader), kPage);
+    for (const RingSpec& r : rings) {
+        total += align_up(static_cast<size_t>(round_up_pow2(std::max<uint32_t>(r.slots, 1))) * align_up(r.slot_size, 64), kPage);
+    }
+
+    // A segment left behind by a previous run: clients still mapping it keep their copy.
+    (void)::shm_unlink(shm_name.c_str());
+    const int fd = ::shm_open(shm_name.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0660);
+    if (fd < 0) {
+        ARC_LOG_ERROR("ShmCommandLink: shm_open failed for " + shm_name);
+        return false;
+    }
+    void* map = MAP_FAILED;
+    if (::ftruncate(fd, static_cast<off_t>(total)) == 0) {
+        // Populated up front so the control and sensor threads never take a page fault on it.
+        map = ::mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+    }
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        ARC_LOG_ERROR("ShmCommandLink: cannot size or map " + shm_name);
+        (void)::shm_unlink(shm_name.c_str());
+        return false;
+    }
+    map_ = map;
+    map_size_ = total;
+
+    header_ = ::new (map_) ShmSegmentHeader{};
+    header_->magic = kShmMagic;
+    header_->version = kShmVersion;
+    header_->size = total;
+    header_->session = steady_now_ns();
+    size_t offset = align_up(sizeof(ShmSegmentHeader), kPage);
+    for (const RingSpec& r : rings) {
+        ShmRingHeader& h = header_->*r.ring;
+        h.offset = offset;
+        h.slots = round_up_pow2(std::max<uint32_t>(r.slots, 1));
+        h.slot_size = static_cast<uint32_t>(align_up(r.slot_size, 64));
+        *r.state = ShmRingState{&h, static_cast<uint8_t*>(map_) + offset, h.slots - 1u, h.slot_size, 0};
+        offset += align_up(static_cast<size_t>(h.slots) * h.slot_size, kPage);
+    }
+    header_->state.store(static_cast<uint32_t>(ShmSegmentState::Ready), std::memory_order_release);
+
+    ARC_LOG_INFO("ShmCommandLink: /dev/shm" + shm_name + " ready (" + std::to_string(total / 1024) + " KiB)");
+    return true;
+#else
+    ARC_LOG_ERROR("ShmCommandLink: shared-memory link is Linux only");
+    return false;
+#endif
+}
+
+void ShmCommandLink::unmap() {
+#if defined(__linux__)
+    if (!header_) return;
+    header_->state.store(static_cast<uint32_t>(ShmSegmentState::Closed), std::memory_order_release);
+    ring_doorbell(header_->to_client);
+    ::munmap(map_, map_size_);
+    (void)::shm_unlink(("/" + cfg_.name).c_str());
+    header_ = nullptr;
+    commands_ = results_ = events_ = telemetry_ = ShmRingState{};
+    map_ = nullptr;
+    map_size_ = 0;
+#endif
+}
+
+bool ShmCommandLink::pump_rx() {
+    if (!header_ || !router_) return false;
+
+    const Ring ring(commands_);
+    bool received = false;
+    while (const ShmSlotHeader* slot = ring.front()) {
+        received = true;
+        const auto* rec = reinterpret_cast<const ShmCommandRecord*>(slot + 1);
+
+        CommandEnvelope env{};
+        env.stamps.rx_ns = steady_now_ns();
+        env.command_id = rec->command_id;
+        env.issued_ns = rec->issued_ns;
+        env.ttl_ns = rec->ttl_ns;
+        env.command = static_cast<arcraven::ugv::UgvCommand>(rec->command);
+        env.domain = static_cast<arcraven::ugv::CommandDomain>(rec->domain);
+        env.priority = static_cast<arcraven::ugv::CommandPriority>(rec->priority);
+        env.authority = static_cast<arcraven::ugv::CommandAuthority>(rec->authority);
+        const size_t payload_size = rec->payload_size;
+        char* payload = payload_size <= kShmMaxPayload ? env.payload_json.prepare(payload_size) : nullptr;
+        if (payload) {
+            std::memcpy(payload, rec->payload, payload_size);
+            env.payload_json.resize(payload_size);
+        }
+        ring.pop(); // the slot is the client's again; env owns everything from here
+
+        ShmResultRecord reply{};
+        if (!payload) {
+            if (payload_size > kShmMaxPayload) {
+                fill_result(reply, env.command_id, arcraven::ugv::CommandStatus::Rejected,
+                            arcraven::ugv::RejectReason::InvalidPayload, "payload too large");
+            } else {
+                fill_result(reply, env.command_id, arcraven::ugv::CommandStatus::Rejected,
+                            arcraven::ugv::RejectReason::Busy, kPayloadStorageExhausted);
+            }
+            (void)publish_event(reply);
+            continue;
+        }
+
+        admit_and_ack(*router_, credits_, std::move(env), [&](uint64_t command_id, const CommandResult& result) {
+            fill_result(reply, command_id, result.status, result.reject_reason, result.message);
+            (void)publish_event(reply);
+        });
+    }
+    return received;
+}
+
+bool ShmCommandLink::pump_tx() {
+    if (!header_ || !router_) return false;
+
+    // Results and telemetry are written straight into their rings by the producing threads;
+    // only the credit advertisement is the IO thread's.
+    const CommandCredits credits = router_->credits();
+    const uint64_t now = steady_now_ns();
+    if (!credits_.due(credits, now)) return false;
+
+    ShmResultRecord rec{};
+    rec.kind = static_cast<uint8_t>(ShmRecordKind::Credit);
+    rec.timestamp_ns = now;
+    rec.credits = static_cast<uint32_t>(credits.credits);
+    rec.queued = static_cast<uint32_t>(credits.queued);
+    rec.capacity = static_cast<uint32_t>(credits.capacity);
+    rec.backpressure = credits.backpressure ? 1 : 0;
+    return publish_event(rec);
+}
+
+bool ShmCommandLink::publish_event(const ShmResultRecord& record) {
+    const Ring ring(events_);
+    uint8_t* dst = ring.claim();
+    if (!dst) {
+        results_dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    std::memcpy(dst, &record, sizeof(record));
+    ring.publish(sizeof(record));
+    ring_doorbell(header_->to_client);
+    return true;
+}
+
+bool ShmCommandLink::publish_command_result(uint64_t command_id, const CommandResult& result, const AckTiming& ack) {
+    if (!header_) return false;
+
+    const Ring ring(results_);
+    uint8_t* dst = ring.claim();
+    if (!dst) {
+        results_dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    auto* rec = ::new (dst) ShmResultRecord{};
+    fill_result(*rec, command_id, result.status, result.reject_reason, result.message);
+    ring.publish(sizeof(ShmResultRecord));
+    ring_doorbell(header_->to_client);
+    if (latency_) latency_->record_ack(ack, steady_now_ns());
+    return true;
+}
+
+bool ShmCommandLink::publish_telemetry(const SensorFrame& frame, const std::vector<JointState>& joints) {
+    if (!header_) return false;
+
+    const Ring ring(telemetry_);
+    uint8_t* dst = ring.claim();
+    if (!dst) {
+        telemetry_dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    const size_t size = pack_telemetry(dst, ring.record_capacity(), frame, joints);
+    if (size == 0) {
+        telemetry_dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    ring.publish(static_cast<uint32_t>(size));
+    ring_doorbell(header_->to_client);
+    return true;
+}
+
+void ShmCommandLink::wait_until(std::chrono::steady_clock::time_point deadline) {
+#if defined(__linux__)
+    if (header_) {
+        ShmDoorbell& bell = header_->to_core;
+        bell.waiters.fetch_add(1, std::memory_order_seq_cst);
+        const uint32_t seen = bell.seq.load(std::memory_order_seq_cst);
+        const auto left = deadline - std::chrono::steady_clock::now();
+        if (!Ring(commands_).front() && left > std::chrono::steady_clock::duration::zero()) {
+            const auto left_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(left).count();
+            const timespec timeout{static_cast<time_t>(left_ns / 1'000'000'000), static_cast<long>(left_ns % 1'000'000'000)};
+            (void)futex(bell.seq, FUTEX_WAIT, seen, &timeout);
+        }
+        bell.waiters.fetch_sub(1, std::memory_order_seq_cst);
+        return;
+    }
+#endif
+    std::this_thread::sleep_until(deadline);
+}
+
+void ShmCommandLink::wake() {
+    if (header_) ring_doorbell(header_->to_core);
+}
+
+} // namespace arcraven::ugv
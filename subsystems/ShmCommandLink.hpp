@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "command/CommandRouter.hpp"
+#include "command/CommandTypes.hpp"
+#include "subsystems/CommandIngress.hpp"
+#include "subsystems/Interfaces.hpp"
+#include "subsystems/ShmLayout.hpp"
+
+namespace arcraven::ugv {
+
+struct ShmLinkConfig {
+    std::string name = "arcraven_ugv"; // /dev/shm/<name>
+    uint32_t command_slots = 256;
+    uint32_t result_slots = 1024;
+    uint32_t event_slots = 256;
+    uint32_t telemetry_slots = 64;
+    uint32_t telemetry_slot_bytes = 64 * 1024; // frames that do not fit are dropped
+};
+
+// The core's own view of one ring, fixed by init(). The client can write anything in the
+// mapping, so slot addresses come only from this copy of the geometry and the core's position;
+// the geometry in the segment header is for the client to read.
+struct ShmRingState {
+    ShmRingHeader* shared = nullptr; // head/tail published to (and tail/seq read from) the client
+    uint8_t* base = nullptr;
+    uint64_t mask = 0; // slots - 1
+    uint32_t slot_size = 0;
+    uint64_t position = 0; // head of a ring the core produces, tail of the commands ring
+};
+
+// Command link over fixed-slot SPSC rings in a shared-memory segment (layout in ShmLayout.hpp).
+// The core owns the segment: init() replaces any stale one, the destructor marks it Closed and
+// unlinks it. One client process attaches at a time.
+//
+// Records are written in place in the mapping; commands are copied once, into the envelope.
+// Idle pump_rx/pump_tx ticks are a few atomic loads. Linux only; init() fails elsewhere.
+class ShmCommandLink final : public ICommandLink {
+public:
+    ShmCommandLink() = default;
+    ~ShmCommandLink() override;
+
+    ShmCommandLink(const ShmCommandLink&) = delete;
+    ShmCommandLink& operator=(const ShmCommandLink&) = delete;
+
+    void attach_router(CommandRouter* router);
+    // Publish/Total ack latency, recorded as each ack lands in the results ring. Before init().
+    void attach_latency_stats(CommandLatencyStats* stats);
+    void configure(ShmLinkConfig cfg);
+    // How often pump_tx advertises queue credits (always sooner on a backpressure change or a
+    // Busy reject).
+    void configure_credit_interval(std::chrono::milliseconds interval);
+
+    bool init() override;
+    bool pump_rx() override;
+    bool pump_tx() override;
+
+    // IO thread: futex wait on the to_core doorbell until a command is published, wake() or
+    // deadline.
+    void wait_until(std::chrono::steady_clock::time_point deadline) override;
+    void wake() override;
+
+    // Control thread (single producer of the results ring).
+    bool publish_command_result(uint64_t command_id, const CommandResult& result, const AckTiming& ack) override;
+    // Sensor thread (single producer of the telemetry ring).
+    bool publish_telemetry(const SensorFrame& frame, const std::vector<JointState>& joints) override;
+
+    uint64_t results_dropped() const override { return results_dropped_.load(std::memory_order_relaxed); }
+    uint64_t telemetry_dropped() const override { return telemetry_dropped_.load(std::memory_order_relaxed); }
+
+private:
+    // IO thread only (single producer of the events ring).
+    bool publish_event(const ShmResultRecord& record);
+    void unmap();
+
+    ShmLinkConfig cfg_{};
+    CommandRouter* router_ = nullptr;
+    CommandLatencyStats* latency_ = nullptr;
+
+    void* map_ = nullptr;
+    size_t map_size_ = 0;
+    ShmSegmentHeader* header_ = nullptr;
+    // One per ring, each touched by a single thread: IO (commands, events), control (results),
+    // sensor (telemetry).
+    alignas(64) ShmRingState commands_{};
+    alignas(64) ShmRingState results_{};
+    alignas(64) ShmRingState events_{};
+    alignas(64) ShmRingState telemetry_{};
+
+    CreditSchedule credits_;
+
+    std::atomic<uint64_t> results_dropped_{0};
+    std::atomic<uint64_t> telemetry_dropped_{0};
+};
+
+} // namespace arcraven::ugv
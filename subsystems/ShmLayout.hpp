@@ -0,0 +1,119 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace arcraven::ugv {
+
+// Layout of the shared-memory command link segment (/dev/shm/<name>), shared with the Rust
+// ShmTransport (rust/ugv_api/src/transport/shm_transport.rs). Both sides run on the same host:
+// native byte order, no padding beyond what is spelled out here. Bump kShmVersion on any change.
+//
+// The segment is a header followed by four rings, each page-aligned:
+//   commands   client -> core  (consumed by the IO thread)
+//   results    core -> client  (acks, produced by the control thread)
+//   events     core -> client  (immediate rejects and credits, produced by the IO thread)
+//   telemetry  core -> client  (produced by the sensor thread)
+//
+// Every ring has exactly one producer and one consumer. A slot is published by storing
+// seq = position + 1 (release) after its record is written; the consumer reads the record once
+// seq matches and then advances tail (release), which hands the slot back. head/tail are free-
+// running counters; slots is a power of two.
+//
+// Wakeups go through two futex doorbells: whoever publishes bumps seq and FUTEX_WAKEs only if
+// the other side has registered in waiters.
+
+inline constexpr uint32_t kShmMagic = 0x48535241;   // 'ARSH'
+inline constexpr uint32_t kShmVersion = 1;
+inline constexpr size_t kShmMaxPayload = 4096;      // same limit as CommandPayload
+inline constexpr size_t kShmMaxMessage = 120;
+
+enum class ShmSegmentState : uint32_t {
+    Initializing = 0,
+    Ready = 1,
+    Closed = 2, // core shut down; clients should drop the mapping
+};
+
+enum class ShmRecordKind : uint8_t {
+    Result = 1,
+    Credit = 2,
+};
+
+struct alignas(64) ShmRingHeader {
+    uint64_t offset = 0;    // from the start of the segment
+    uint32_t slots = 0;     // power of two
+    uint32_t slot_size = 0; // stride in bytes, multiple of 64
+    alignas(64) std::atomic<uint64_t> head{0}; // producer position
+    alignas(64) std::atomic<uint64_t> tail{0}; // consumer position
+};
+
+struct alignas(64) ShmDoorbell {
+    std::atomic<uint32_t> seq{0};     // futex word
+    std::atomic<uint32_t> waiters{0};
+};
+
+struct ShmSegmentHeader {
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint64_t size = 0;    // whole segment
+    uint64_t session = 0; // core start time (steady ns), changes on every restart
+    std::atomic<uint32_t> state{0};      // ShmSegmentState
+    std::atomic<int32_t> client_pid{0};  // attached client, 0 = none
+    ShmRingHeader commands;
+    ShmRingHeader results;
+    ShmRingHeader events;
+    ShmRingHeader telemetry;
+    ShmDoorbell to_core;
+    ShmDoorbell to_client;
+};
+
+// Precedes every record in a ring slot.
+struct ShmSlotHeader {
+    std::atomic<uint64_t> seq{0}; // position + 1 once published
+    uint32_t size = 0;            // record bytes used
+    uint32_t reserved = 0;
+};
+
+struct ShmCommandRecord {
+    uint64_t command_id = 0;
+    uint64_t issued_ns = 0;
+    uint64_t ttl_ns = 0;
+    uint16_t command = 0;  // UgvCommand
+    uint8_t domain = 0;    // CommandDomain
+    uint8_t priority = 0;  // CommandPriority
+    uint8_t authority = 0; // CommandAuthority
+    uint8_t reserved = 0;
+    uint16_t payload_size = 0;
+    char payload[kShmMaxPayload];
+};
+
+// One result (kind Result) or queue credit advertisement (kind Credit).
+struct ShmResultRecord {
+    uint64_t command_id = 0;
+    uint64_t timestamp_ns = 0; // Credit only
+    uint32_t credits = 0;      // Credit only
+    uint32_t queued = 0;       // Credit only
+    uint32_t capacity = 0;     // Credit only
+    uint8_t kind = 0;          // ShmRecordKind
+    uint8_t status = 0;        // CommandStatus
+    uint8_t reject_reason = 0; // RejectReason
+    uint8_t backpressure = 0;  // Credit only
+    uint8_t message_size = 0;
+    uint8_t reserved[7] = {};
+    char message[kShmMaxMessage];
+};
+
+// Telemetry slots hold a packed frame, the same bytes as a wire Telemetry body (pack_telemetry in
+// WireProtocol.hpp).
+
+static_assert(offsetof(ShmRingHeader, head) == 64 && offsetof(ShmRingHeader, tail) == 128);
+static_assert(sizeof(ShmRingHeader) == 192 && sizeof(ShmDoorbell) == 64);
+static_assert(offsetof(ShmSegmentHeader, state) == 24 && offsetof(ShmSegmentHeader, commands) == 64);
+static_assert(offsetof(ShmSegmentHeader, to_core) == 832 && offsetof(ShmSegmentHeader, to_client) == 896);
+static_assert(sizeof(ShmSlotHeader) == 16);
+static_assert(offsetof(ShmCommandRecord, payload_size) == 30 && offsetof(ShmCommandRecord, payload) == 32);
+static_assert(offsetof(ShmResultRecord, kind) == 28 && offsetof(ShmResultRecord, message) == 40);
+static_assert(sizeof(ShmResultRecord) == 160);
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free);
+
+} // namespace arcraven::ugv
@@ -71,6 +71,19 @@ public:
 
     bool pump_rx() override { return false; }
     bool pump_tx() override { return false; }
+
+    bool publish_command_result(uint64_t command_id, const CommandResult& result, const AckTiming& ack) override {
+        (void)command_id;
+        (void)result;
+        (void)ack;
+        return false;
+    }
+
+    bool publish_telemetry(const SensorFrame& frame, const std::vector<JointState>& joints) override {
+        (void)frame;
+        (void)joints;
+        return false;
+    }
 };
 
 } // namespace arcraven::ugv
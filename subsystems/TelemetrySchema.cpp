@@ -0,0 +1,52 @@
+#include "subsystems/TelemetrySchema.hpp"
+
+#include <algorithm>
+
+namespace arcraven::ugv {
+
+bool TelemetrySchema::update(const SensorFrame& frame, const std::vector<JointState>& joints,
+                             std::vector<uint16_t>& channels) {
+    bool changed = id_ == 0;
+
+    const bool same_joints = std::equal(joints.begin(), joints.end(), joints_.begin(), joints_.end(),
+                                        [](const JointState& a, const Joint& b) { return a.id == b.id && a.name == b.name; });
+    if (!same_joints) {
+        joints_.clear();
+        for (const auto& joint : joints) joints_.push_back({joint.id, joint.name});
+        changed = true;
+    }
+
+    const size_t sensors = telemetry_sensor_count(frame);
+    channels.resize(sensors);
+    bool restarted = false;
+    for (size_t i = 0; i < sensors; ++i) {
+        const auto matches = [&](const Channel& c) { return c.id == frame.ids[i] && c.type == frame.types[i]; };
+        // Sensor suites report in a stable order, so the i-th sensor is usually channel i.
+        size_t at = i < channels_.size() && matches(channels_[i]) ? i : channels_.size();
+        if (at == channels_.size()) {
+            at = static_cast<size_t>(std::find_if(channels_.begin(), channels_.end(), matches) - channels_.begin());
+        }
+        if (at == channels_.size()) {
+            if (channels_.size() == kMaxChannels) {
+                if (restarted) {
+                    // More distinct sensors in one frame than indices: the rest are left out.
+                    channels.resize(i);
+                    break;
+                }
+                // Out of indices: start over from this frame's sensors.
+                channels_.clear();
+                restarted = true;
+                i = static_cast<size_t>(-1);
+                continue;
+            }
+            channels_.push_back({frame.ids[i], frame.types[i]});
+            changed = true;
+        }
+        channels[i] = static_cast<uint16_t>(at);
+    }
+
+    if (changed) ++id_;
+    return changed;
+}
+
+} // namespace arcraven::ugv
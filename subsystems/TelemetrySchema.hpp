@@ -0,0 +1,51 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "subsystems/Interfaces.hpp"
+
+namespace arcraven::ugv {
+
+// Identity of the telemetry stream: the joint list and every sensor channel (id + type) seen so
+// far. It is announced once and frames refer to it, so they carry joint values in schema order
+// and a numeric channel index per sensor instead of repeating the strings at sensor rate.
+class TelemetrySchema final {
+public:
+    struct Joint {
+        std::string id;
+        std::string name;
+    };
+    struct Channel {
+        std::string id;
+        std::string type;
+    };
+
+    // Most channels a schema holds; indices are u16 on the wire.
+    static constexpr size_t kMaxChannels = 0xFFFF;
+
+    // Matches a frame against the schema and fills channels with the channel index of each of
+    // its sensors (fewer than the frame has only past kMaxChannels distinct sensors). A different
+    // joint list or a new sensor changes the schema and bumps id(); returns true then. Allocates
+    // only on a change.
+    bool update(const SensorFrame& frame, const std::vector<JointState>& joints, std::vector<uint16_t>& channels);
+
+    // 0 until the first update().
+    uint32_t id() const { return id_; }
+    const std::vector<Joint>& joints() const { return joints_; }
+    const std::vector<Channel>& channels() const { return channels_; }
+
+private:
+    uint32_t id_ = 0;
+    std::vector<Joint> joints_;
+    std::vector<Channel> channels_;
+};
+
+// Sensors a frame carries: ids, types and payloads are parallel vectors.
+inline size_t telemetry_sensor_count(const SensorFrame& frame) {
+    return std::min(frame.ids.size(), std::min(frame.types.size(), frame.payloads.size()));
+}
+
+} // namespace arcraven::ugv
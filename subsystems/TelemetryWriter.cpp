@@ -0,0 +1,367 @@
+#include "subsystems/TelemetryWriter.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#include "command/CommandTypes.hpp"
+#include "utils/Logger.hpp"
+
+namespace arcraven::ugv {
+
+namespace {
+
+constexpr std::string_view kSegmentPrefix = "telemetry.";
+constexpr std::string_view kSegmentData = ".out";
+constexpr std::string_view kSegmentIndex = ".idx";
+constexpr size_t kSeqDigits = 10;
+
+// Sequence number of a segment data file name, or 0 if name is not one.
+uint64_t parse_segment_name(std::string_view name) {
+    if (name.size() != kSegmentPrefix.size() + kSeqDigits + kSegmentData.size()) return 0;
+    if (!name.starts_with(kSegmentPrefix) || !name.ends_with(kSegmentData)) return 0;
+    const std::string_view digits = name.substr(kSegmentPrefix.size(), kSeqDigits);
+    uint64_t seq = 0;
+    const auto res = std::from_chars(digits.data(), digits.data() + digits.size(), seq);
+    if (res.ec != std::errc{} || res.ptr != digits.data() + digits.size()) return 0;
+    return seq;
+}
+
+uint64_t to_ns(std::chrono::nanoseconds d) {
+    return static_cast<uint64_t>(std::max<int64_t>(d.count(), 0));
+}
+
+} // namespace
+
+std::string telemetry_segment_name(uint64_t seq, std::string_view ext) {
+    char digits[24];
+    std::snprintf(digits, sizeof(digits), "%010llu", static_cast<unsigned long long>(seq));
+    std::string name(kSegmentPrefix);
+    name += digits;
+    name += ext;
+    return name;
+}
+
+bool TelemetryWriter::AppendFile::open(const std::filesystem::path& path) {
+#if defined(__linux__)
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        ARC_LOG_ERROR("TelemetryWriter: cannot open " + path.string() + ": " + std::strerror(errno));
+        return false;
+    }
+#else
+    out.open(path, std::ios::app | std::ios::binary);
+    if (!out.good()) {
+        ARC_LOG_ERROR("TelemetryWriter: cannot open " + path.string());
+        return false;
+    }
+#endif
+    return true;
+}
+
+bool TelemetryWriter::AppendFile::write(const std::string_view* parts, size_t count, size_t& written) {
+    written = 0;
+#if defined(__linux__)
+    iovec iov[4];
+    int n = 0;
+    for (size_t i = 0; i < count && n < 4; ++i) {
+        if (!parts[i].empty()) iov[n++] = {const_cast<char*>(parts[i].data()), parts[i].size()};
+    }
+    iovec* next = iov;
+    while (n > 0) {
+        const ssize_t w = ::writev(fd, next, n);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            ARC_LOG_ERROR(std::string("TelemetryWriter: write failed: ") + std::strerror(errno));
+            return false;
+        }
+        written += static_cast<size_t>(w);
+        // Short write (disk nearly full, signal): continue after the bytes that made it.
+        auto left = static_cast<size_t>(w);
+        while (n > 0 && left >= next->iov_len) {
+            left -= next->iov_len;
+            ++next;
+            --n;
+        }
+        if (n > 0) {
+            next->iov_base = static_cast<char*>(next->iov_base) + left;
+            next->iov_len -= left;
+        }
+    }
+#else
+    for (size_t i = 0; i < count; ++i) out.write(parts[i].data(), static_cast<std::streamsize>(parts[i].size()));
+    out.flush();
+    if (!out.good()) {
+        ARC_LOG_ERROR("TelemetryWriter: write failed");
+        out.clear();
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) written += parts[i].size();
+#endif
+    return true;
+}
+
+void TelemetryWriter::AppendFile::sync() {
+#if defined(__linux__)
+    if (fd >= 0 && ::fdatasync(fd) != 0) {
+        ARC_LOG_WARN(std::string("TelemetryWriter: fdatasync failed: ") + std::strerror(errno));
+    }
+#endif
+}
+
+void TelemetryWriter::AppendFile::close() {
+#if defined(__linux__)
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+#else
+    out.close();
+#endif
+}
+
+TelemetryWriter::TelemetryWriter(TelemetryWriterConfig cfg) : cfg_(cfg) {}
+
+TelemetryWriter::~TelemetryWriter() {
+    close();
+}
+
+void TelemetryWriter::configure(TelemetryWriterConfig cfg) {
+    cfg_ = cfg;
+}
+
+bool TelemetryWriter::open(const std::filesystem::path& dir) {
+    if (is_open()) return true;
+
+    size_t cap = 1;
+    while (cap < std::max<size_t>(cfg_.buffer_bytes, 64 * 1024)) cap <<= 1u;
+    capacity_ = cap;
+    ring_ = std::make_unique<char[]>(capacity_);
+    head_.store(0, std::memory_order_relaxed);
+    tail_.store(0, std::memory_order_relaxed);
+    while (marks_.front()) marks_.pop();
+    // Positions of a previous run mean nothing in the new ring: the latest preamble heads the
+    // first segment.
+    {
+        std::lock_guard<std::mutex> lock(preamble_mutex_);
+        for (auto* changes : {&pending_preambles_, &preamble_changes_}) {
+            if (!changes->empty()) preamble_ = std::move(changes->back().record);
+            changes->clear();
+        }
+    }
+    preamble_changed_.store(false, std::memory_order_relaxed);
+
+    dir_ = dir;
+    segments_.clear();
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(dir_, ec)) {
+        const uint64_t seq = parse_segment_name(entry.path().filename().string());
+        if (seq == 0) continue;
+        std::error_code size_ec;
+        const auto bytes = entry.file_size(size_ec);
+        segments_.push_back({seq, size_ec ? 0 : static_cast<uint64_t>(bytes)});
+    }
+    std::sort(segments_.begin(), segments_.end(), [](const Segment& a, const Segment& b) { return a.seq < b.seq; });
+
+    const uint64_t now = steady_now_ns();
+    const uint64_t seq = segments_.empty() ? 1 : segments_.back().seq + 1;
+    if (!open_segment(seq, now)) return false;
+    enforce_retention();
+
+    dirty_ = false;
+    last_sync_ns_ = now;
+    open_.store(true, std::memory_order_release);
+    return true;
+}
+
+void TelemetryWriter::close() {
+    if (!open_.exchange(false, std::memory_order_acq_rel)) return;
+    // The producer checks open_ before pushing, so nothing new lands after this drain.
+    (void)flush({});
+    close_segment();
+}
+
+void TelemetryWriter::set_preamble(std::string_view record) {
+    {
+        // head_ is the producer's own: exactly the position of the next record pushed.
+        std::lock_guard<std::mutex> lock(preamble_mutex_);
+        preamble_changes_.push_back({head_.load(std::memory_order_relaxed), std::string(record)});
+    }
+    // Published before any later push, so a flush that sees those records sees this as well.
+    preamble_changed_.store(true, std::memory_order_release);
+}
+
+bool TelemetryWriter::push(std::string_view record, uint64_t timestamp_ns) {
+    if (!is_open()) return false;
+
+    const uint64_t head = head_.load(std::memory_order_relaxed);
+    const uint64_t tail = tail_.load(std::memory_order_acquire);
+    if (capacity_ - (head - tail) < record.size()) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    const size_t at = static_cast<size_t>(head & (capacity_ - 1));
+    const size_t first = std::min(record.size(), capacity_ - at);
+    std::memcpy(ring_.get() + at, record.data(), first);
+    std::memcpy(ring_.get(), record.data() + first, record.size() - first);
+    head_.store(head + record.size(), std::memory_order_release);
+
+    // The index is sparse; a mark that does not fit only widens the gap between entries.
+    if (timestamp_ns != 0) {
+        if (Mark* mark = marks_.claim()) {
+            *mark = {head, timestamp_ns};
+            marks_.publish();
+        }
+    }
+    return true;
+}
+
+bool TelemetryWriter::flush(std::string_view prefix) {
+    if (!ring_ || segments_.empty()) return false;
+
+    const uint64_t tail = tail_.load(std::memory_order_relaxed);
+    const uint64_t head = head_.load(std::memory_order_acquire);
+    // After head: a change made before any record in [tail, head) was pushed is in the list.
+    if (preamble_changed_.exchange(false, std::memory_order_acq_rel)) {
+        std::lock_guard<std::mutex> lock(preamble_mutex_);
+        for (auto& change : preamble_changes_) pending_preambles_.push_back(std::move(change));
+        preamble_changes_.clear();
+    }
+
+    // Roll over between batches, so a segment always ends on a record boundary.
+    const uint64_t now = steady_now_ns();
+    const Segment& current = segments_.back();
+    bool roll = cfg_.segment_bytes != 0 && current.bytes >= cfg_.segment_bytes;
+    roll = roll || (cfg_.segment_age.count() > 0 && current.bytes > 0 &&
+                    now - segment_started_ns_ >= to_ns(cfg_.segment_age));
+    if (roll) roll_over(now);
+
+    // A preamble change splits the batch at the position it was made: the records before it
+    // finish the current segment, the ones after it go to a new segment headed by it.
+    bool ok = true;
+    uint64_t from = tail;
+    while (!pending_preambles_.empty() && pending_preambles_.front().pos <= head) {
+        PreambleChange& change = pending_preambles_.front();
+        if (change.pos > from || !prefix.empty()) {
+            ok = write_records(prefix, from, change.pos) && ok;
+            prefix = {};
+            from = change.pos;
+        }
+        preamble_ = std::move(change.record);
+        pending_preambles_.pop_front();
+        if (segments_.back().bytes > 0) roll_over(now);
+    }
+    ok = write_records(prefix, from, head) && ok;
+    tail_.store(head, std::memory_order_release);
+
+    if (cfg_.durability == TelemetryDurability::Periodic && dirty_ &&
+        now - last_sync_ns_ >= to_ns(cfg_.sync_interval)) {
+        sync(now);
+    }
+    return ok;
+}
+
+bool TelemetryWriter::write_records(std::string_view prefix, uint64_t from, uint64_t to) {
+    // Every pushed record is complete and changes fall between records, so [from, to) is a whole
+    // number of records; it wraps at most once.
+    const auto n = static_cast<size_t>(to - from);
+    const size_t at = static_cast<size_t>(from & (capacity_ - 1));
+    const size_t first = std::min(n, capacity_ - at);
+    const std::string_view preamble = segments_.back().bytes == 0 ? std::string_view(preamble_) : std::string_view();
+    const std::string_view parts[4] = {preamble, prefix, {ring_.get() + at, first}, {ring_.get(), n - first}};
+    size_t written = 0;
+    const bool ok = data_.write(parts, 4, written);
+    Segment& segment = segments_.back();
+    const uint64_t base = segment.bytes;
+    segment.bytes += written;
+    dirty_ = dirty_ || written > 0;
+
+    // Index entries go in after the bytes they point at, so a reader never seeks past the end.
+    TelemetryIndexEntry entries[32];
+    size_t count = 0;
+    const auto flush_entries = [&] {
+        if (count == 0) return;
+        const std::string_view bytes{reinterpret_cast<const char*>(entries), count * sizeof(TelemetryIndexEntry)};
+        size_t unused = 0;
+        (void)index_.write(&bytes, 1, unused);
+        count = 0;
+    };
+    while (const Mark* mark = marks_.front()) {
+        // Marks of records past to stay for the next part or the next flush.
+        if (mark->pos >= to) break;
+        const uint64_t offset = base + preamble.size() + prefix.size() + (mark->pos - from);
+        if (mark->pos >= from && offset < base + written && offset >= next_index_offset_) {
+            entries[count++] = {mark->timestamp_ns, offset};
+            next_index_offset_ = offset + std::max<uint32_t>(cfg_.index_interval_bytes, 1);
+            if (count == std::size(entries)) flush_entries();
+        }
+        marks_.pop();
+    }
+    flush_entries();
+    return ok;
+}
+
+bool TelemetryWriter::open_segment(uint64_t seq, uint64_t now_ns) {
+    if (!data_.open(dir_ / telemetry_segment_name(seq, kSegmentData))) return false;
+    if (!index_.open(dir_ / telemetry_segment_name(seq, kSegmentIndex))) {
+        data_.close();
+        return false;
+    }
+    segments_.push_back({seq, 0});
+    segment_started_ns_ = now_ns;
+    next_index_offset_ = 0;
+    return true;
+}
+
+void TelemetryWriter::close_segment() {
+    if (cfg_.durability != TelemetryDurability::None && dirty_) sync(steady_now_ns());
+    data_.close();
+    index_.close();
+}
+
+void TelemetryWriter::roll_over(uint64_t now_ns) {
+    close_segment();
+    const uint64_t seq = segments_.back().seq + 1;
+    if (!open_segment(seq, now_ns)) {
+        // Keep appending to the full segment rather than losing telemetry.
+        ARC_LOG_WARN("TelemetryWriter: rollover failed, staying on segment " + std::to_string(seq - 1));
+        (void)data_.open(dir_ / telemetry_segment_name(seq - 1, kSegmentData));
+        (void)index_.open(dir_ / telemetry_segment_name(seq - 1, kSegmentIndex));
+        segment_started_ns_ = now_ns;
+        return;
+    }
+    enforce_retention();
+}
+
+void TelemetryWriter::enforce_retention() {
+    if (cfg_.retention_bytes == 0) return;
+    uint64_t total = 0;
+    for (const auto& segment : segments_) total += segment.bytes;
+    while (segments_.size() > 1 && total > cfg_.retention_bytes) {
+        const Segment oldest = segments_.front();
+        segments_.pop_front();
+        total -= oldest.bytes;
+        std::error_code ec;
+        std::filesystem::remove(dir_ / telemetry_segment_name(oldest.seq, kSegmentData), ec);
+        std::filesystem::remove(dir_ / telemetry_segment_name(oldest.seq, kSegmentIndex), ec);
+        ARC_LOG_INFO("TelemetryWriter: retention removed segment " + std::to_string(oldest.seq));
+    }
+}
+
+void TelemetryWriter::sync(uint64_t now_ns) {
+    data_.sync();
+    index_.sync();
+    dirty_ = false;
+    last_sync_ns_ = now_ns;
+}
+
+} // namespace arcraven::ugv
@@ -0,0 +1,160 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "core/SpscRing.hpp"
+
+namespace arcraven::ugv {
+
+enum class TelemetryDurability : uint8_t {
+    None = 0,     // leave write-back to the kernel; a crash can lose the last few seconds
+    Periodic = 1, // fdatasync at most every sync_interval while there is unsynced data
+};
+
+struct TelemetryWriterConfig {
+    // Preallocated buffer between the sensor thread and the IO thread. A frame that does not fit
+    // is dropped (and counted) rather than stalling the sensor loop.
+    size_t buffer_bytes = 1u << 20;
+    TelemetryDurability durability = TelemetryDurability::None;
+    std::chrono::milliseconds sync_interval{1000};
+
+    // A new segment is started on every open() and once the current one reaches segment_bytes
+    // or segment_age (0 disables either limit).
+    uint64_t segment_bytes = 64ull << 20;
+    std::chrono::seconds segment_age{3600};
+    // Oldest segments are deleted at rollover while all of them together exceed
+    // retention_bytes (0 keeps everything). The footprint stays under retention_bytes plus one
+    // segment.
+    uint64_t retention_bytes = 1ull << 30;
+    // Sparse index: a timestamp -> offset entry for the first frame of a segment and then at
+    // most one per index_interval_bytes.
+    uint32_t index_interval_bytes = 64 * 1024;
+};
+
+// On-disk layout, shared with the Rust Iceoryx2Transport:
+//   <dir>/telemetry.<seq>.out  records (text lines and wire frames), seq zero-padded to 10 digits
+//   <dir>/telemetry.<seq>.idx  TelemetryIndexEntry array, timestamps ascending
+// seq only grows, so a reader that reached the end of segment N and sees segment N + 1 knows
+// N is complete. Records never straddle segments. A segment starts with the preamble, if one
+// is set (the interned telemetry schema), so a reader can start anywhere in it.
+struct TelemetryIndexEntry {
+    uint64_t timestamp_ns = 0; // telemetry frame timestamp (core steady clock)
+    uint64_t offset = 0;       // where that frame starts in the .out file
+};
+static_assert(sizeof(TelemetryIndexEntry) == 16, "index entry layout is part of the file format");
+
+std::string telemetry_segment_name(uint64_t seq, std::string_view ext);
+
+// Long-lived, segmented appender for the bridge's telemetry stream.
+//
+// push() copies an encoded record into a preallocated single-producer byte ring and returns; it
+// never blocks, allocates or touches a file. flush() appends the caller's batch followed by
+// everything pushed so far with one writev on a descriptor kept open until rollover, adds the
+// index entries that fall due, then applies the rollover, retention and durability policies.
+// Rollover, deletions and fdatasync all run on the flushing (IO) thread.
+class TelemetryWriter final {
+public:
+    explicit TelemetryWriter(TelemetryWriterConfig cfg = {});
+    ~TelemetryWriter();
+
+    TelemetryWriter(const TelemetryWriter&) = delete;
+    TelemetryWriter& operator=(const TelemetryWriter&) = delete;
+
+    // Before open().
+    void configure(TelemetryWriterConfig cfg);
+
+    // Starts a new segment in dir, after any segments already there.
+    bool open(const std::filesystem::path& dir);
+    // Writes what is still buffered (synced under Periodic) and closes the segment.
+    void close();
+    bool is_open() const { return open_.load(std::memory_order_acquire); }
+
+    // Producer thread: record written at the start of every segment from now on. The change is
+    // in-band: records pushed before this call finish the current segment and the ones pushed
+    // after it start a new one that begins with record (the current one is reused if still
+    // empty). Allocates; meant for rare changes.
+    void set_preamble(std::string_view record);
+    // Producer thread: one whole record, or false (counted in dropped()) if it does not fit.
+    // timestamp_ns makes the record indexable; 0 for records that are not telemetry frames.
+    bool push(std::string_view record, uint64_t timestamp_ns);
+    // Consumer thread: writes prefix, then the pushed records. Call every tick, even with nothing
+    // to write, so a Periodic sync or an age rollover is not held back until the next record.
+    // False on a write error; the batch is dropped.
+    bool flush(std::string_view prefix);
+
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    // One append-only file; a raw descriptor on Linux, an ofstream elsewhere.
+    struct AppendFile {
+        int fd = -1;
+        std::ofstream out;
+
+        bool open(const std::filesystem::path& path);
+        bool write(const std::string_view* parts, size_t count, size_t& written);
+        void sync();
+        void close();
+    };
+
+    struct Segment {
+        uint64_t seq = 0;
+        uint64_t bytes = 0;
+    };
+
+    // Position and timestamp of a pushed telemetry frame, for the index.
+    struct Mark {
+        uint64_t pos = 0;
+        uint64_t timestamp_ns = 0;
+    };
+
+    // A set_preamble() call: record heads the segments written from ring position pos on.
+    struct PreambleChange {
+        uint64_t pos = 0;
+        std::string record;
+    };
+
+    bool write_records(std::string_view prefix, uint64_t from, uint64_t to);
+    bool open_segment(uint64_t seq, uint64_t now_ns);
+    void close_segment();
+    void roll_over(uint64_t now_ns);
+    void enforce_retention();
+    void sync(uint64_t now_ns);
+
+    TelemetryWriterConfig cfg_;
+    std::unique_ptr<char[]> ring_;
+    size_t capacity_ = 0;
+    SpscRing<Mark> marks_{4096};
+
+    alignas(64) std::atomic<uint64_t> head_{0}; // producer
+    alignas(64) std::atomic<uint64_t> tail_{0}; // consumer
+
+    std::atomic<bool> open_{false};
+    std::atomic<uint64_t> dropped_{0};
+
+    std::mutex preamble_mutex_;
+    std::deque<PreambleChange> preamble_changes_; // guarded by preamble_mutex_
+    std::atomic<bool> preamble_changed_{false};
+
+    // Consumer-private.
+    std::filesystem::path dir_;
+    std::string preamble_;
+    std::deque<PreambleChange> pending_preambles_; // taken over, not reached yet; oldest first
+    AppendFile data_;
+    AppendFile index_;
+    std::deque<Segment> segments_; // oldest first; back() is being written
+    uint64_t segment_started_ns_ = 0;
+    uint64_t next_index_offset_ = 0;
+    bool dirty_ = false;
+    uint64_t last_sync_ns_ = 0;
+};
+
+} // namespace arcraven::ugv
@@ -0,0 +1,340 @@
+#include "subsystems/WireProtocol.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#include "utils/Crc32c.hpp"
+
+namespace arcraven::ugv {
+
+// Fields are copied with memcpy in host order; every supported target is little-endian.
+static_assert(std::endian::native == std::endian::little, "wire format assumes a little-endian host");
+
+namespace {
+
+template <typename T>
+void store(uint8_t* dst, T v) {
+    std::memcpy(dst, &v, sizeof(v));
+}
+
+template <typename T>
+T load(const char* src) {
+    T v{};
+    std::memcpy(&v, src, sizeof(v));
+    return v;
+}
+
+// Reserves the header and returns its offset; finish_frame() fills it in once the body is there.
+size_t begin_frame(std::string& out) {
+    const size_t at = out.size();
+    out.append(kWireHeaderSize, '\0');
+    return at;
+}
+
+void finish_frame(std::string& out, size_t at, WireFrameType type, uint8_t version) {
+    auto* h = reinterpret_cast<uint8_t*>(out.data() + at);
+    const size_t length = out.size() - at - kWireHeaderSize;
+    store<uint32_t>(h, kWireMagic);
+    h[4] = version;
+    h[5] = static_cast<uint8_t>(type);
+    store<uint16_t>(h + 6, 0);
+    store<uint32_t>(h + 8, static_cast<uint32_t>(length));
+    const uint32_t crc = arcraven::utils::crc32c(h + kWireHeaderSize, length, arcraven::utils::crc32c(h, 12));
+    store<uint32_t>(h + 12, crc);
+}
+
+uint8_t* grow(std::string& out, size_t n) {
+    const size_t at = out.size();
+    out.resize(at + n);
+    return reinterpret_cast<uint8_t*>(out.data() + at);
+}
+
+// Packs a telemetry frame; ok turns false once dst is too small or a string too long.
+struct FrameWriter {
+    uint8_t* dst;
+    size_t cap;
+    size_t size = 0;
+    bool ok = true;
+
+    void bytes(const void* p, size_t n) {
+        if (!ok || n > cap - size) {
+            ok = false;
+            return;
+        }
+        std::memcpy(dst + size, p, n);
+        size += n;
+    }
+    template <typename T>
+    void put(T v) {
+        bytes(&v, sizeof(v));
+    }
+    template <typename Len>
+    void str(const std::string& s) {
+        if (s.size() > static_cast<size_t>(static_cast<Len>(~Len{0}))) {
+            ok = false;
+            return;
+        }
+        put(static_cast<Len>(s.size()));
+        bytes(s.data(), s.size());
+    }
+};
+
+} // namespace
+
+bool wire_frame_at(std::string_view in) {
+    uint8_t magic[4];
+    store<uint32_t>(magic, kWireMagic);
+    const size_t n = std::min<size_t>(in.size(), sizeof(magic));
+    return n > 0 && std::memcmp(in.data(), magic, n) == 0;
+}
+
+WireScan scan_wire_frame(std::string_view in, size_t max_body, WireFrame& frame) {
+    if (in.size() < kWireHeaderSize) return wire_frame_at(in) ? WireScan::NeedMore : WireScan::Bad;
+    if (load<uint32_t>(in.data()) != kWireMagic) return WireScan::Bad;
+    const uint8_t version = static_cast<uint8_t>(in[4]);
+    const uint32_t length = load<uint32_t>(in.data() + 8);
+    if (version == 0 || length > max_body) return WireScan::Bad;
+    if (in.size() - kWireHeaderSize < length) return WireScan::NeedMore;
+
+    frame.version = version;
+    frame.type = static_cast<WireFrameType>(in[5]);
+    frame.body = in.substr(kWireHeaderSize, length);
+    frame.size = kWireHeaderSize + length;
+    const uint32_t crc = arcraven::utils::crc32c(in.data() + kWireHeaderSize, length, arcraven::utils::crc32c(in.data(), 12));
+    return crc == load<uint32_t>(in.data() + 12) ? WireScan::Frame : WireScan::Corrupt;
+}
+
+void append_hello_frame(std::string& out, uint8_t version, uint16_t features) {
+    const size_t at = begin_frame(out);
+    uint8_t* b = grow(out, 4);
+    store<uint16_t>(b, version);
+    store<uint16_t>(b + 2, features);
+    finish_frame(out, at, WireFrameType::Hello, 1);
+}
+
+void append_command_frame(std::string& out, const CommandEnvelope& env) {
+    const size_t at = begin_frame(out);
+    uint8_t* b = grow(out, kWireCommandFixed);
+    store<uint64_t>(b, env.command_id);
+    store<uint64_t>(b + 8, env.issued_ns);
+    store<uint64_t>(b + 16, env.ttl_ns);
+    store<uint16_t>(b + 24, static_cast<uint16_t>(env.command));
+    b[26] = static_cast<uint8_t>(env.domain);
+    b[27] = static_cast<uint8_t>(env.priority);
+    b[28] = static_cast<uint8_t>(env.authority);
+    b[29] = b[30] = b[31] = 0;
+    out += env.payload_json.view();
+    finish_frame(out, at, WireFrameType::Command, kWireVersion);
+}
+
+void append_result_frame(std::string& out, uint64_t command_id, arcraven::ugv::CommandStatus status,
+                         arcraven::ugv::RejectReason reason, std::string_view message) {
+    const size_t at = begin_frame(out);
+    uint8_t* b = grow(out, kWireResultFixed);
+    store<uint64_t>(b, command_id);
+    b[8] = static_cast<uint8_t>(status);
+    b[9] = static_cast<uint8_t>(reason);
+    store<uint16_t>(b + 10, 0);
+    out += message;
+    finish_frame(out, at, WireFrameType::Result, kWireVersion);
+}
+
+void append_credit_frame(std::string& out, uint64_t timestamp_ns, const CommandCredits& credits) {
+    const size_t at = begin_frame(out);
+    uint8_t* b = grow(out, kWireCreditSize);
+    store<uint64_t>(b, timestamp_ns);
+    store<uint32_t>(b + 8, static_cast<uint32_t>(credits.credits));
+    store<uint32_t>(b + 12, static_cast<uint32_t>(credits.queued));
+    store<uint32_t>(b + 16, static_cast<uint32_t>(credits.capacity));
+    b[20] = credits.backpressure ? 1 : 0;
+    b[21] = b[22] = b[23] = 0;
+    finish_frame(out, at, WireFrameType::Credit, kWireVersion);
+}
+
+bool append_telemetry_frame(std::string& out, const SensorFrame& frame, const std::vector<JointState>& joints) {
+    const size_t at = begin_frame(out);
+    const size_t cap = telemetry_packed_size(frame, joints);
+    uint8_t* b = grow(out, cap);
+    if (pack_telemetry(b, cap, frame, joints) == 0) {
+        out.resize(at);
+        return false;
+    }
+    finish_frame(out, at, WireFrameType::Telemetry, kWireVersion);
+    return true;
+}
+
+bool append_schema_frame(std::string& out, const TelemetrySchema& schema) {
+    size_t cap = 12;
+    for (const auto& joint : schema.joints()) cap += 2 + joint.id.size() + 2 + joint.name.size();
+    for (const auto& channel : schema.channels()) cap += 2 + channel.id.size() + 2 + channel.type.size();
+
+    const size_t at = begin_frame(out);
+    FrameWriter w{grow(out, cap), cap};
+    w.put<uint32_t>(schema.id());
+    w.put<uint32_t>(static_cast<uint32_t>(schema.joints().size()));
+    w.put<uint32_t>(static_cast<uint32_t>(schema.channels().size()));
+    for (const auto& joint : schema.joints()) {
+        w.str<uint16_t>(joint.id);
+        w.str<uint16_t>(joint.name);
+    }
+    for (const auto& channel : schema.channels()) {
+        w.str<uint16_t>(channel.id);
+        w.str<uint16_t>(channel.type);
+    }
+    if (!w.ok) {
+        out.resize(at);
+        return false;
+    }
+    finish_frame(out, at, WireFrameType::Schema, kWireVersion);
+    return true;
+}
+
+bool append_interned_telemetry_frame(std::string& out, uint32_t schema_id, const SensorFrame& frame,
+                                     const std::vector<JointState>& joints, const std::vector<uint16_t>& channels) {
+    size_t cap = 16 + joints.size() * 3 * sizeof(double);
+    for (size_t i = 0; i < channels.size(); ++i) cap += 2 + 4 + frame.payloads[i].size();
+
+    const size_t at = begin_frame(out);
+    FrameWriter w{grow(out, cap), cap};
+    w.put<uint64_t>(frame.timestamp_ns);
+    w.put<uint32_t>(schema_id);
+    w.put<uint32_t>(static_cast<uint32_t>(channels.size()));
+    for (const auto& joint : joints) {
+        w.put(joint.position);
+        w.put(joint.velocity);
+        w.put(joint.load);
+    }
+    for (size_t i = 0; i < channels.size(); ++i) {
+        w.put<uint16_t>(channels[i]);
+        w.str<uint32_t>(frame.payloads[i]);
+    }
+    if (!w.ok) {
+        out.resize(at);
+        return false;
+    }
+    finish_frame(out, at, WireFrameType::InternedTelemetry, kWireVersion);
+    return true;
+}
+
+namespace {
+
+// Writes at most 10 bytes; returns how many.
+size_t put_zigzag_varint(uint8_t* dst, int64_t v) {
+    uint64_t u = (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+    size_t n = 0;
+    while (u >= 0x80) {
+        dst[n++] = static_cast<uint8_t>(u) | 0x80;
+        u >>= 7;
+    }
+    dst[n++] = static_cast<uint8_t>(u);
+    return n;
+}
+
+} // namespace
+
+void append_zigzag_varint(std::string& out, int64_t v) {
+    uint8_t buf[10];
+    out.append(reinterpret_cast<const char*>(buf), put_zigzag_varint(buf, v));
+}
+
+bool append_delta_telemetry_frame(std::string& out, uint32_t schema_id, const JointDeltaEncoder& delta,
+                                  const SensorFrame& frame, const std::vector<uint16_t>& channels) {
+    const size_t at = begin_frame(out);
+    uint8_t* b = grow(out, 20);
+    store<uint64_t>(b, frame.timestamp_ns);
+    store<uint32_t>(b + 8, schema_id);
+    store<uint32_t>(b + 12, delta.seq());
+    b[16] = delta.keyframe() ? 1 : 0;
+    b[17] = b[18] = b[19] = 0;
+    if (delta.keyframe()) {
+        b = grow(out, 3 * sizeof(double));
+        store(b, delta.config().position_resolution);
+        store(b + 8, delta.config().velocity_resolution);
+        store(b + 16, delta.config().load_resolution);
+    }
+    // Sized for the worst case, then trimmed.
+    const size_t values_at = out.size();
+    b = grow(out, delta.values().size() * 10);
+    size_t used = 0;
+    for (const int64_t v : delta.values()) used += put_zigzag_varint(b + used, v);
+    out.resize(values_at + used);
+
+    size_t cap = 4;
+    for (size_t i = 0; i < channels.size(); ++i) cap += 2 + 4 + frame.payloads[i].size();
+    FrameWriter w{grow(out, cap), cap};
+    w.put<uint32_t>(static_cast<uint32_t>(channels.size()));
+    for (size_t i = 0; i < channels.size(); ++i) {
+        w.put<uint16_t>(channels[i]);
+        w.str<uint32_t>(frame.payloads[i]);
+    }
+    if (!w.ok) {
+        out.resize(at);
+        return false;
+    }
+    finish_frame(out, at, WireFrameType::DeltaTelemetry, kWireVersion);
+    return true;
+}
+
+size_t telemetry_packed_size(const SensorFrame& frame, const std::vector<JointState>& joints) {
+    size_t n = 16;
+    for (const auto& joint : joints) n += 2 + joint.id.size() + 2 + joint.name.size() + 3 * sizeof(double);
+    const size_t sensors = telemetry_sensor_count(frame);
+    for (size_t i = 0; i < sensors; ++i) {
+        n += 2 + frame.ids[i].size() + 2 + frame.types[i].size() + 4 + frame.payloads[i].size();
+    }
+    return n;
+}
+
+size_t pack_telemetry(uint8_t* dst, size_t cap, const SensorFrame& frame, const std::vector<JointState>& joints) {
+    const size_t sensors = telemetry_sensor_count(frame);
+    FrameWriter w{dst, cap};
+    w.put<uint64_t>(frame.timestamp_ns);
+    w.put<uint32_t>(static_cast<uint32_t>(joints.size()));
+    w.put<uint32_t>(static_cast<uint32_t>(sensors));
+    for (const auto& joint : joints) {
+        w.str<uint16_t>(joint.id);
+        w.str<uint16_t>(joint.name);
+        w.put(joint.position);
+        w.put(joint.velocity);
+        w.put(joint.load);
+    }
+    for (size_t i = 0; i < sensors; ++i) {
+        w.str<uint16_t>(frame.ids[i]);
+        w.str<uint16_t>(frame.types[i]);
+        w.str<uint32_t>(frame.payloads[i]);
+    }
+    return w.ok ? w.size : 0;
+}
+
+CommandLineResult decode_command_frame(std::string_view body, CommandEnvelope& env) {
+    if (body.size() < kWireCommandFixed) {
+        return {CommandLineStatus::Malformed, arcraven::ugv::RejectReason::InvalidPayload, "short command frame"};
+    }
+    env.command_id = load<uint64_t>(body.data());
+    env.issued_ns = load<uint64_t>(body.data() + 8);
+    env.ttl_ns = load<uint64_t>(body.data() + 16);
+    env.command = static_cast<arcraven::ugv::UgvCommand>(load<uint16_t>(body.data() + 24));
+    env.domain = static_cast<arcraven::ugv::CommandDomain>(body[26]);
+    env.priority = static_cast<arcraven::ugv::CommandPriority>(body[27]);
+    env.authority = static_cast<arcraven::ugv::CommandAuthority>(body[28]);
+
+    const std::string_view payload = body.substr(kWireCommandFixed);
+    if (!env.payload_json.assign(payload)) {
+        if (payload.size() <= CommandPayload::kMaxSize) {
+            return {CommandLineStatus::Invalid, arcraven::ugv::RejectReason::Busy, kPayloadStorageExhausted};
+        }
+        return {CommandLineStatus::Invalid, arcraven::ugv::RejectReason::InvalidPayload, "payload too large"};
+    }
+    return {CommandLineStatus::Ok, arcraven::ugv::RejectReason::None, ""};
+}
+
+bool decode_hello_frame(std::string_view body, uint8_t& version, uint16_t& features) {
+    if (body.size() < 4) return false;
+    const uint16_t v = load<uint16_t>(body.data());
+    version = static_cast<uint8_t>(std::min<uint16_t>(v, 0xFF));
+    features = load<uint16_t>(body.data() + 2);
+    return true;
+}
+
+} // namespace arcraven::ugv
@@ -0,0 +1,141 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "command/CommandRouter.hpp"
+#include "command/CommandTypes.hpp"
+#include "subsystems/CommandLineParser.hpp"
+#include "subsystems/Interfaces.hpp"
+#include "subsystems/JointDeltaEncoder.hpp"
+#include "subsystems/TelemetrySchema.hpp"
+
+namespace arcraven::ugv {
+
+// Binary framing of the file transport (commands.in / telemetry.<seq>.out), shared with the Rust
+// Iceoryx2Transport (rust/ugv_api/src/transport/wire.rs). Little-endian, unaligned fields.
+//
+// Every frame is a 16-byte header followed by length body bytes:
+//   u32 magic (bytes AC 'U' 'G' 'V'), u8 version, u8 type, u16 flags (0), u32 length,
+//   u32 crc32c over header bytes 0..12 and the body
+//
+// 0xAC never starts a text record, so both files can mix text lines and frames and readers
+// tell them apart per record. A frame failing its CRC is skipped whole; anything else that
+// starts with 0xAC but is not a frame is skipped up to the next magic or newline.
+//
+// Bodies (version 1):
+//   Hello     u16 version, u16 features
+//   Command   u64 command_id, u64 issued_ns, u64 ttl_ns, u16 command, u8 domain, u8 priority,
+//             u8 authority, u8[3] reserved, payload bytes (rest of the body)
+//   Result    u64 command_id, u8 status, u8 reject_reason, u16 reserved, message bytes
+//   Credit    u64 timestamp_ns, u32 credits, u32 queued, u32 capacity, u8 backpressure, u8[3]
+//   Telemetry packed frame, same as a ShmCommandLink telemetry slot (see pack_telemetry)
+//   Schema    u32 schema_id, u32 joint_count, u32 channel_count,
+//             joint_count x { u16 len, id, u16 len, name }, channel_count x { u16 len, id, u16 len, type }
+//   InternedTelemetry
+//             u64 timestamp_ns, u32 schema_id, u32 sensor_count,
+//             joint_count x { f64 position, f64 velocity, f64 load } in schema order,
+//             sensor_count x { u16 channel, u32 len, payload }
+//   DeltaTelemetry
+//             u64 timestamp_ns, u32 schema_id, u32 seq, u8 keyframe, u8[3] reserved,
+//             keyframe only: f64 position_resolution, f64 velocity_resolution, f64 load_resolution,
+//             joint_count x 3 zigzag varints in schema order (quantized values in a keyframe,
+//             changes since frame seq - 1 otherwise; see JointDeltaEncoder),
+//             u32 sensor_count, sensor_count x { u16 channel, u32 len, payload }
+//
+// Negotiation: a client that speaks frames writes Hello{its highest version} to commands.in.
+// The bridge answers with Hello{agreed version} in the telemetry stream and from then on writes
+// results, credits and telemetry as frames. Until then, or when the bridge is configured for
+// text, telemetry stays text. commands.in accepts both formats at any time. Hello itself is
+// always framed as version 1.
+//
+// Hello also carries feature bits: the client's in its Hello, the ones the bridge agreed to in
+// the answer. With kWireFeatureInternedTelemetry the bridge sends Schema and InternedTelemetry
+// instead of Telemetry. Clients that set no features keep getting Telemetry. On top of it,
+// kWireFeatureDeltaTelemetry (when the bridge has JointDeltaConfig::enabled) sends
+// DeltaTelemetry instead of InternedTelemetry.
+
+inline constexpr uint32_t kWireMagic = 0x564755ACu;
+inline constexpr uint8_t kWireVersion = 1;
+inline constexpr size_t kWireHeaderSize = 16;
+inline constexpr size_t kWireCommandFixed = 32;
+inline constexpr size_t kWireResultFixed = 12;
+inline constexpr size_t kWireCreditSize = 24;
+inline constexpr size_t kWireMaxCommandBody = kWireCommandFixed + CommandPayload::kMaxSize;
+
+inline constexpr uint16_t kWireFeatureInternedTelemetry = 0x0001;
+inline constexpr uint16_t kWireFeatureDeltaTelemetry = 0x0002;
+
+enum class WireFrameType : uint8_t {
+    Hello = 1,
+    Command = 2,
+    Result = 3,
+    Credit = 4,
+    Telemetry = 5,
+    Schema = 6,
+    InternedTelemetry = 7,
+    DeltaTelemetry = 8,
+};
+
+enum class WireScan : uint8_t {
+    Frame = 0,    // complete and intact
+    NeedMore = 1, // a prefix of a plausible frame
+    Bad = 2,      // wrong magic, zero version or oversized length: not a frame
+    Corrupt = 3,  // complete but failing its CRC; frame.size is how far to skip
+};
+
+struct WireFrame {
+    uint8_t version = 0;
+    WireFrameType type = WireFrameType::Hello;
+    std::string_view body;
+    size_t size = 0; // header + body
+};
+
+// True if in starts with the magic, or with a prefix of it when shorter than four bytes.
+bool wire_frame_at(std::string_view in);
+
+// Validates the frame at the front of in. Frames of a newer version are returned as well (the
+// length is still meaningful); callers skip types or versions they do not know.
+WireScan scan_wire_frame(std::string_view in, size_t max_body, WireFrame& frame);
+
+// Each appends one complete frame to out.
+void append_hello_frame(std::string& out, uint8_t version, uint16_t features = 0);
+void append_command_frame(std::string& out, const CommandEnvelope& env);
+void append_result_frame(std::string& out, uint64_t command_id, arcraven::ugv::CommandStatus status,
+                         arcraven::ugv::RejectReason reason, std::string_view message);
+void append_credit_frame(std::string& out, uint64_t timestamp_ns, const CommandCredits& credits);
+// False (out unchanged) if an id, name or type exceeds 65535 bytes.
+bool append_telemetry_frame(std::string& out, const SensorFrame& frame, const std::vector<JointState>& joints);
+// False (out unchanged) if an id, name or type exceeds 65535 bytes.
+bool append_schema_frame(std::string& out, const TelemetrySchema& schema);
+// channels as filled by TelemetrySchema::update for this frame; joints must match the schema.
+// False (out unchanged) if a payload exceeds 4 GiB.
+bool append_interned_telemetry_frame(std::string& out, uint32_t schema_id, const SensorFrame& frame,
+                                     const std::vector<JointState>& joints, const std::vector<uint16_t>& channels);
+
+// joints as prepared by delta (after a successful prepare() for this frame). False (out
+// unchanged) if a payload exceeds 4 GiB.
+bool append_delta_telemetry_frame(std::string& out, uint32_t schema_id, const JointDeltaEncoder& delta,
+                                  const SensorFrame& frame, const std::vector<uint16_t>& channels);
+
+// Zigzag + LEB128 varint, as used by DeltaTelemetry.
+void append_zigzag_varint(std::string& out, int64_t v);
+
+// Packed telemetry frame:
+//   u64 timestamp_ns, u32 joint_count, u32 sensor_count,
+//   joint_count  x { u16 len, id, u16 len, name, f64 position, f64 velocity, f64 load }
+//   sensor_count x { u16 len, id, u16 len, type, u32 len, payload }
+// Returns the packed size, or 0 if it does not fit in cap or a string is too long for its
+// length field.
+size_t telemetry_packed_size(const SensorFrame& frame, const std::vector<JointState>& joints);
+size_t pack_telemetry(uint8_t* dst, size_t cap, const SensorFrame& frame, const std::vector<JointState>& joints);
+
+// Decodes a Command body into env with the same statuses as parse_command_line: Malformed when
+// shorter than the fixed part, Invalid (InvalidPayload) when the payload does not fit. Enum
+// ranges are left to admit_command.
+CommandLineResult decode_command_frame(std::string_view body, CommandEnvelope& env);
+bool decode_hello_frame(std::string_view body, uint8_t& version, uint16_t& features);
+
+} // namespace arcraven::ugv
@@ -0,0 +1,178 @@
+// Streams a command journal (data_dir/commands.journal) back through a CommandRouter.
+//
+// Dispatched records are resubmitted in their original enqueue order and dispatched by a
+// simulated 200 Hz control loop (8 commands per tick, like UgvCore) on the recorded clock, so
+// TTL expiry, priorities, coalescing and authority checks behave as they did on the vehicle.
+// Handlers answer with the journaled result (authority commands are re-applied to the arbiter);
+// every outcome whose status/reason differs from the journal is a mismatch.
+//
+// --speed 1x paces the ticks in real time (post-incident walkthrough); --speed max runs them
+// back to back (regression benchmark). Exits non-zero on any mismatch.
+//
+// Usage: ugv_replay <journal> [--speed 1x|max] [--tick-us 5000] [--queue 256] [--verbose]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "command/CommandJournal.hpp"
+#include "command/CommandRouter.hpp"
+#include "core/LatencyHistogram.hpp"
+
+namespace {
+
+using namespace arcraven::ugv;
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string journal;
+    bool realtime = false;
+    uint64_t tick_ns = 5'000'000;
+    size_t max_queue = 256;
+    bool verbose = false;
+};
+
+bool parse_args(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--speed" && i + 1 < argc) {
+            const std::string_view v = argv[++i];
+            if (v != "1x" && v != "max") return false;
+            o.realtime = v == "1x";
+        } else if (arg == "--tick-us" && i + 1 < argc) {
+            o.tick_ns = std::strtoull(argv[++i], nullptr, 10) * 1000;
+        } else if (arg == "--queue" && i + 1 < argc) {
+            o.max_queue = static_cast<size_t>(std::strtoull(argv[++i], nullptr, 10));
+        } else if (arg == "--verbose") {
+            o.verbose = true;
+        } else if (o.journal.empty() && !arg.starts_with("--")) {
+            o.journal = arg;
+        } else {
+            return false;
+        }
+    }
+    return !o.journal.empty() && o.tick_ns > 0 && o.max_queue > 0;
+}
+
+bool is_authority_command(UgvCommand cmd) {
+    return command_info(cmd) && command_info(cmd)->domain == CommandDomain::Authority;
+}
+
+void print_span(const char* label, const LatencyHistogram& h) {
+    if (h.count() == 0) return;
+    std::printf("  %-8s p50=%10.1fus p99=%10.1fus max=%10.1fus\n", label,
+                static_cast<double>(h.quantile(0.5)) / 1000.0, static_cast<double>(h.quantile(0.99)) / 1000.0,
+                static_cast<double>(h.max()) / 1000.0);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parse_args(argc, argv, opt)) {
+        std::fprintf(stderr, "usage: ugv_replay <journal> [--speed 1x|max] [--tick-us 5000] [--queue 256] [--verbose]\n");
+        return 2;
+    }
+
+    CommandJournalReader reader;
+    if (!reader.open(opt.journal)) {
+        std::fprintf(stderr, "ugv_replay: cannot read journal %s\n", opt.journal.c_str());
+        return 2;
+    }
+
+    std::vector<JournalRecord> records;
+    std::unordered_map<uint64_t, CommandResult> expected;
+    size_t task_reports = 0;
+    LatencyHistogram rec_queue;
+    LatencyHistogram rec_execute;
+    for (JournalRecord rec; reader.next(rec);) {
+        if (rec.header.kind != JournalRecordKind::Dispatched) {
+            ++task_reports;
+            continue;
+        }
+        const auto& h = rec.header;
+        if (h.dispatch_ns >= h.enqueue_ns && h.enqueue_ns != 0) rec_queue.record(h.dispatch_ns - h.enqueue_ns);
+        if (h.done_ns >= h.dispatch_ns && h.dispatch_ns != 0) rec_execute.record(h.done_ns - h.dispatch_ns);
+        expected[h.command_id] = rec.result();
+        records.push_back(std::move(rec));
+    }
+    if (reader.corrupt()) {
+        std::fprintf(stderr, "ugv_replay: journal ends in a torn or corrupt record; replaying what precedes it\n");
+    }
+    if (records.empty()) {
+        std::printf("records=0 task_reports=%zu\n", task_reports);
+        return 0;
+    }
+
+    std::stable_sort(records.begin(), records.end(), [](const JournalRecord& a, const JournalRecord& b) {
+        return a.header.enqueue_ns < b.header.enqueue_ns;
+    });
+
+    CommandRouter router(CommandRouterConfig{.max_queue = opt.max_queue});
+    router.register_handlers(kCommandRegistry, [&router, &expected](const CommandEnvelope& c) -> CommandResult {
+        if (is_authority_command(c.command)) return router.authority().execute(c);
+        const auto it = expected.find(c.command_id);
+        return it != expected.end() ? it->second : CommandResult{CommandStatus::Succeeded, RejectReason::None, ""};
+    });
+
+    size_t outcomes = 0;
+    size_t mismatches = 0;
+    const auto check = [&](uint64_t id, const CommandResult& got, const char* where) {
+        const auto it = expected.find(id);
+        if (it == expected.end()) return;
+        if (it->second.status == got.status && it->second.reject_reason == got.reject_reason) return;
+        ++mismatches;
+        if (opt.verbose) {
+            std::printf("mismatch %s id=%llu journal=%u/%u replay=%u/%u (%s)\n", where,
+                        static_cast<unsigned long long>(id), static_cast<unsigned>(it->second.status),
+                        static_cast<unsigned>(it->second.reject_reason), static_cast<unsigned>(got.status),
+                        static_cast<unsigned>(got.reject_reason), got.message.c_str());
+        }
+    };
+    const auto on_outcome = [&](const std::pair<CommandEnvelope, CommandResult>& r) {
+        ++outcomes;
+        check(r.first.command_id, r.second, "dispatch");
+    };
+
+    // Simulated control loop on the recorded clock.
+    const uint64_t first_ns = records.front().header.enqueue_ns;
+    const auto wall_start = Clock::now();
+    uint64_t tick = first_ns;
+    size_t next = 0;
+    while (next < records.size() || router.queued() > 0) {
+        for (; next < records.size() && records[next].header.enqueue_ns <= tick; ++next) {
+            CommandEnvelope env = records[next].envelope();
+            const char* error = "";
+            if (std::holds_alternative<std::monostate>(env.typed)) {
+                (void)decode_typed_payload(env.command, env.payload_json.view(), env.typed, error);
+            }
+            const uint64_t id = env.command_id;
+            const SubmitResult res = router.submit(std::move(env));
+            if (res.outcome == SubmitOutcome::Rejected) check(id, res.result, "submit");
+        }
+        if (opt.realtime) std::this_thread::sleep_until(wall_start + std::chrono::nanoseconds(tick - first_ns));
+        router.process_some(tick, 8, on_outcome);
+
+        // Skip idle stretches between bursts instead of ticking through them.
+        tick += opt.tick_ns;
+        if (router.queued() == 0 && next < records.size()) tick = std::max(tick, records[next].header.enqueue_ns);
+    }
+    router.process_some(tick, SIZE_MAX, on_outcome);
+
+    const double wall_s = std::chrono::duration<double>(Clock::now() - wall_start).count();
+    std::printf("records=%zu task_reports=%zu outcomes=%zu mismatches=%zu recorded_span=%.3fs wall=%.3fs (%.0f cmd/s)\n",
+                records.size(), task_reports, outcomes, mismatches,
+                static_cast<double>(records.back().header.enqueue_ns - first_ns) / 1e9, wall_s,
+                wall_s > 0.0 ? static_cast<double>(records.size()) / wall_s : 0.0);
+    std::printf("journal latency:\n");
+    print_span("queue", rec_queue);
+    print_span("execute", rec_execute);
+    return mismatches == 0 ? 0 : 1;
+}
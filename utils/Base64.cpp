@@ -9,42 +9,49 @@ static constexpr char kEncodeTable[] =
     "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 
 std::string base64_encode(const std::string& input) {
-    std::string out;
-    out.reserve(((input.size() + 2) / 3) * 4);
+    std::string out(base64_encoded_size(input.size()), '\0');
+    base64_encode_into(input, out.data());
+    return out;
+}
 
+size_t base64_encoded_size(size_t input_size) {
+    return ((input_size + 2) / 3) * 4;
+}
+
+size_t base64_encode_into(std::string_view input, char* out) {
+    char* p = out;
     size_t i = 0;
     while (i + 2 < input.size()) {
         const uint32_t chunk = (static_cast<uint32_t>(static_cast<unsigned char>(input[i])) << 16) |
                                (static_cast<uint32_t>(static_cast<unsigned char>(input[i + 1])) << 8) |
                                static_cast<uint32_t>(static_cast<unsigned char>(input[i + 2]));
-        out.push_back(kEncodeTable[(chunk >> 18) & 0x3F]);
-        out.push_back(kEncodeTable[(chunk >> 12) & 0x3F]);
-        out.push_back(kEncodeTable[(chunk >> 6) & 0x3F]);
-        out.push_back(kEncodeTable[chunk & 0x3F]);
+        *p++ = kEncodeTable[(chunk >> 18) & 0x3F];
+        *p++ = kEncodeTable[(chunk >> 12) & 0x3F];
+        *p++ = kEncodeTable[(chunk >> 6) & 0x3F];
+        *p++ = kEncodeTable[chunk & 0x3F];
         i += 3;
     }
 
     const size_t remaining = input.size() - i;
     if (remaining == 1) {
         const uint32_t chunk = static_cast<uint32_t>(static_cast<unsigned char>(input[i])) << 16;
-        out.push_back(kEncodeTable[(chunk >> 18) & 0x3F]);
-        out.push_back(kEncodeTable[(chunk >> 12) & 0x3F]);
-        out.push_back('=');
-        out.push_back('=');
+        *p++ = kEncodeTable[(chunk >> 18) & 0x3F];
+        *p++ = kEncodeTable[(chunk >> 12) & 0x3F];
+        *p++ = '=';
+        *p++ = '=';
     } else if (remaining == 2) {
         const uint32_t chunk = (static_cast<uint32_t>(static_cast<unsigned char>(input[i])) << 16) |
                                (static_cast<uint32_t>(static_cast<unsigned char>(input[i + 1])) << 8);
-        out.push_back(kEncodeTable[(chunk >> 18) & 0x3F]);
-        out.push_back(kEncodeTable[(chunk >> 12) & 0x3F]);
-        out.push_back(kEncodeTable[(chunk >> 6) & 0x3F]);
-        out.push_back('=');
+        *p++ = kEncodeTable[(chunk >> 18) & 0x3F];
+        *p++ = kEncodeTable[(chunk >> 12) & 0x3F];
+        *p++ = kEncodeTable[(chunk >> 6) & 0x3F];
+        *p++ = '=';
     }
-
-    return out;
+    return static_cast<size_t>(p - out);
 }
 
-std::string base64_decode(const std::string& input, bool& ok) {
-    static std::array<int, 256> table = [] {
+static const std::array<int, 256>& decode_table() {
+    static const std::array<int, 256> table = [] {
         std::array<int, 256> t{};
         t.fill(-1);
         for (int i = 0; i < 64; ++i) {
@@ -53,14 +60,19 @@ std::string base64_decode(const std::string& input, bool& ok) {
         t[static_cast<unsigned char>('=')] = 0;
         return t;
     }();
+    return table;
+}
 
-    ok = true;
-    std::string out;
-    out.reserve((input.size() / 4) * 3);
+size_t base64_decoded_size(std::string_view input) {
+    return (input.size() / 4) * 3;
+}
+
+bool base64_decode_into(std::string_view input, char* out, size_t cap, size_t& out_len) {
+    const auto& table = decode_table();
+    out_len = 0;
 
     if (input.size() % 4 != 0) {
-        ok = false;
-        return {};
+        return false;
     }
 
     for (size_t i = 0; i < input.size(); i += 4) {
@@ -69,8 +81,7 @@ std::string base64_decode(const std::string& input, bool& ok) {
             const unsigned char c = static_cast<unsigned char>(input[i + j]);
             int v = table[c];
             if (v < 0) {
-                ok = false;
-                return {};
+                return false;
             }
             vals[j] = v;
         }
@@ -79,15 +90,26 @@ std::string base64_decode(const std::string& input, bool& ok) {
                                (static_cast<uint32_t>(vals[1]) << 12) |
                                (static_cast<uint32_t>(vals[2]) << 6) |
                                static_cast<uint32_t>(vals[3]);
-        out.push_back(static_cast<char>((chunk >> 16) & 0xFF));
-        if (input[i + 2] != '=') {
-            out.push_back(static_cast<char>((chunk >> 8) & 0xFF));
-        }
-        if (input[i + 3] != '=') {
-            out.push_back(static_cast<char>(chunk & 0xFF));
+        const size_t n = 1 + (input[i + 2] != '=' ? 1 : 0) + (input[i + 3] != '=' ? 1 : 0);
+        if (out_len + n > cap) {
+            return false;
         }
+        out[out_len++] = static_cast<char>((chunk >> 16) & 0xFF);
+        if (n > 1) out[out_len++] = static_cast<char>((chunk >> 8) & 0xFF);
+        if (n > 2) out[out_len++] = static_cast<char>(chunk & 0xFF);
     }
 
+    return true;
+}
+
+std::string base64_decode(const std::string& input, bool& ok) {
+    std::string out(base64_decoded_size(input), '\0');
+    size_t n = 0;
+    ok = base64_decode_into(input, out.data(), out.size(), n);
+    if (!ok) {
+        return {};
+    }
+    out.resize(n);
     return out;
 }
 
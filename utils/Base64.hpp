@@ -1,10 +1,22 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
+#include <string_view>
 
 namespace arcraven::utils {
 
 std::string base64_encode(const std::string& input);
 std::string base64_decode(const std::string& input, bool& ok);
 
+// Allocation-free encoder: writes base64_encoded_size(input.size()) bytes to out and returns
+// that count.
+size_t base64_encoded_size(size_t input_size);
+size_t base64_encode_into(std::string_view input, char* out);
+
+// Allocation-free variant: decodes into out[0..cap). Returns false on malformed input or if the
+// decoded size exceeds cap. base64_decoded_size() gives an upper bound for sizing out.
+size_t base64_decoded_size(std::string_view input);
+bool base64_decode_into(std::string_view input, char* out, size_t cap, size_t& out_len);
+
 } // namespace arcraven::utils
@@ -0,0 +1,59 @@
+#include "utils/Crc32c.hpp"
+
+#include <array>
+#include <cstring>
+
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+namespace arcraven::utils {
+
+namespace {
+
+#if !defined(__SSE4_2__)
+using Table = std::array<std::array<uint32_t, 256>, 8>;
+
+constexpr Table make_table() {
+    Table t{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t c = i;
+        for (int b = 0; b < 8; ++b) c = (c & 1u) ? (c >> 1u) ^ 0x82F63B78u : c >> 1u;
+        t[0][i] = c;
+    }
+    for (uint32_t i = 0; i < 256; ++i) {
+        for (size_t k = 1; k < 8; ++k) t[k][i] = (t[k - 1][i] >> 8u) ^ t[0][t[k - 1][i] & 0xFFu];
+    }
+    return t;
+}
+
+constexpr Table kTable = make_table();
+#endif
+
+} // namespace
+
+uint32_t crc32c(const void* data, size_t len, uint32_t crc) {
+    const auto* p = static_cast<const uint8_t*>(data);
+    uint32_t c = ~crc;
+#if defined(__SSE4_2__)
+    uint64_t c64 = c;
+    for (; len >= 8; len -= 8, p += 8) {
+        uint64_t v = 0;
+        std::memcpy(&v, p, 8);
+        c64 = _mm_crc32_u64(c64, v);
+    }
+    c = static_cast<uint32_t>(c64);
+    for (; len > 0; --len, ++p) c = _mm_crc32_u8(c, *p);
+#else
+    for (; len >= 8; len -= 8, p += 8) {
+        const uint32_t lo = c ^ (static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8u |
+                                 static_cast<uint32_t>(p[2]) << 16u | static_cast<uint32_t>(p[3]) << 24u);
+        c = kTable[7][lo & 0xFFu] ^ kTable[6][(lo >> 8u) & 0xFFu] ^ kTable[5][(lo >> 16u) & 0xFFu] ^
+            kTable[4][lo >> 24u] ^ kTable[3][p[4]] ^ kTable[2][p[5]] ^ kTable[1][p[6]] ^ kTable[0][p[7]];
+    }
+    for (; len > 0; --len, ++p) c = (c >> 8u) ^ kTable[0][(c ^ *p) & 0xFFu];
+#endif
+    return ~c;
+}
+
+} // namespace arcraven::utils
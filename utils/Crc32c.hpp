@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace arcraven::utils {
+
+// CRC-32C (Castagnoli, reflected polynomial 0x82F63B78), as used by iSCSI/ext4 and the Rust
+// crc32c crates. Chainable: crc32c(b, nb, crc32c(a, na)) == crc32c(a ++ b). Uses the SSE4.2
+// crc32 instruction when the build targets it, a slicing-by-8 table otherwise.
+uint32_t crc32c(const void* data, size_t len, uint32_t crc = 0);
+
+} // namespace arcraven::utils